@@ -53,6 +53,14 @@ auto Body::SetPosition(const dvec3 x) -> void {
     position = x;
 }
 
+auto Body::SetMass(const double m) -> void {
+    mass = m;
+}
+
+auto Body::SetRadius(const double r) -> void {
+    radius = r;
+}
+
 auto Body::AddVelocity(const dvec3 v) -> void {
     velocity += v;
 }
@@ -33,6 +33,9 @@ public:
 
     auto SetPosition(const dvec3 x) -> void;
 
+    auto SetMass(const double m) -> void;
+    auto SetRadius(const double r) -> void;
+
     auto AddVelocity(dvec3 v) -> void;
     auto AddPosition(dvec3 x) -> void;
 
@@ -7,16 +7,15 @@
 
 
 Massive::Massive(const string &id, const string &name, const vec3 &color, const dvec3 &position, const dvec3 &velocity, const double mass, const double radius, const Material &material)
-    : Body(id, name, color, mass, radius, position, velocity), material(material) {
-        vertices = Sphere::Sphere(GetScaledRadius(), SPHERE_STEP);
-}
+    : Body(id, name, color, mass, radius, position, velocity), material(material) {}
 
 auto Massive::GetScaledRadius() const -> float {
     return float(radius / SCALE_FACTOR);
 }
 
-auto Massive::GetSphereVertices() const -> vector<VERTEX_DATA_TYPE> {
-    return vertices;
+auto Massive::GenerateSphereVertices() const -> vector<VERTEX_DATA_TYPE> {
+    // The mesh is not stored on the body, since bodies get copied around a lot and only the renderer needs it
+    return Sphere::Sphere(GetScaledRadius(), SPHERE_STEP);
 }
 
 auto Massive::GetMaterial() const -> Material {
@@ -17,6 +17,7 @@
 #include <simulation/OrbitPoint.h>
 
 #include <GLFW/glfw3.h>
+#include <algorithm>
 #include <string>
 
 
@@ -29,6 +30,14 @@ namespace Bodies {
         unordered_map<string, Massless> masslessBodies;
         vector<string> bodyIds;
 
+        // Each body that merged into another, mapped to the body it merged into
+        unordered_map<string, string> absorbed;
+
+        // While a bulk load is in progress, new massive bodies are queued here and the
+        // resets that normally follow AddBody are deferred until CommitBulkLoad
+        bool bulkLoading = false;
+        vector<Massive> pendingMassiveBodies;
+
         string selected;
 
         auto GetBodyAsReference(const string &id) -> Body& {
@@ -46,13 +55,33 @@ namespace Bodies {
         auto IsBodyMassive(const string &id) -> bool {
             return (massiveBodies.find(id) != massiveBodies.end());
         }
+
+        auto SetMassAndRadius(const string &id, const double mass, const double radius) -> void {
+            GetBodyAsReference(id).SetMass(mass);
+            GetBodyAsReference(id).SetRadius(radius);
+            if (IsBodyMassive(id)) {
+                GetMassiveAsReference(id).SetMass(mass);
+                GetMassiveAsReference(id).SetRadius(radius);
+            } else {
+                GetMasslessAsReference(id).SetMass(mass);
+                GetMasslessAsReference(id).SetRadius(radius);
+            }
+        }
+
+        auto NewBodyReset() -> void {
+            Simulation::NewBodyReset();
+            OrbitPaths::NewBodyReset();
+            SimulationData::NewBodyReset();
+        }
     }
 
     auto PreReset() -> void {
         // Delete bodies
         massiveBodies.clear();
+        masslessBodies.clear();
         bodies.clear();
         bodyIds.clear();
+        absorbed.clear();
 
         // Unselect bodies
         selected = "";
@@ -64,23 +93,54 @@ namespace Bodies {
         }
     }
 
+    auto BeginBulkLoad() -> void {
+        // Every reset triggered by AddBody is O(n), so adding n bodies one by one is O(n^2)
+        // Between BeginBulkLoad and CommitBulkLoad, bodies are only inserted, and everything else happens once at commit
+        bulkLoading = true;
+        pendingMassiveBodies.clear();
+    }
+
+    auto CommitBulkLoad() -> void {
+        ZoneScoped;
+        bulkLoading = false;
+        MassiveRender::AddBodies(pendingMassiveBodies);
+        pendingMassiveBodies.clear();
+        NewBodyReset();
+    }
+
+    auto CommitBulkLoad(const vector<vector<VERTEX_DATA_TYPE>> &meshes) -> void {
+        // Same as CommitBulkLoad, but with sphere meshes that were already generated (in the order the massive bodies were added)
+        ZoneScoped;
+        bulkLoading = false;
+        MassiveRender::AddBodies(pendingMassiveBodies, meshes);
+        pendingMassiveBodies.clear();
+        NewBodyReset();
+    }
+
     auto AddBody(const Massive &body) -> void {
         bodyIds.push_back(body.GetId());
         bodies.insert(std::make_pair(body.GetId(), body));
         massiveBodies.insert(std::make_pair(body.GetId(), body));
+        if (bulkLoading) {
+            pendingMassiveBodies.push_back(body);
+            return;
+        }
         MassiveRender::AddBody(body);
-        Simulation::NewBodyReset();
-        OrbitPaths::NewBodyReset();
-        SimulationData::NewBodyReset();
+        NewBodyReset();
     }
 
     auto AddBody(const Massless &body) -> void {
         bodyIds.push_back(body.GetId());
         bodies.insert(std::make_pair(body.GetId(), body));
         masslessBodies.insert(std::make_pair(body.GetId(), body));
-        Simulation::NewBodyReset();
-        OrbitPaths::NewBodyReset();
-        SimulationData::NewBodyReset();
+        if (bulkLoading) {
+            return;
+        }
+        NewBodyReset();
+    }
+
+    auto ResetPrediction() -> void {
+        NewBodyReset();
     }
 
     auto UpdateBody(const string &id, const OrbitPoint &point) -> void {
@@ -95,6 +155,38 @@ namespace Bodies {
         }
     }
 
+    auto MergeBody(const string &absorbedId, const string &survivorId, const double mass, const double radius) -> void {
+        // Only the meshes of the two bodies change, so nothing needs to be reset
+        ZoneScoped;
+        if (absorbed.find(absorbedId) == absorbed.end()) {
+            SetMassAndRadius(absorbedId, 0, 0);
+            if (IsBodyMassive(absorbedId)) {
+                MassiveRender::RemoveBody(absorbedId);
+            }
+        }
+        absorbed[absorbedId] = survivorId;
+
+        // The sphere mesh is built at the body's radius, so it has to be generated again
+        const bool resized = GetBody(survivorId).GetRadius() != radius;
+        SetMassAndRadius(survivorId, mass, radius);
+        if (resized && IsBodyMassive(survivorId)) {
+            MassiveRender::RemoveBody(survivorId);
+            MassiveRender::AddBody(GetMassiveBody(survivorId));
+        }
+
+        if (selected == absorbedId) {
+            selected = survivorId;
+        }
+    }
+
+    auto IsAbsorbed(const string &id) -> bool {
+        return absorbed.find(id) != absorbed.end();
+    }
+
+    auto GetAbsorbed() -> const unordered_map<string, string>& {
+        return absorbed;
+    }
+
     auto GetSelectedBodyId() -> string {
         return selected;
     }
@@ -146,4 +238,22 @@ namespace Bodies {
     auto GetBodyCount() -> unsigned int {
         return bodies.size();
     }
+
+    auto FindStrongestPull(const string &id, const vector<string> &excludedIds) -> string {
+        const Body &body = bodies.at(id);
+        string strongest;
+        double strongestPull = 0;
+        for (const auto &pair : massiveBodies) {
+            if ((pair.first == id) || (std::find(excludedIds.begin(), excludedIds.end(), pair.first) != excludedIds.end())) {
+                continue;
+            }
+            const dvec3 displacement = pair.second.GetPosition() - body.GetPosition();
+            const double pull = pair.second.GetMass() / glm::dot(displacement, displacement);
+            if (pull > strongestPull) {
+                strongestPull = pull;
+                strongest = pair.first;
+            }
+        }
+        return strongest;
+    }
 }
\ No newline at end of file
@@ -12,11 +12,24 @@ namespace Bodies {
     auto PreReset() -> void;
     auto PostReset() -> void;
 
+    auto BeginBulkLoad() -> void;
+    auto CommitBulkLoad() -> void;
+    auto CommitBulkLoad(const vector<vector<VERTEX_DATA_TYPE>> &meshes) -> void;
+
     auto AddBody(const Massive &body) -> void;
     auto AddBody(const Massless &body) -> void;
 
     auto UpdateBody(const string &id, const OrbitPoint &point) -> void;
 
+    // Called once the simulation reaches a collision; the survivor takes the merged mass and radius, while the
+    // absorbed body is kept with no mass, following the survivor without being drawn or listed
+    auto MergeBody(const string &absorbedId, const string &survivorId, const double mass, const double radius) -> void;
+    auto IsAbsorbed(const string &id) -> bool;
+    auto GetAbsorbed() -> const unordered_map<string, string>&;
+
+    // Recomputes everything that follows from the bodies' current states, the same as when a body is added
+    auto ResetPrediction() -> void;
+
     auto SetSelectedBody(const string &id) -> void;
     auto GetSelectedBody() -> const Body&;
     auto GetSelectedBodyId() -> string;
@@ -35,4 +48,8 @@ namespace Bodies {
     auto GetBody(const string &id) -> const Body&;
 
     auto GetBodyCount() -> unsigned int;
+
+    // The massive body exerting the strongest pull on the given body, other than itself and any excluded bodies;
+    // empty if there is none
+    auto FindStrongestPull(const string &id, const vector<string> &excludedIds) -> string;
 }
\ No newline at end of file
@@ -1,6 +1,10 @@
 #include "Control.h"
 #include "rendering/interface/BottomRightWindow/LoadScenario.h"
 #include "scenarios/Scenarios.h"
+#include "scenarios/ScenarioIndex.h"
+#include "scenarios/Checkpoints.h"
+#include "scenarios/ScenarioSaver.h"
+#include "scenarios/ScenarioLoader.h"
 #include "rendering/camera/CameraTransition.h"
 #include "rendering/interface/TopRightWindow/SimulationData.h"
 
@@ -13,6 +17,8 @@
 #include <rendering/world/Icons.h>
 #include <rendering/world/MassiveRender.h>
 #include <rendering/world/OrbitPaths.h>
+#include <rendering/world/EnsembleRender.h>
+#include <rendering/world/ManeuverRender.h>
 
 #include <rendering/geometry/Rays.h>
 
@@ -21,6 +27,13 @@
 #include <window/Window.h>
 #include <main/Bodies.h>
 #include <simulation/Simulation.h>
+#include <simulation/Recorder.h>
+#include <simulation/Replay.h>
+#include <simulation/Conjunctions.h>
+#include <simulation/Ensemble.h>
+#include <simulation/Porkchop.h>
+#include <simulation/Rails.h>
+#include <simulation/Regularization.h>
 
 #include <string>
 
@@ -99,6 +112,13 @@ namespace Control {
 
     auto PreReset() -> void {
         // To be called before a new scenario is loaded
+        Recorder::Stop();
+        Replay::Close();
+        Ensemble::PreReset();
+        Conjunctions::PreReset();
+        Porkchop::PreReset();
+        Rails::PreReset();
+        Regularization::PreReset();
         CameraTransition::PreReset();
         Bodies::PreReset();
         MassiveRender::PreReset();
@@ -125,9 +145,26 @@ namespace Control {
         Icons::Init();
         MassiveRender::Init();
         OrbitPaths::Init();
+        EnsembleRender::Init();
+        ManeuverRender::Init();
         Interface::Init();
         Camera::Init();
         Simulation::Init();
+        ScenarioIndex::Init();
+    }
+
+    auto Shutdown() -> void {
+        // Stop background threads so the process can exit cleanly
+        ScenarioIndex::Shutdown();
+        Checkpoints::Shutdown();
+        ScenarioSaver::Shutdown();
+        ScenarioLoader::Shutdown();
+        Recorder::Stop();
+        Replay::Close();
+        Ensemble::Cancel();
+        Conjunctions::Cancel();
+        Porkchop::Cancel();
+        Simulation::Shutdown();
     }
 
     auto PromptScenarioLoad() -> void {
@@ -138,8 +175,13 @@ namespace Control {
             ImGui_ImplGlfw_NewFrame();
             ImGui::NewFrame();
 
-            ImGui::OpenPopup("Load Scenario");
-            LoadScenario::Draw(false);
+            // The prompt is replaced by a progress bar until the chosen scenario has finished loading
+            if (ScenarioLoader::IsLoading()) {
+                LoadScenario::DrawProgress();
+            } else {
+                ImGui::OpenPopup("Load Scenario");
+                LoadScenario::Draw(false);
+            }
 
             ImGui::Render();
             ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
@@ -148,6 +190,8 @@ namespace Control {
             Keys::Update();
             glfwPollEvents();
             Window::Update();
+
+            Scenarios::FrameUpdate();
         }
     }
 
@@ -160,12 +204,14 @@ namespace Control {
             
             Simulation::FrameUpdate();
             Scenarios::FrameUpdate();
+            Rails::FrameUpdate();
+            Regularization::FrameUpdate();
             std::thread simulationUpdateThread(Simulation::Update, deltaTime);
 
             Window::Background(WINDOW_BACKGROUND);
             Camera::AddZoomDelta(Mouse::GetScrollDelta().y);
 
-            if (Mouse::LeftButtonHeld()) {
+            if (Mouse::LeftButtonHeld() && !ManeuverRender::IsDragging()) {
                 Camera::AddAngleDelta(Mouse::GetPositionDelta());
             }
             
@@ -174,6 +220,8 @@ namespace Control {
             Icons::Update();
             MassiveRender::Update();
             OrbitPaths::Update();
+            EnsembleRender::Update();
+            ManeuverRender::Update();
             Interface::Update(deltaTime);
 
             // Wait until frame complete
@@ -182,6 +230,9 @@ namespace Control {
             Simulation::TerminateUpdate();
             simulationUpdateThread.join();
 
+            // Forking while the update thread is running would snapshot a half-updated state
+            Checkpoints::FrameUpdate();
+
             Mouse::Update();
             Keys::Update();
             glfwPollEvents();
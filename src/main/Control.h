@@ -13,4 +13,5 @@ namespace Control {
     auto PostReset() -> void;
     auto PromptScenarioLoad() -> void;
     auto Mainloop() -> void;
+    auto Shutdown() -> void;
 }
@@ -1,9 +1,16 @@
 #include <main/Control.h>
+#include <sweep/Sweep.h>
 
 
 
-auto main() -> int {
+auto main(int argc, char* argv[]) -> int {
+    // A parameter sweep runs headless, so it returns before any window or GL context is created
+    if ((argc == 3) && (string(argv[1]) == "--sweep")) { // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        return Sweep::Run(argv[2]); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+
     Control::Init(false, "OSTRICH");
     Control::PromptScenarioLoad();
     Control::Mainloop();
-}
\ No newline at end of file
+    Control::Shutdown();
+}
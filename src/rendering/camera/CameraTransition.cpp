@@ -67,6 +67,8 @@ namespace CameraTransition {
 
     auto Update(const double deltaTime) -> void {
         ZoneScoped;
+        // Must run after Simulation::FrameUpdate, which interpolates body positions to the current time,
+        // so the camera follows the body smoothly instead of jumping with each integration step
         transition.UpdateTarget(Bodies::GetSelectedBody().GetScaledPosition());
 
         // Step transition
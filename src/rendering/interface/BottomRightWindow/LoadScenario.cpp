@@ -3,6 +3,9 @@
 #include <rendering/interface/BottomRightWindow/ScenarioTable.h>
 #include <rendering/interface/Fonts.h>
 #include <scenarios/Scenarios.h>
+#include <scenarios/Checkpoints.h>
+#include <scenarios/ScenarioLoader.h>
+#include <util/TimeFormat.h>
 #include <util/Types.h>
 
 #include <depend/IconsMaterialDesignIcons_c.h>
@@ -18,6 +21,7 @@ namespace LoadScenario {
         const string NO_SCENARIO_SELECTED_TEXT = ICON_MDI_CANCEL + string(" No scenario selected");
         const string LOAD_TEXT = ICON_MDI_CHECK_CIRCLE_OUTLINE + string(" Load");
         const string CANCEL_TEXT = ICON_MDI_CLOSE_CIRCLE_OUTLINE + string(" Cancel");
+        const string RESUME_TEXT = ICON_MDI_HISTORY + string(" Resume last session");
 
         const ImVec2 CANCEL_BUTTON_SIZE = ImVec2(90, 0);
         const ImVec2 LOAD_BUTTON_SIZE = ImVec2(90, 0);
@@ -30,7 +34,10 @@ namespace LoadScenario {
 
         const ImGuiPopupFlags POPUP_FLAGS = ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoTitleBar;
 
-        bool scenarioLoaded = false;
+        const string LOADING_TEXT = ICON_MDI_TIMER_SAND + string(" Loading scenario");
+        const ImVec2 PROGRESS_WINDOW_SIZE = ImVec2(300, 70);
+        const ImVec2 PROGRESS_WINDOW_POSITION = ImVec2(810, 500);
+        const ImGuiWindowFlags PROGRESS_WINDOW_FLAGS = ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove;
 
         auto AddTitle() -> void {
             ImGui::PushFont(Fonts::MainBig());
@@ -54,8 +61,16 @@ namespace LoadScenario {
 
         auto AddLoadScenarioButton() -> void {
             if (ImGui::Button(LOAD_TEXT.c_str(), LOAD_BUTTON_SIZE)) {
-                Scenarios::ScheduleLoadScenario(ScenarioTable::GetSelectedFile());
-                scenarioLoaded = true;
+                Scenarios::ScheduleLoadScenario(ScenarioTable::GetSelectedFile(), ScenarioTable::GetSelectedFormat());
+                ImGui::CloseCurrentPopup();
+            }
+        }
+
+        auto AddResumeButton() -> void {
+            // Only offered on startup, since that is when we may be recovering from a crash
+            const string text = RESUME_TEXT + " (" + TimeFormat::FormatTime(int(Checkpoints::GetCheckpointTime())) + ")";
+            if (ImGui::Button(text.c_str())) {
+                Scenarios::ScheduleLoadScenarioFromPath(Checkpoints::GetCheckpointPath(), SCENARIO_FORMAT_BINARY);
                 ImGui::CloseCurrentPopup();
             }
         }
@@ -72,6 +87,11 @@ namespace LoadScenario {
             } else {
                 AddLoadScenarioButton();
             }
+
+            if ((!allowCancel) && Checkpoints::CheckpointExists()) {
+                ImGui::SameLine();
+                AddResumeButton();
+            }
         }
     }
 
@@ -90,7 +110,26 @@ namespace LoadScenario {
         ImGui::PopStyleColor();
     }
 
+    auto DrawProgress() -> void {
+        if (!ScenarioLoader::IsLoading()) {
+            return;
+        }
+
+        ImGui::PushStyleColor(ImGuiCol_WindowBg, MODAL_BACKGROUND);
+        ImGui::Begin("Loading Scenario", nullptr, PROGRESS_WINDOW_FLAGS);
+        ImGui::SetWindowSize(PROGRESS_WINDOW_SIZE);
+        ImGui::SetWindowPos(PROGRESS_WINDOW_POSITION);
+
+        ImGui::PushFont(Fonts::Main());
+        ImGui::Text("%s", LOADING_TEXT.c_str());
+        ImGui::PopFont();
+        ImGui::ProgressBar(ScenarioLoader::GetProgress());
+
+        ImGui::End();
+        ImGui::PopStyleColor();
+    }
+
     auto ScenarioLoaded() -> bool {
-        return scenarioLoaded;
+        return ScenarioLoader::HasLoadedScenario();
     }
 }
\ No newline at end of file
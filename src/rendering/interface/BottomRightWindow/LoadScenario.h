@@ -4,5 +4,6 @@
 
 namespace LoadScenario {
     auto Draw(const bool allowCancel) -> void;
+    auto DrawProgress() -> void;
     auto ScenarioLoaded() -> bool;
 }
\ No newline at end of file
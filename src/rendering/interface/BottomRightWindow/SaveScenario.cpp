@@ -1,5 +1,6 @@
 #include "SaveScenario.h"
 #include "scenarios/ScenarioFileUtil.h"
+#include "scenarios/ScenarioIndex.h"
 
 #include <rendering/interface/Fonts.h>
 #include <rendering/interface/BottomRightWindow/ScenarioTable.h>
@@ -21,6 +22,8 @@ namespace SaveScenario {
         const string SAVE_TEXT = ICON_MDI_CHECK_CIRCLE_OUTLINE + string(" Save");
         const string CANCEL_TEXT = ICON_MDI_CLOSE_CIRCLE_OUTLINE + string(" Cancel");
         const string OVERWRITE_TEXT = ICON_MDI_ALERT_CIRCLE_OUTLINE + string(" Overwrite");
+        const string YML_FORMAT_TEXT = "YAML (.yml)";
+        const string BINARY_FORMAT_TEXT = "Binary (.osc)";
 
         const int TEXT_BUFFER_SIZE = 2048;
 
@@ -38,6 +41,7 @@ namespace SaveScenario {
         const ImGuiPopupFlags POPUP_FLAGS = ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoTitleBar;
 
         char filename[TEXT_BUFFER_SIZE]; //NOLINT(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+        int format = SCENARIO_FORMAT_YML;
 
         auto AddTitle() -> void {
             ImGui::PushFont(Fonts::MainBig());
@@ -49,6 +53,12 @@ namespace SaveScenario {
             ImGui::InputTextWithHint("##", "enter filename here", (char*)filename, TEXT_BUFFER_SIZE * sizeof(char));
         }
 
+        auto AddFormatSelection() -> void {
+            ImGui::RadioButton(YML_FORMAT_TEXT.c_str(), &format, SCENARIO_FORMAT_YML);
+            ImGui::SameLine();
+            ImGui::RadioButton(BINARY_FORMAT_TEXT.c_str(), &format, SCENARIO_FORMAT_BINARY);
+        }
+
         auto AddCancelButton() -> void {
             if (ImGui::Button(CANCEL_TEXT.c_str(), CANCEL_BUTTON_SIZE)) {
                 ImGui::CloseCurrentPopup(); 
@@ -66,7 +76,7 @@ namespace SaveScenario {
         auto AddOverwriteButton() -> void {
             ImGui::PushStyleColor(ImGuiCol_Text,OVERWRITE_BUTTON_COLOR);
             if (ImGui::Button(OVERWRITE_TEXT.c_str(), OVERWRITE_BUTTON_SIZE)) {
-                Scenarios::SaveScenario((char*)filename);
+                Scenarios::SaveScenario((char*)filename, ScenarioFormat(format));
                 ImGui::CloseCurrentPopup(); 
             }
             ImGui::PopStyleColor();
@@ -74,7 +84,7 @@ namespace SaveScenario {
 
         auto AddSaveButton() -> void {
             if (ImGui::Button(SAVE_TEXT.c_str(), SAVE_BUTTON_SIZE)) {
-                Scenarios::SaveScenario((char*)filename);
+                Scenarios::SaveScenario((char*)filename, ScenarioFormat(format));
                 ImGui::CloseCurrentPopup(); 
             }
         }
@@ -85,7 +95,7 @@ namespace SaveScenario {
             if (filename[0] == '\0') {
                 AddNofilenameButton();
             } else {
-                if (ScenarioFileUtil::ScenarioExists((char*)filename)) {
+                if (ScenarioIndex::ScenarioExists((char*)filename, ScenarioFormat(format))) {
                     AddOverwriteButton();
                 } else {
                     AddSaveButton();
@@ -102,6 +112,7 @@ namespace SaveScenario {
             AddTitle();
             ScenarioTable::AddFileTable(false);
             AddFilenameEntry();
+            AddFormatSelection();
             AddButtons();
             ImGui::EndPopup();
         }
@@ -2,6 +2,7 @@
 
 #include <rendering/interface/Fonts.h>
 #include <scenarios/ScenarioFileUtil.h>
+#include <scenarios/ScenarioIndex.h>
 
 #include <algorithm>
 #include <imgui.h>
@@ -10,15 +11,18 @@
 
 namespace ScenarioTable {
     namespace {
-        const int NAME_WIDTH = 280;
+        const int NAME_WIDTH = 240;
+        const int FORMAT_WEIGHT = 40;
         const int BODIES_WEIGHT = 45;
         const int TIME_WEIGHT = 100;
 
         const unsigned int NAME_COLUMN_ID = 0;
-        const unsigned int BODIES_COLUMN_ID = 1;
-        const unsigned int TIME_COLUMN_ID = 2;
+        const unsigned int FORMAT_COLUMN_ID = 1;
+        const unsigned int BODIES_COLUMN_ID = 2;
+        const unsigned int TIME_COLUMN_ID = 3;
 
         const string NAME_TEXT = ICON_MDI_FORMAT_TEXT + string(" Name");
+        const string FORMAT_TEXT = ICON_MDI_FILE + string(" Format");
         const string BODIES_TEXT = ICON_MDI_EARTH + string(" Bodies");
         const string TIME_TEXT = ICON_MDI_CLOCK + string(" Time");
 
@@ -27,6 +31,7 @@ namespace ScenarioTable {
         ImGuiTableSortSpecs* sortSpecs;
 
         string selectedFile;
+        ScenarioFormat selectedFormat = SCENARIO_FORMAT_YML;
 
         auto AddHeader() -> void {
             // Use main font
@@ -38,6 +43,9 @@ namespace ScenarioTable {
             // Add name header
             ImGui::TableSetupColumn(NAME_TEXT.c_str(), ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_DefaultSort, NAME_WIDTH, NAME_COLUMN_ID);
 
+            // Add format header
+            ImGui::TableSetupColumn(FORMAT_TEXT.c_str(), ImGuiTableColumnFlags_WidthStretch, FORMAT_WEIGHT, FORMAT_COLUMN_ID);
+
             // Add mass header
             ImGui::TableSetupColumn(BODIES_TEXT.c_str(), ImGuiTableColumnFlags_WidthStretch | ImGuiTableColumnFlags_PreferSortDescending, BODIES_WEIGHT, BODIES_COLUMN_ID);
 
@@ -62,6 +70,14 @@ namespace ScenarioTable {
             return !comparison;
         }
 
+        auto CompareScenarioFileFormats(const ScenarioFile &scenario1, const ScenarioFile &scenario2) -> bool {
+            bool comparison = scenario1.format > scenario2.format;
+            if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Descending) {
+                return comparison;
+            }
+            return !comparison;
+        }
+
         auto CompareScenarioFileBodies(const ScenarioFile &scenario1, const ScenarioFile &scenario2) -> bool {
             bool comparison = scenario1.bodyCount > scenario2.bodyCount;
             if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Descending) {
@@ -81,13 +97,15 @@ namespace ScenarioTable {
         auto CompareScenarioFiles(const ScenarioFile &scenario1, const ScenarioFile &scenario2) -> bool {
             if (sortSpecs->Specs->ColumnIndex == NAME_COLUMN_ID) {
                 return CompareScenarioFileNames(scenario1, scenario2);
+            } else if (sortSpecs->Specs->ColumnIndex == FORMAT_COLUMN_ID) { // NOLINT(readability-else-after-return)
+                return CompareScenarioFileFormats(scenario1, scenario2);
             } else if (sortSpecs->Specs->ColumnIndex == BODIES_COLUMN_ID) { // NOLINT(readability-else-after-return)
                 return CompareScenarioFileBodies(scenario1, scenario2);
             }
             return CompareScenarioFileTimes(scenario1, scenario2);
         }
 
-        auto AddNameText(const string &text, const bool selectable) -> void {
+        auto AddNameText(const string &text, const ScenarioFormat format, const bool selectable) -> void {
 
             ImGui::TableNextColumn();
             if (!selectable) {
@@ -95,9 +113,18 @@ namespace ScenarioTable {
                 return;
             }
             
-            if (ImGui::Selectable(Fonts::NormalizeString(Fonts::MainBig(), text, NAME_WIDTH).c_str(), selectedFile == text, ImGuiSelectableFlags_SpanAllColumns)) {
+            // The same name can exist once per format, so the format is part of the selectable's id
+            ImGui::PushID(format);
+            if (ImGui::Selectable(Fonts::NormalizeString(Fonts::MainBig(), text, NAME_WIDTH).c_str(), (selectedFile == text) && (selectedFormat == format), ImGuiSelectableFlags_SpanAllColumns)) {
                 selectedFile = text;
+                selectedFormat = format;
             }
+            ImGui::PopID();
+        }
+
+        auto AddFormatText(const ScenarioFormat format) -> void {
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", ScenarioFileUtil::GetFormatName(format).c_str());
         }
 
         auto AddBodiesText(const int bodies) -> void {
@@ -112,16 +139,18 @@ namespace ScenarioTable {
     }
     
     auto AddFileTable(const bool selectable) -> void {
-        if (ImGui::BeginTable("file-table", 3, TABLE_FLAGS, TABLE_SIZE)) {
+        if (ImGui::BeginTable("file-table", 4, TABLE_FLAGS, TABLE_SIZE)) {
             AddHeader();
 
             sortSpecs = ImGui::TableGetSortSpecs();
-            vector<ScenarioFile> scenarios = ScenarioFileUtil::GetScenarios();
+            // Scenario metadata comes from the index, which is kept up to date in the background
+            vector<ScenarioFile> scenarios = ScenarioIndex::GetScenarios();
             std::sort(scenarios.begin(), scenarios.end(), CompareScenarioFiles);
 
             ImGui::PushFont(Fonts::Data());
             for (const ScenarioFile &scenario : scenarios) {
-                AddNameText(scenario.nameWithoutExtension, selectable);
+                AddNameText(scenario.nameWithoutExtension, scenario.format, selectable);
+                AddFormatText(scenario.format);
                 AddBodiesText(scenario.bodyCount);
                 AddTimeText(scenario.formattedTime);
             }
@@ -134,4 +163,8 @@ namespace ScenarioTable {
     auto GetSelectedFile() -> string {
         return selectedFile;
     }
+
+    auto GetSelectedFormat() -> ScenarioFormat {
+        return selectedFormat;
+    }
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <scenarios/ScenarioFileUtil.h>
 #include <util/Types.h>
 
 #include <imgui.h>
@@ -11,4 +12,5 @@ namespace ScenarioTable {
 
     auto AddFileTable(const bool selectable) -> void;
     auto GetSelectedFile() -> string;
+    auto GetSelectedFormat() -> ScenarioFormat;
 }
\ No newline at end of file
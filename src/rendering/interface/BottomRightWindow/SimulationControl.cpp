@@ -6,6 +6,7 @@
 #include <rendering/interface/BottomRightWindow/LoadScenario.h>
 #include <rendering/interface/Fonts.h>
 #include <simulation/Simulation.h>
+#include <scenarios/ScenarioSaver.h>
 #include <depend/IconsMaterialDesignIcons_c.h>
 
 #include <imgui.h>
@@ -17,18 +18,60 @@ namespace SimulationControl {
         const string SAVE_TEXT = ICON_MDI_FOLDER_UPLOAD + string(" Save");
         const string LOAD_TEXT = ICON_MDI_FOLDER_DOWNLOAD + string(" Load");
         const string SETTINGS_TEXT = ICON_MDI_COG + string(" Settings");
+        const string SAVING_TEXT = ICON_MDI_TIMER_SAND + string(" Saving");
+        const string SAVED_TEXT = ICON_MDI_CHECK + string(" Saved");
+        const string SAVE_FAILED_TEXT = ICON_MDI_ALERT + string(" Failed");
+
+        const ImVec4 SAVED_COLOR = ImVec4(0.3, 1.0, 0.3, 1.0);
+        const ImVec4 SAVE_FAILED_COLOR = ImVec4(1.0, 0.3, 0.3, 1.0);
+
+        // How long the save button shows that the last save completed before going back to normal
+        const double SAVED_DISPLAY_TIME = 3.0;
 
         const string SPEED_INDICATOR_ICON = ICON_MDI_CHEVRON_RIGHT_CIRCLE;
 
         const string SPEED_TEXT = ICON_MDI_PLAY_SPEED + string(" Speed ");
         const string TIME_TEXT = ICON_MDI_CLOCK + string(" Time   ");
         
-        auto AddGeneralButtons() -> void {
-            ImGui::PushFont(Fonts::Main());
+        SaveStatus previousSaveStatus = SAVE_STATUS_IDLE;
+        double saveCompletedTime = 0;
+
+        auto AddSaveButton() -> void {
+            // Saving happens in the background, so the button doubles as the save status indicator
+            const SaveStatus status = ScenarioSaver::GetStatus();
+            if ((status == SAVE_STATUS_SAVED) && (previousSaveStatus != SAVE_STATUS_SAVED)) {
+                saveCompletedTime = ImGui::GetTime();
+            }
+            previousSaveStatus = status;
+
+            string text = SAVE_TEXT;
+            ImVec4 color = ImGui::GetStyleColorVec4(ImGuiCol_Text);
+            if (status == SAVE_STATUS_SAVING) {
+                text = SAVING_TEXT;
+            } else if ((status == SAVE_STATUS_SAVED) && (ImGui::GetTime() - saveCompletedTime < SAVED_DISPLAY_TIME)) {
+                text = SAVED_TEXT;
+                color = SAVED_COLOR;
+            } else if (status == SAVE_STATUS_FAILED) {
+                text = SAVE_FAILED_TEXT;
+                color = SAVE_FAILED_COLOR;
+            }
 
-            if (ImGui::Button(SAVE_TEXT.c_str())) {
+            ImGui::PushStyleColor(ImGuiCol_Text, color);
+            if (ImGui::Button(text.c_str())) {
                 ImGui::OpenPopup("Save Scenario");
             }
+            ImGui::PopStyleColor();
+
+            if ((status != SAVE_STATUS_IDLE) && ImGui::IsItemHovered()) {
+                const string verb = (status == SAVE_STATUS_FAILED) ? "Failed to save " : (status == SAVE_STATUS_SAVING) ? "Saving " : "Saved ";
+                ImGui::SetTooltip("%s", (verb + ScenarioSaver::GetStatusPath()).c_str());
+            }
+        }
+
+        auto AddGeneralButtons() -> void {
+            ImGui::PushFont(Fonts::Main());
+
+            AddSaveButton();
 
             ImGui::SameLine();
 
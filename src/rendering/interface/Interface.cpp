@@ -5,6 +5,8 @@
 #include <rendering/interface/BottomRightWindow/BottomRightWindow.h>
 #include <rendering/interface/TopRightWindow/TopRightWindow.h>
 #include <rendering/interface/LeftWindow/LeftWindow.h>
+#include <rendering/interface/ToolsWindow/ToolsWindow.h>
+#include <rendering/interface/BottomRightWindow/LoadScenario.h>
 
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
@@ -29,6 +31,8 @@ namespace Interface {
         TopRightWindow::Draw(deltaTime);
         BottomRightWindow::Draw();
         LeftWindow::Draw();
+        ToolsWindow::Draw();
+        LoadScenario::DrawProgress();
 
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
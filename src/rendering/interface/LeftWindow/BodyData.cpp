@@ -2,11 +2,17 @@
 
 #include "simulation/Simulation.h"
 #include "simulation/SimulationEnergy.h"
+#include "simulation/OsculatingElements.h"
 #include <main/Bodies.h>
 #include <rendering/interface/Fonts.h>
+#include <util/TimeFormat.h>
 
 #include <imgui.h>
 
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
 
 
 namespace BodyData {
@@ -20,6 +26,16 @@ namespace BodyData {
         const string KINETIC_ENERGY_TEXT = ICON_MDI_CUBE_SEND + string(" Kinetic Energy");
         const string POTENTIAL_ENERGY_TEXT = ICON_MDI_ATOM + string(" Potential Energy");
         const string TOTAL_ENERGY_TEXT = ICON_MDI_LIGHTNING_BOLT + string(" Total Energy");
+        const string PRIMARY_TEXT = ICON_MDI_EARTH + string(" Primary");
+        const string SEMI_MAJOR_AXIS_TEXT = ICON_MDI_ARROW_EXPAND_HORIZONTAL + string(" Semi-major Axis");
+        const string ECCENTRICITY_TEXT = ICON_MDI_ELLIPSE_OUTLINE + string(" Eccentricity");
+        const string INCLINATION_TEXT = ICON_MDI_ANGLE_ACUTE + string(" Inclination");
+        const string ASCENDING_NODE_TEXT = ICON_MDI_ROTATE_3D_VARIANT + string(" Ascending Node");
+        const string ARGUMENT_OF_PERIAPSIS_TEXT = ICON_MDI_ANGLE_RIGHT + string(" Arg. of Periapsis");
+        const string TRUE_ANOMALY_TEXT = ICON_MDI_MAP_MARKER_PATH + string(" True Anomaly");
+        const string PERIOD_TEXT = ICON_MDI_TIMER_OUTLINE + string(" Period");
+
+        const double DEGREES_PER_RADIAN = 180.0 / M_PI;
 
         const int KEY_COLUMN_WIDTH = 170;
         const int VALUE_COLUMN_WIDTH =  130;
@@ -131,6 +147,67 @@ namespace BodyData {
             ImGui::Text("%.2e %s", SimulationEnergy::GetKineticEnergy(body) + SimulationEnergy::GetPotentialEnergy(body), "J");
             ImGui::PopFont();
         }
+
+        auto AddElementKey(const string &text) -> void {
+            ImGui::PushFont(Fonts::Main());
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", text.c_str());
+            ImGui::PopFont();
+            ImGui::TableNextColumn();
+        }
+
+        auto AddOrbitalElements(const Body &body) -> void {
+            ZoneScoped;
+            // Elements are calculated for every body at once on the simulation thread, so they are only looked up here
+            BodyElements elements {};
+            if (!OsculatingElements::Get(body.GetId(), elements)) {
+                return;
+            }
+
+            AddElementKey(PRIMARY_TEXT);
+            ImGui::PushFont(Fonts::Data());
+            ImGui::Text("%s", Bodies::GetBody(elements.primaryId).GetName().c_str());
+            ImGui::PopFont();
+
+            AddElementKey(SEMI_MAJOR_AXIS_TEXT);
+            ImGui::PushFont(Fonts::Data());
+            ImGui::Text("%.2e %s", elements.elements.semiMajorAxis, "m");
+            ImGui::PopFont();
+
+            AddElementKey(ECCENTRICITY_TEXT);
+            ImGui::PushFont(Fonts::Data());
+            ImGui::Text("%.4f", elements.elements.eccentricity);
+            ImGui::PopFont();
+
+            AddElementKey(INCLINATION_TEXT);
+            ImGui::PushFont(Fonts::Data());
+            ImGui::Text("%.2f %s", elements.elements.inclination * DEGREES_PER_RADIAN, "deg");
+            ImGui::PopFont();
+
+            AddElementKey(ASCENDING_NODE_TEXT);
+            ImGui::PushFont(Fonts::Data());
+            ImGui::Text("%.2f %s", elements.elements.longitudeOfAscendingNode * DEGREES_PER_RADIAN, "deg");
+            ImGui::PopFont();
+
+            AddElementKey(ARGUMENT_OF_PERIAPSIS_TEXT);
+            ImGui::PushFont(Fonts::Data());
+            ImGui::Text("%.2f %s", elements.elements.argumentOfPeriapsis * DEGREES_PER_RADIAN, "deg");
+            ImGui::PopFont();
+
+            AddElementKey(TRUE_ANOMALY_TEXT);
+            ImGui::PushFont(Fonts::Data());
+            ImGui::Text("%.2f %s", elements.elements.trueAnomaly * DEGREES_PER_RADIAN, "deg");
+            ImGui::PopFont();
+
+            AddElementKey(PERIOD_TEXT);
+            ImGui::PushFont(Fonts::Data());
+            if (elements.period > 0) {
+                ImGui::Text("%s", TimeFormat::FormatTime(int(std::min(elements.period, double(INT_MAX)))).c_str());
+            } else {
+                ImGui::Text("%s", "open orbit");
+            }
+            ImGui::PopFont();
+        }
     }
 
     auto Draw() -> void {
@@ -163,6 +240,7 @@ namespace BodyData {
         AddKineticEnergy(selectedBody);
         AddPotentialEnergy(selectedBody);
         AddTotalEnergy(selectedBody);
+        AddOrbitalElements(selectedBody);
 
         // End
         ImGui::EndTable();
@@ -3,10 +3,13 @@
 #include <rendering/interface/Fonts.h>
 #include <rendering/camera/CameraTransition.h>
 #include <simulation/Simulation.h>
+#include <simulation/OsculatingElements.h>
 #include <main/Bodies.h>
 
 #include <algorithm>
+#include <cmath>
 #include <ios>
+#include <limits>
 #include <iostream>
 
 #include <imgui.h>
@@ -20,17 +23,36 @@ namespace ScenarioExplorer {
     namespace {
         const string NAME_TEXT = ICON_MDI_FORMAT_TEXT + string(" Name");
         const string MASS_TEXT = ICON_MDI_WEIGHT + string(" Mass");
+        const string SEMI_MAJOR_AXIS_TEXT = ICON_MDI_ARROW_EXPAND_HORIZONTAL + string(" a");
+        const string ECCENTRICITY_TEXT = ICON_MDI_ELLIPSE_OUTLINE + string(" e");
+        const string INCLINATION_TEXT = ICON_MDI_ANGLE_ACUTE + string(" i");
+        const string ASCENDING_NODE_TEXT = ICON_MDI_ROTATE_3D_VARIANT + string(" Node");
+        const string ARGUMENT_OF_PERIAPSIS_TEXT = ICON_MDI_ANGLE_RIGHT + string(" Arg. Peri.");
+        const string TRUE_ANOMALY_TEXT = ICON_MDI_MAP_MARKER_PATH + string(" Anomaly");
+        const string PERIOD_TEXT = ICON_MDI_TIMER_OUTLINE + string(" Period");
 
         const int NAME_WEIGHT = 180;
         const int NAME_WIDTH = 260;
-        const int MASS_WEIGHT = 30;
+        const int MASS_WEIGHT = 80;
+        const int ELEMENT_WEIGHT = 80;
 
         const unsigned int NAME_COLUMN_ID = 0;
         const unsigned int MASS_COLUMN_ID = 1;
+        const unsigned int SEMI_MAJOR_AXIS_COLUMN_ID = 2;
+        const unsigned int ECCENTRICITY_COLUMN_ID = 3;
+        const unsigned int INCLINATION_COLUMN_ID = 4;
+        const unsigned int ASCENDING_NODE_COLUMN_ID = 5;
+        const unsigned int ARGUMENT_OF_PERIAPSIS_COLUMN_ID = 6;
+        const unsigned int TRUE_ANOMALY_COLUMN_ID = 7;
+        const unsigned int PERIOD_COLUMN_ID = 8;
+        const unsigned int COLUMN_COUNT = 9;
+
+        const double DEGREES_PER_RADIAN = 180.0 / M_PI;
 
         const ImVec2 TABLE_SIZE = ImVec2(300, 730);
 
-        const ImGuiTableFlags EXPLORER_FLAGS = ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_Sortable | ImGuiTableFlags_ScrollY | ImGuiTableFlags_NoPadOuterX | ImGuiTableFlags_NoPadInnerX;
+        // The elements don't fit next to the name, so the table scrolls sideways, and the less used angles start hidden
+        const ImGuiTableFlags EXPLORER_FLAGS = ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_Sortable | ImGuiTableFlags_ScrollY | ImGuiTableFlags_ScrollX | ImGuiTableFlags_Hideable | ImGuiTableFlags_NoPadOuterX | ImGuiTableFlags_NoPadInnerX;
 
         ImGuiTableSortSpecs* sortSpecs;
 
@@ -45,7 +67,16 @@ namespace ScenarioExplorer {
             ImGui::TableSetupColumn(NAME_TEXT.c_str(), ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_DefaultSort, NAME_WEIGHT, NAME_COLUMN_ID);
 
             // Add mass header
-            ImGui::TableSetupColumn(MASS_TEXT.c_str(), ImGuiTableColumnFlags_WidthStretch | ImGuiTableColumnFlags_PreferSortDescending, MASS_WEIGHT, MASS_COLUMN_ID);
+            ImGui::TableSetupColumn(MASS_TEXT.c_str(), ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, MASS_WEIGHT, MASS_COLUMN_ID);
+
+            // Add orbital element headers
+            ImGui::TableSetupColumn(SEMI_MAJOR_AXIS_TEXT.c_str(), ImGuiTableColumnFlags_WidthFixed, ELEMENT_WEIGHT, SEMI_MAJOR_AXIS_COLUMN_ID);
+            ImGui::TableSetupColumn(ECCENTRICITY_TEXT.c_str(), ImGuiTableColumnFlags_WidthFixed, ELEMENT_WEIGHT, ECCENTRICITY_COLUMN_ID);
+            ImGui::TableSetupColumn(INCLINATION_TEXT.c_str(), ImGuiTableColumnFlags_WidthFixed, ELEMENT_WEIGHT, INCLINATION_COLUMN_ID);
+            ImGui::TableSetupColumn(ASCENDING_NODE_TEXT.c_str(), ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_DefaultHide, ELEMENT_WEIGHT, ASCENDING_NODE_COLUMN_ID);
+            ImGui::TableSetupColumn(ARGUMENT_OF_PERIAPSIS_TEXT.c_str(), ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_DefaultHide, ELEMENT_WEIGHT, ARGUMENT_OF_PERIAPSIS_COLUMN_ID);
+            ImGui::TableSetupColumn(TRUE_ANOMALY_TEXT.c_str(), ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_DefaultHide, ELEMENT_WEIGHT, TRUE_ANOMALY_COLUMN_ID);
+            ImGui::TableSetupColumn(PERIOD_TEXT.c_str(), ImGuiTableColumnFlags_WidthFixed, ELEMENT_WEIGHT, PERIOD_COLUMN_ID);
 
             // Indicate to imgui that this is a header row
             ImGui::TableHeadersRow();
@@ -73,12 +104,39 @@ namespace ScenarioExplorer {
             ImGui::Text("%.2e %s", mass, "kg");
         }
 
+        auto AddElementsText(const string &id) -> void {
+            // Bodies without a primary leave the element columns blank
+            BodyElements elements {};
+            if (!OsculatingElements::Get(id, elements)) {
+                for (unsigned int column = SEMI_MAJOR_AXIS_COLUMN_ID; column < COLUMN_COUNT; column++) {
+                    ImGui::TableNextColumn();
+                }
+                return;
+            }
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2e %s", elements.elements.semiMajorAxis, "m");
+            ImGui::TableNextColumn();
+            ImGui::Text("%.4f", elements.elements.eccentricity);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f %s", elements.elements.inclination * DEGREES_PER_RADIAN, "deg");
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f %s", elements.elements.longitudeOfAscendingNode * DEGREES_PER_RADIAN, "deg");
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f %s", elements.elements.argumentOfPeriapsis * DEGREES_PER_RADIAN, "deg");
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f %s", elements.elements.trueAnomaly * DEGREES_PER_RADIAN, "deg");
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2e %s", elements.period, "s");
+        }
+
         auto AddBodiesToTable(const vector<string> &bodyIds) -> void {
             ZoneScoped;
             ImGui::PushFont(Fonts::Data());
-            for (const auto &pair : Bodies::GetBodies()) {
-                AddNameSelectable(pair.first, pair.second.GetName());
-                AddMassiveMassText(pair.second.GetMass());
+            for (const string &id : bodyIds) {
+                const Body &body = Bodies::GetBody(id);
+                AddNameSelectable(id, body.GetName());
+                AddMassiveMassText(body.GetMass());
+                AddElementsText(id);
             }
             ImGui::PopFont();
         }
@@ -103,18 +161,48 @@ namespace ScenarioExplorer {
             return !comparison;
         }
 
+        auto GetElementSortValue(const string &id, const unsigned int column) -> double {
+            // Bodies without a primary sort below every body with one
+            BodyElements elements {};
+            if (!OsculatingElements::Get(id, elements)) {
+                return -std::numeric_limits<double>::infinity();
+            }
+            switch (column) {
+                case SEMI_MAJOR_AXIS_COLUMN_ID: return elements.elements.semiMajorAxis;
+                case ECCENTRICITY_COLUMN_ID: return elements.elements.eccentricity;
+                case INCLINATION_COLUMN_ID: return elements.elements.inclination;
+                case ASCENDING_NODE_COLUMN_ID: return elements.elements.longitudeOfAscendingNode;
+                case ARGUMENT_OF_PERIAPSIS_COLUMN_ID: return elements.elements.argumentOfPeriapsis;
+                case TRUE_ANOMALY_COLUMN_ID: return elements.elements.trueAnomaly;
+                default: return elements.period;
+            }
+        }
+
+        auto CompareBodyElements(const string &id1, const string &id2, const unsigned int column) -> bool {
+            // Many bodies can share a value (every body without a primary does), so this must be a strict ordering
+            const double value1 = GetElementSortValue(id1, column);
+            const double value2 = GetElementSortValue(id2, column);
+            if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Descending) {
+                return value1 > value2;
+            }
+            return value1 < value2;
+        }
+
         auto CompareBodies(const string &id1, const string &id2) -> bool {
             if (sortSpecs->Specs->ColumnIndex == NAME_COLUMN_ID) {
                 return CompareBodyNames(id1, id2);
             }
-            return CompareBodyMasses(id1, id2);
+            if (sortSpecs->Specs->ColumnIndex == MASS_COLUMN_ID) {
+                return CompareBodyMasses(id1, id2);
+            }
+            return CompareBodyElements(id1, id2, sortSpecs->Specs->ColumnIndex);
         }
     }
 
     auto Draw() -> void {
         ZoneScoped;
         // Begin
-        ImGui::BeginTable("scenario-explorer", 2, EXPLORER_FLAGS, TABLE_SIZE);
+        ImGui::BeginTable("scenario-explorer", COLUMN_COUNT, EXPLORER_FLAGS, TABLE_SIZE);
 
         // Explorer header
         AddHeader();
@@ -122,7 +210,13 @@ namespace ScenarioExplorer {
 
         // Sort body ids according to the columns the user has selected
         sortSpecs = ImGui::TableGetSortSpecs();
-        vector<string> bodyIds = Bodies::GetBodyIds();
+        // Bodies that merged into another are no longer listed
+        vector<string> bodyIds;
+        for (const string &id : Bodies::GetBodyIds()) {
+            if (!Bodies::IsAbsorbed(id)) {
+                bodyIds.push_back(id);
+            }
+        }
         std::sort(bodyIds.begin(), bodyIds.end(), CompareBodies);
 
         // Add said body ids to the table
@@ -0,0 +1,125 @@
+#include "ConjunctionsControl.h"
+
+#include <rendering/interface/Fonts.h>
+#include <simulation/Conjunctions.h>
+#include <simulation/Simulation.h>
+#include <main/Bodies.h>
+#include <util/Log.h>
+#include <util/TimeFormat.h>
+#include <depend/IconsMaterialDesignIcons_c.h>
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <climits>
+#include <filesystem>
+
+
+
+namespace ConjunctionsControl {
+    namespace {
+        const string EXPORT_DIRECTORY = "../conjunctions/";
+        const string EXPORT_PATH = EXPORT_DIRECTORY + "conjunctions.csv";
+
+        const string SCREEN_TEXT = ICON_MDI_RADAR + string(" Screen");
+        const string CANCEL_TEXT = ICON_MDI_CLOSE + string(" Cancel");
+        const string EXPORT_TEXT = ICON_MDI_EXPORT + string(" Export");
+
+        const string TIME_TEXT = ICON_MDI_TIMER_SAND + string(" In");
+        const string BODIES_TEXT = ICON_MDI_EARTH + string(" Bodies");
+        const string DISTANCE_TEXT = ICON_MDI_RULER + string(" Distance");
+        const string SPEED_TEXT = ICON_MDI_SPEEDOMETER + string(" Speed");
+
+        const float TIME_WEIGHT = 60;
+        const float BODIES_WEIGHT = 120;
+        const float DISTANCE_WEIGHT = 70;
+        const float SPEED_WEIGHT = 70;
+
+        const ImVec2 TABLE_SIZE = ImVec2(390, 140);
+        const ImGuiTableFlags TABLE_FLAGS = ImGuiTableFlags_SizingStretchProp | ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg;
+
+        const double SECONDS_PER_DAY = 86400;
+        const float INPUT_WIDTH = 120;
+
+        double thresholdKilometres = 10;
+        int days = 30;
+
+        auto AddSettings() -> void {
+            ImGui::PushItemWidth(INPUT_WIDTH);
+            ImGui::InputDouble("Threshold (km)", &thresholdKilometres);
+            ImGui::InputInt("Duration (days)", &days);
+            ImGui::PopItemWidth();
+
+            thresholdKilometres = std::max(0.0, thresholdKilometres);
+            days = std::max(1, days);
+        }
+
+        auto AddButtons() -> void {
+            if (Conjunctions::IsRunning()) {
+                if (ImGui::Button(CANCEL_TEXT.c_str())) {
+                    Conjunctions::Cancel();
+                }
+                ImGui::SameLine();
+                ImGui::ProgressBar(Conjunctions::GetProgress());
+                return;
+            }
+
+            if (ImGui::Button(SCREEN_TEXT.c_str())) {
+                Conjunctions::Start(ConjunctionSettings{thresholdKilometres * 1000, days * SECONDS_PER_DAY});
+            }
+
+            ImGui::SameLine();
+            if (ImGui::Button(EXPORT_TEXT.c_str())) {
+                std::filesystem::create_directories(EXPORT_DIRECTORY);
+                if (Conjunctions::Export(EXPORT_PATH)) {
+                    Log(SUCCESS, "Exported " + std::to_string(Conjunctions::GetResults().size()) + " conjunctions to " + EXPORT_PATH);
+                } else {
+                    Log(ERROR, "Failed to export conjunctions to " + EXPORT_PATH);
+                }
+            }
+        }
+
+        auto AddHeader() -> void {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn(TIME_TEXT.c_str(), ImGuiTableColumnFlags_WidthStretch, TIME_WEIGHT);
+            ImGui::TableSetupColumn(BODIES_TEXT.c_str(), ImGuiTableColumnFlags_WidthStretch, BODIES_WEIGHT);
+            ImGui::TableSetupColumn(DISTANCE_TEXT.c_str(), ImGuiTableColumnFlags_WidthStretch, DISTANCE_WEIGHT);
+            ImGui::TableSetupColumn(SPEED_TEXT.c_str(), ImGuiTableColumnFlags_WidthStretch, SPEED_WEIGHT);
+            ImGui::TableHeadersRow();
+        }
+
+        auto AddConjunction(const Conjunction &conjunction, const double currentTime) -> void {
+            ImGui::TableNextColumn();
+            // Conjunctions the simulation has already passed are still listed until the next screening
+            ImGui::Text("%s", TimeFormat::FormatTime(int(std::clamp(conjunction.time - currentTime, 0.0, double(INT_MAX)))).c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%s / %s", Bodies::GetBody(conjunction.id).GetName().c_str(), Bodies::GetBody(conjunction.otherId).GetName().c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f km", conjunction.distance / 1000);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f km/s", conjunction.relativeSpeed / 1000);
+        }
+
+        auto AddResultTable() -> void {
+            const double currentTime = Simulation::GetTimeStep();
+            ImGui::BeginTable("conjunctions", 4, TABLE_FLAGS, TABLE_SIZE);
+            AddHeader();
+            ImGui::PushFont(Fonts::Data());
+            for (const Conjunction &conjunction : Conjunctions::GetResults()) {
+                AddConjunction(conjunction, currentTime);
+            }
+            ImGui::PopFont();
+            ImGui::EndTable();
+        }
+    }
+
+    auto Draw() -> void {
+        ImGui::PushFont(Fonts::Main());
+        AddSettings();
+        AddButtons();
+        if (!Conjunctions::IsRunning()) {
+            AddResultTable();
+        }
+        ImGui::PopFont();
+    }
+}
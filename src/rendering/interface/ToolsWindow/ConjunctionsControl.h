@@ -0,0 +1,7 @@
+#pragma once
+
+
+
+namespace ConjunctionsControl {
+    auto Draw() -> void;
+}
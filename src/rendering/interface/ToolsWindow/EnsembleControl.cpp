@@ -0,0 +1,124 @@
+#include "EnsembleControl.h"
+
+#include <rendering/interface/Fonts.h>
+#include <rendering/world/EnsembleRender.h>
+#include <simulation/Ensemble.h>
+#include <simulation/Simulation.h>
+#include <main/Bodies.h>
+#include <depend/IconsMaterialDesignIcons_c.h>
+
+#include <imgui.h>
+
+#include <algorithm>
+
+
+
+namespace EnsembleControl {
+    namespace {
+        const string ADD_TEXT = ICON_MDI_PLUS + string(" Add selected");
+        const string CLEAR_TEXT = ICON_MDI_DELETE + string(" Clear");
+        const string RUN_TEXT = ICON_MDI_DICE_MULTIPLE + string(" Run");
+        const string CANCEL_TEXT = ICON_MDI_CLOSE + string(" Cancel");
+        const string SHOW_TEXT = ICON_MDI_EYE + string(" Show cloud");
+
+        const unsigned int SECONDS_PER_DAY = 86400;
+        const double PARTS_PER_MILLION = 1.0e6;
+        const unsigned int SAMPLE_INTERVAL = 5;
+        const float INPUT_WIDTH = 120;
+
+        vector<string> perturbedIds;
+        int memberCount = 64;
+        double positionSigma = 100;
+        double velocitySigma = 1;
+        int days = 30;
+        int seed = 0;
+        bool mixedPrecision = false;
+
+        auto AddPerturbedBodies() -> void {
+            if (ImGui::Button(ADD_TEXT.c_str()) && Bodies::IsBodySelected()) {
+                const string id = Bodies::GetSelectedBodyId();
+                if (std::find(perturbedIds.begin(), perturbedIds.end(), id) == perturbedIds.end()) {
+                    perturbedIds.push_back(id);
+                }
+            }
+            ImGui::SameLine();
+            if (ImGui::Button(CLEAR_TEXT.c_str())) {
+                perturbedIds.clear();
+            }
+
+            string names;
+            for (const string &id : perturbedIds) {
+                if (Bodies::GetBodies().count(id) != 0) {
+                    names += (names.empty() ? "" : ", ") + Bodies::GetBody(id).GetName();
+                }
+            }
+            ImGui::PushFont(Fonts::Data());
+            ImGui::TextWrapped("Perturbing: %s", names.empty() ? "nothing" : names.c_str());
+            ImGui::PopFont();
+        }
+
+        auto AddSettings() -> void {
+            ImGui::PushItemWidth(INPUT_WIDTH);
+            ImGui::InputInt("Members", &memberCount);
+            ImGui::InputDouble("Position sigma (m)", &positionSigma);
+            ImGui::InputDouble("Velocity sigma (m/s)", &velocitySigma);
+            ImGui::InputInt("Duration (days)", &days);
+            ImGui::InputInt("Seed", &seed);
+            ImGui::PopItemWidth();
+            ImGui::Checkbox("Mixed precision", &mixedPrecision);
+
+            memberCount = std::max(1, memberCount);
+            days = std::max(1, days);
+        }
+
+        auto AddRunButton() -> void {
+            if (Ensemble::IsRunning()) {
+                if (ImGui::Button(CANCEL_TEXT.c_str())) {
+                    Ensemble::Cancel();
+                }
+                ImGui::SameLine();
+                ImGui::ProgressBar(Ensemble::GetProgress());
+                return;
+            }
+
+            if (ImGui::Button(RUN_TEXT.c_str())) {
+                EnsembleSettings settings {};
+                settings.perturbedIds = perturbedIds;
+                settings.memberCount = memberCount;
+                settings.positionSigma = positionSigma;
+                settings.velocitySigma = velocitySigma;
+                settings.stepCount = uint64_t(days) * SECONDS_PER_DAY / Simulation::GetTimeStepSize();
+                settings.sampleInterval = SAMPLE_INTERVAL;
+                settings.seed = seed;
+                settings.mixedPrecision = mixedPrecision;
+                Ensemble::Start(settings);
+            }
+
+            ImGui::SameLine();
+            bool visible = EnsembleRender::IsVisible();
+            if (ImGui::Checkbox(SHOW_TEXT.c_str(), &visible)) {
+                EnsembleRender::SetVisible(visible);
+            }
+        }
+
+        auto AddMixedPrecisionReport() -> void {
+            MixedPrecisionReport report {};
+            if (!Ensemble::GetMixedPrecisionReport(report)) {
+                return;
+            }
+            ImGui::PushFont(Fonts::Data());
+            ImGui::Text("Force error: %.3f ppm", report.forceError * PARTS_PER_MILLION);
+            ImGui::Text("Kernel speed: %.2fx double precision", report.speedup);
+            ImGui::PopFont();
+        }
+    }
+
+    auto Draw() -> void {
+        ImGui::PushFont(Fonts::Main());
+        AddPerturbedBodies();
+        AddSettings();
+        AddRunButton();
+        AddMixedPrecisionReport();
+        ImGui::PopFont();
+    }
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+
+
+namespace EnsembleControl {
+    auto Draw() -> void;
+}
@@ -0,0 +1,83 @@
+#include "EventsControl.h"
+
+#include <rendering/interface/Fonts.h>
+#include <rendering/world/OrbitPaths.h>
+#include <simulation/Events.h>
+#include <simulation/Simulation.h>
+#include <main/Bodies.h>
+#include <util/TimeFormat.h>
+#include <depend/IconsMaterialDesignIcons_c.h>
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <climits>
+#include <limits>
+
+
+
+namespace EventsControl {
+    namespace {
+        const string TIME_TEXT = ICON_MDI_TIMER_SAND + string(" In");
+        const string TYPE_TEXT = ICON_MDI_TAG + string(" Event");
+        const string BODIES_TEXT = ICON_MDI_EARTH + string(" Bodies");
+        const string DISTANCE_TEXT = ICON_MDI_RULER + string(" Distance");
+
+        const float TIME_WEIGHT = 60;
+        const float TYPE_WEIGHT = 70;
+        const float BODIES_WEIGHT = 120;
+        const float DISTANCE_WEIGHT = 70;
+
+        const ImVec2 TABLE_SIZE = ImVec2(390, 190);
+        const ImGuiTableFlags TABLE_FLAGS = ImGuiTableFlags_SizingStretchProp | ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg;
+
+        const unsigned int MAX_LISTED_EVENTS = 50;
+
+        auto AddHeader() -> void {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn(TIME_TEXT.c_str(), ImGuiTableColumnFlags_WidthStretch, TIME_WEIGHT);
+            ImGui::TableSetupColumn(TYPE_TEXT.c_str(), ImGuiTableColumnFlags_WidthStretch, TYPE_WEIGHT);
+            ImGui::TableSetupColumn(BODIES_TEXT.c_str(), ImGuiTableColumnFlags_WidthStretch, BODIES_WEIGHT);
+            ImGui::TableSetupColumn(DISTANCE_TEXT.c_str(), ImGuiTableColumnFlags_WidthStretch, DISTANCE_WEIGHT);
+            ImGui::TableHeadersRow();
+        }
+
+        auto AddEvent(const Event &event, const double currentTime) -> void {
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", TimeFormat::FormatTime(int(std::min(event.time - currentTime, double(INT_MAX)))).c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", Events::GetTypeName(event.type).c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%s / %s", Bodies::GetBody(event.id).GetName().c_str(), Bodies::GetBody(event.otherId).GetName().c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3e km", event.distance / 1000);
+        }
+
+        auto AddEventTable() -> void {
+            const double currentTime = Simulation::GetTimeStep();
+            vector<Event> events = Events::GetEvents(currentTime, std::numeric_limits<double>::max());
+            if (events.size() > MAX_LISTED_EVENTS) {
+                events.resize(MAX_LISTED_EVENTS);
+            }
+
+            ImGui::BeginTable("upcoming-events", 4, TABLE_FLAGS, TABLE_SIZE);
+            AddHeader();
+            ImGui::PushFont(Fonts::Data());
+            for (const Event &event : events) {
+                AddEvent(event, currentTime);
+            }
+            ImGui::PopFont();
+            ImGui::EndTable();
+        }
+    }
+
+    auto Draw() -> void {
+        ImGui::PushFont(Fonts::Main());
+        bool showMarkers = OrbitPaths::GetShowEventMarkers();
+        if (ImGui::Checkbox("Show markers on paths", &showMarkers)) {
+            OrbitPaths::SetShowEventMarkers(showMarkers);
+        }
+        AddEventTable();
+        ImGui::PopFont();
+    }
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+
+
+namespace EventsControl {
+    auto Draw() -> void;
+}
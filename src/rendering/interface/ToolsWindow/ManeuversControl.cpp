@@ -0,0 +1,89 @@
+#include "ManeuversControl.h"
+
+#include <rendering/interface/Fonts.h>
+#include <simulation/Maneuvers.h>
+#include <simulation/Simulation.h>
+#include <main/Bodies.h>
+#include <util/TimeFormat.h>
+#include <depend/IconsMaterialDesignIcons_c.h>
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <climits>
+
+
+
+namespace ManeuversControl {
+    namespace {
+        const string ADD_TEXT = ICON_MDI_PLUS + string(" Add to selected");
+        const string REMOVE_TEXT = ICON_MDI_DELETE;
+
+        const double SECONDS_PER_DAY = 86400;
+        const float INPUT_WIDTH = 120;
+        const float DELTA_V_WIDTH = 80;
+
+        double days = 1;
+
+        auto AddNewNode() -> void {
+            if (ImGui::Button(ADD_TEXT.c_str()) && Bodies::IsBodySelected()) {
+                Maneuvers::Add(Bodies::GetSelectedBodyId(), Simulation::GetTimeStep() + (days * SECONDS_PER_DAY));
+            }
+            ImGui::SameLine();
+            ImGui::PushItemWidth(INPUT_WIDTH);
+            ImGui::InputDouble("In (days)", &days);
+            ImGui::PopItemWidth();
+            days = std::max(0.0, days);
+        }
+
+        auto AddNode(const unsigned int index, const ManeuverNode &node, const double currentTime) -> bool {
+            // Returns true if the node was removed
+            ImGui::PushID(int(index));
+            bool removed = false;
+            if (ImGui::Button(REMOVE_TEXT.c_str())) {
+                Maneuvers::Remove(index);
+                removed = true;
+            }
+            ImGui::SameLine();
+
+            ImGui::PushFont(Fonts::Data());
+            const bool passed = node.time < currentTime;
+            ImGui::Text("%s %s %s", Bodies::GetBody(node.id).GetName().c_str(), passed ? "passed" : "in",
+                passed ? "" : TimeFormat::FormatTime(int(std::min(node.time - currentTime, double(INT_MAX)))).c_str());
+            ImGui::PopFont();
+
+            // Nodes the simulation has already passed can no longer be changed
+            ImGui::BeginDisabled(passed || removed);
+            dvec3 deltaV = node.deltaV;
+            bool changed = false;
+            ImGui::PushItemWidth(DELTA_V_WIDTH);
+            changed |= ImGui::InputDouble("Prograde", &deltaV.x, 0, 0, "%.2f");
+            ImGui::SameLine();
+            changed |= ImGui::InputDouble("Normal", &deltaV.y, 0, 0, "%.2f");
+            ImGui::SameLine();
+            changed |= ImGui::InputDouble("Radial (m/s)", &deltaV.z, 0, 0, "%.2f");
+            ImGui::PopItemWidth();
+            ImGui::EndDisabled();
+
+            if (changed && !passed && !removed) {
+                Maneuvers::SetDeltaV(index, deltaV);
+            }
+            ImGui::PopID();
+            return removed;
+        }
+    }
+
+    auto Draw() -> void {
+        ImGui::PushFont(Fonts::Main());
+        AddNewNode();
+
+        const double currentTime = Simulation::GetTimeStep();
+        const vector<ManeuverNode> nodes = Maneuvers::GetNodes();
+        for (unsigned int i = 0; i < nodes.size(); i++) {
+            if (AddNode(i, nodes.at(i), currentTime)) {
+                break;
+            }
+        }
+        ImGui::PopFont();
+    }
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+
+
+namespace ManeuversControl {
+    auto Draw() -> void;
+}
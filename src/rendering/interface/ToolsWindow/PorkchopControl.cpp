@@ -0,0 +1,211 @@
+#include "PorkchopControl.h"
+
+#include <rendering/interface/Fonts.h>
+#include <simulation/Porkchop.h>
+#include <simulation/Simulation.h>
+#include <main/Bodies.h>
+#include <depend/IconsMaterialDesignIcons_c.h>
+
+#include <imgui.h>
+#include <depend/implot/implot.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+
+namespace PorkchopControl {
+    namespace {
+        enum PlotQuantity {
+            PLOT_QUANTITY_DEPARTURE,
+            PLOT_QUANTITY_ARRIVAL,
+            PLOT_QUANTITY_TOTAL
+        };
+
+        const string START_TEXT = ICON_MDI_PLAY + string(" Compute");
+        const string CANCEL_TEXT = ICON_MDI_CLOSE + string(" Cancel");
+        const string SET_DEPARTURE_TEXT = ICON_MDI_ARROW_TOP_RIGHT + string(" Departure");
+        const string SET_ARRIVAL_TEXT = ICON_MDI_ARROW_BOTTOM_RIGHT + string(" Arrival");
+
+        const ImVec2 PLOT_WINDOW_SIZE = ImVec2(620, 520);
+        const ImVec2 PLOT_WINDOW_POSITION = ImVec2(700, 100);
+        const float COLORMAP_SCALE_WIDTH = 70;
+
+        const double SECONDS_PER_DAY = 86400;
+        const float INPUT_WIDTH = 80;
+        const int MIN_GRID_SIZE = 2;
+        const int MAX_GRID_SIZE = 1000;
+
+        string departureId;
+        string arrivalId;
+        double departureStartDays = 0;
+        double departureEndDays = 365;
+        double arrivalStartDays = 100;
+        double arrivalEndDays = 600;
+        int gridSize = 200;
+
+        bool showPlot = true;
+        int quantity = PLOT_QUANTITY_TOTAL;
+        double maxDeltaVKilometres = 20;
+
+        // Time the last run was started, so the plot axes can be shown in days from then
+        double runTime = 0;
+        vector<double> plotValues;
+        double plotMin = 0;
+
+        auto GetBodyName(const string &id) -> string {
+            const auto &bodies = Bodies::GetBodies();
+            return (bodies.find(id) == bodies.end()) ? "none" : bodies.at(id).GetName();
+        }
+
+        auto RebuildPlotValues() -> void {
+            // ImPlot draws row 0 at the top, so rows are flipped to make arrival time increase upwards
+            // Cells without a transfer, or above the scale, are drawn at the top of the scale
+            const PorkchopSettings &settings = Porkchop::GetSettings();
+            const vector<double> &departure = Porkchop::GetDepartureDeltaV();
+            const vector<double> &arrival = Porkchop::GetArrivalDeltaV();
+            const double maxDeltaV = maxDeltaVKilometres * 1000;
+
+            plotValues.assign(departure.size(), maxDeltaVKilometres);
+            plotMin = maxDeltaVKilometres;
+            for (unsigned int row = 0; row < settings.arrivalCount && !departure.empty(); row++) {
+                const unsigned int arrivalIndex = settings.arrivalCount - 1 - row;
+                for (unsigned int column = 0; column < settings.departureCount; column++) {
+                    const unsigned int index = (arrivalIndex * settings.departureCount) + column;
+                    double deltaV = departure.at(index) + arrival.at(index);
+                    if (quantity == PLOT_QUANTITY_DEPARTURE) {
+                        deltaV = departure.at(index);
+                    } else if (quantity == PLOT_QUANTITY_ARRIVAL) {
+                        deltaV = arrival.at(index);
+                    }
+                    if (std::isnan(deltaV) || (deltaV > maxDeltaV)) {
+                        continue;
+                    }
+                    plotValues.at((row * settings.departureCount) + column) = deltaV / 1000;
+                    plotMin = std::min(plotMin, deltaV / 1000);
+                }
+            }
+        }
+
+        auto AddBodies() -> void {
+            if (ImGui::Button(SET_DEPARTURE_TEXT.c_str()) && Bodies::IsBodySelected()) {
+                departureId = Bodies::GetSelectedBodyId();
+            }
+            ImGui::SameLine();
+            ImGui::Text("%s", GetBodyName(departureId).c_str());
+            ImGui::SameLine();
+            if (ImGui::Button(SET_ARRIVAL_TEXT.c_str()) && Bodies::IsBodySelected()) {
+                arrivalId = Bodies::GetSelectedBodyId();
+            }
+            ImGui::SameLine();
+            ImGui::Text("%s", GetBodyName(arrivalId).c_str());
+        }
+
+        auto AddSettings() -> void {
+            ImGui::PushItemWidth(INPUT_WIDTH);
+            ImGui::InputDouble("##departureStart", &departureStartDays, 0, 0, "%.1f");
+            ImGui::SameLine();
+            ImGui::InputDouble("Departure (days)", &departureEndDays, 0, 0, "%.1f");
+            ImGui::InputDouble("##arrivalStart", &arrivalStartDays, 0, 0, "%.1f");
+            ImGui::SameLine();
+            ImGui::InputDouble("Arrival (days)", &arrivalEndDays, 0, 0, "%.1f");
+            ImGui::InputInt("Grid size", &gridSize);
+            ImGui::PopItemWidth();
+
+            departureStartDays = std::max(0.0, departureStartDays);
+            departureEndDays = std::max(departureStartDays, departureEndDays);
+            arrivalStartDays = std::max(0.0, arrivalStartDays);
+            arrivalEndDays = std::max(arrivalStartDays, arrivalEndDays);
+            gridSize = std::clamp(gridSize, MIN_GRID_SIZE, MAX_GRID_SIZE);
+        }
+
+        auto AddButtons() -> void {
+            if (Porkchop::IsRunning()) {
+                if (ImGui::Button(CANCEL_TEXT.c_str())) {
+                    Porkchop::Cancel();
+                }
+                ImGui::SameLine();
+                ImGui::ProgressBar(Porkchop::GetProgress());
+                return;
+            }
+
+            if (ImGui::Button(START_TEXT.c_str())) {
+                runTime = Simulation::GetTimeStep();
+                Porkchop::Start(PorkchopSettings{
+                    departureId, arrivalId,
+                    runTime + (departureStartDays * SECONDS_PER_DAY), runTime + (departureEndDays * SECONDS_PER_DAY),
+                    runTime + (arrivalStartDays * SECONDS_PER_DAY), runTime + (arrivalEndDays * SECONDS_PER_DAY),
+                    unsigned(gridSize), unsigned(gridSize)});
+            }
+            ImGui::SameLine();
+            ImGui::Checkbox("Show plot", &showPlot);
+        }
+
+        auto AddPlotSettings() -> bool {
+            // Returns true if the plotted values need rebuilding
+            bool changed = false;
+            changed |= ImGui::RadioButton("Departure", &quantity, PLOT_QUANTITY_DEPARTURE);
+            ImGui::SameLine();
+            changed |= ImGui::RadioButton("Arrival", &quantity, PLOT_QUANTITY_ARRIVAL);
+            ImGui::SameLine();
+            changed |= ImGui::RadioButton("Total", &quantity, PLOT_QUANTITY_TOTAL);
+            ImGui::SameLine();
+            ImGui::PushItemWidth(INPUT_WIDTH);
+            changed |= ImGui::InputDouble("Max (km/s)", &maxDeltaVKilometres, 0, 0, "%.1f");
+            ImGui::PopItemWidth();
+            maxDeltaVKilometres = std::max(0.1, maxDeltaVKilometres);
+            return changed;
+        }
+
+        auto AddPlot() -> void {
+            const PorkchopSettings &settings = Porkchop::GetSettings();
+            const ImVec2 available = ImGui::GetContentRegionAvail();
+            const ImVec2 plotSize = ImVec2(available.x - COLORMAP_SCALE_WIDTH, available.y);
+
+            ImPlot::PushColormap(ImPlotColormap_Viridis);
+            if (ImPlot::BeginPlot("##porkchop", plotSize)) {
+                ImPlot::SetupAxes("Departure (days)", "Arrival (days)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+                const ImPlotPoint boundsMin = ImPlotPoint((settings.departureStart - runTime) / SECONDS_PER_DAY, (settings.arrivalStart - runTime) / SECONDS_PER_DAY);
+                const ImPlotPoint boundsMax = ImPlotPoint((settings.departureEnd - runTime) / SECONDS_PER_DAY, (settings.arrivalEnd - runTime) / SECONDS_PER_DAY);
+                ImPlot::PlotHeatmap("##deltaV", plotValues.data(), int(settings.arrivalCount), int(settings.departureCount), plotMin, maxDeltaVKilometres, nullptr, boundsMin, boundsMax);
+                ImPlot::EndPlot();
+            }
+            ImGui::SameLine();
+            ImPlot::ColormapScale("km/s", plotMin, maxDeltaVKilometres, ImVec2(COLORMAP_SCALE_WIDTH, plotSize.y));
+            ImPlot::PopColormap();
+        }
+    }
+
+    auto Draw() -> void {
+        ImGui::PushFont(Fonts::Main());
+        AddBodies();
+        AddSettings();
+        AddButtons();
+        ImGui::PopFont();
+    }
+
+    auto DrawPlotWindow() -> void {
+        ZoneScoped;
+        bool rebuild = Porkchop::TakeNewResult();
+        if (!showPlot || Porkchop::IsRunning() || Porkchop::GetDepartureDeltaV().empty()) {
+            if (rebuild) {
+                RebuildPlotValues();
+            }
+            return;
+        }
+
+        ImGui::SetNextWindowSize(PLOT_WINDOW_SIZE, ImGuiCond_FirstUseEver);
+        ImGui::SetNextWindowPos(PLOT_WINDOW_POSITION, ImGuiCond_FirstUseEver);
+        ImGui::Begin("Transfer Windows", &showPlot);
+        ImGui::PushFont(Fonts::Main());
+        ImGui::Text("%s to %s around %s", GetBodyName(Porkchop::GetSettings().departureId).c_str(),
+            GetBodyName(Porkchop::GetSettings().arrivalId).c_str(), GetBodyName(Porkchop::GetCentralId()).c_str());
+        rebuild |= AddPlotSettings();
+        if (rebuild) {
+            RebuildPlotValues();
+        }
+        AddPlot();
+        ImGui::PopFont();
+        ImGui::End();
+    }
+}
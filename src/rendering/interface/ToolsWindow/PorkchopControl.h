@@ -0,0 +1,10 @@
+#pragma once
+
+
+
+namespace PorkchopControl {
+    auto Draw() -> void;
+
+    // The plot has its own resizable window so it can be made large enough to read, and stays open outside the tab
+    auto DrawPlotWindow() -> void;
+}
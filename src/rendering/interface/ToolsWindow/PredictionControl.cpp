@@ -0,0 +1,110 @@
+#include "PredictionControl.h"
+
+#include <rendering/interface/Fonts.h>
+#include <simulation/Regularization.h>
+#include <simulation/Simulation.h>
+#include <util/TimeFormat.h>
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <climits>
+
+
+
+namespace PredictionControl {
+    namespace {
+        const double SECONDS_PER_DAY = 86400;
+        const float INPUT_WIDTH = 120;
+
+        // Limited to a little under the frame time, so the frame is never held up waiting for the prediction
+        const float MIN_BUDGET_MS = 1;
+        const float MAX_BUDGET_MS = 14;
+
+        const double MIN_PERIODS = 0.1;
+        const double MIN_DAYS = 1;
+
+        // The softening box edits its own copy, so the prediction is only reset once editing finishes
+        double softeningKilometres = 0;
+
+        auto AddHorizonSettings() -> void {
+            int type = Simulation::GetHorizonType();
+            double value = Simulation::GetHorizonValue();
+            double days = value / SECONDS_PER_DAY;
+            bool changed = false;
+
+            changed |= ImGui::RadioButton("Duration", &type, HORIZON_TYPE_DURATION);
+            ImGui::SameLine();
+            changed |= ImGui::RadioButton("Orbital periods", &type, HORIZON_TYPE_ORBITAL_PERIODS);
+
+            ImGui::PushItemWidth(INPUT_WIDTH);
+            if (type == HORIZON_TYPE_DURATION) {
+                // Switching from periods leaves a meaningless number of days, so start from one year instead
+                if (changed) {
+                    days = 365;
+                }
+                changed |= ImGui::InputDouble("Horizon (days)", &days);
+                value = std::max(MIN_DAYS, days) * SECONDS_PER_DAY;
+            } else {
+                if (changed) {
+                    value = 3;
+                }
+                changed |= ImGui::InputDouble("Periods of selected body", &value);
+                value = std::max(MIN_PERIODS, value);
+            }
+            ImGui::PopItemWidth();
+
+            if (changed) {
+                Simulation::SetHorizon(HorizonType(type), value);
+            }
+
+            ImGui::PushFont(Fonts::Data());
+            ImGui::Text("Predicting %s ahead", TimeFormat::FormatTime(int(std::min(Simulation::GetHorizonDuration(), double(INT_MAX)))).c_str());
+            ImGui::PopFont();
+        }
+
+        auto AddBudgetSettings() -> void {
+            float budget = float(Simulation::GetPredictionBudget() * 1000);
+            ImGui::PushItemWidth(INPUT_WIDTH);
+            if (ImGui::SliderFloat("CPU budget (ms/frame)", &budget, MIN_BUDGET_MS, MAX_BUDGET_MS, "%.1f")) {
+                Simulation::SetPredictionBudget(double(budget) / 1000);
+            }
+            ImGui::PopItemWidth();
+        }
+
+        auto AddEncounterSettings() -> void {
+            bool regularize = Regularization::IsEnabled();
+            if (ImGui::Checkbox("Regularize close encounters", &regularize)) {
+                Regularization::SetEnabled(regularize);
+            }
+
+            ImGui::PushItemWidth(INPUT_WIDTH);
+            ImGui::InputDouble("Softening (km)", &softeningKilometres, 0, 0, "%.1f");
+            if (ImGui::IsItemDeactivatedAfterEdit()) {
+                softeningKilometres = std::max(0.0, softeningKilometres);
+                Regularization::SetSoftening(softeningKilometres * 1000);
+            }
+            ImGui::PopItemWidth();
+        }
+
+        auto AddProgress() -> void {
+            ImGui::PushFont(Fonts::Data());
+            ImGui::ProgressBar(float(Simulation::GetPreviewProgress()), ImVec2(INPUT_WIDTH, 0));
+            ImGui::SameLine();
+            ImGui::Text("Preview");
+            ImGui::ProgressBar(float(Simulation::GetPredictionProgress()), ImVec2(INPUT_WIDTH, 0));
+            ImGui::SameLine();
+            ImGui::Text("Refined");
+            ImGui::PopFont();
+        }
+    }
+
+    auto Draw() -> void {
+        ImGui::PushFont(Fonts::Main());
+        AddHorizonSettings();
+        AddBudgetSettings();
+        AddEncounterSettings();
+        AddProgress();
+        ImGui::PopFont();
+    }
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+
+
+namespace PredictionControl {
+    auto Draw() -> void;
+}
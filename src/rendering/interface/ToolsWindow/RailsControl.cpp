@@ -0,0 +1,66 @@
+#include "RailsControl.h"
+
+#include <rendering/interface/Fonts.h>
+#include <simulation/Rails.h>
+#include <simulation/SoiHierarchy.h>
+#include <main/Bodies.h>
+#include <depend/IconsMaterialDesignIcons_c.h>
+
+#include <imgui.h>
+
+
+
+namespace RailsControl {
+    namespace {
+        const string ALL_ON_TEXT = ICON_MDI_CHECK_ALL + string(" All on rails");
+        const string ALL_OFF_TEXT = ICON_MDI_CLOSE_BOX_MULTIPLE + string(" All integrated");
+
+        auto AddSelectedBody() -> void {
+            if (!Bodies::IsBodySelected()) {
+                ImGui::Text("%s", "No body selected");
+                return;
+            }
+
+            const string id = Bodies::GetSelectedBodyId();
+            bool onRails = Rails::IsOnRails(id);
+            if (ImGui::Checkbox("Selected body on rails", &onRails)) {
+                Rails::SetOnRails(id, onRails);
+            }
+
+            // The hierarchy only depends on the massive bodies, so it is cheap enough to rebuild for display
+            unordered_map<string, OrbitPoint> points;
+            for (const auto &pair : Bodies::GetMassiveBodies()) {
+                points.insert(std::make_pair(pair.first, OrbitPoint{pair.second.GetPosition(), pair.second.GetVelocity()}));
+            }
+            SoiHierarchy hierarchy;
+            hierarchy.Build(points);
+
+            const Body &body = Bodies::GetBody(id);
+            const int parent = hierarchy.FindParent(id, body.GetPosition());
+            ImGui::PushFont(Fonts::Data());
+            if (parent < 0) {
+                ImGui::Text("%s", "No parent; always integrated");
+            } else {
+                ImGui::Text("Parent: %s", Bodies::GetBody(hierarchy.GetId(parent)).GetName().c_str());
+            }
+            ImGui::PopFont();
+        }
+    }
+
+    auto Draw() -> void {
+        ImGui::PushFont(Fonts::Main());
+        AddSelectedBody();
+
+        if (ImGui::Button(ALL_ON_TEXT.c_str())) {
+            Rails::SetAllOnRails(true);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button(ALL_OFF_TEXT.c_str())) {
+            Rails::SetAllOnRails(false);
+        }
+
+        ImGui::Text("%u of %u bodies on rails", Rails::GetOnRailsCount(), Bodies::GetBodyCount());
+        ImGui::TextWrapped("%s", "Changing which bodies are on rails recomputes the prediction from now and clears maneuver nodes.");
+        ImGui::PopFont();
+    }
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+
+
+namespace RailsControl {
+    auto Draw() -> void;
+}
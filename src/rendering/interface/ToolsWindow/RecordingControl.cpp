@@ -0,0 +1,107 @@
+#include "RecordingControl.h"
+
+#include "util/TimeFormat.h"
+
+#include <rendering/interface/Fonts.h>
+#include <simulation/Recorder.h>
+#include <simulation/Replay.h>
+#include <depend/IconsMaterialDesignIcons_c.h>
+
+#include <imgui.h>
+
+#include <filesystem>
+
+
+
+namespace RecordingControl {
+    namespace {
+        const string RECORDING_DIRECTORY = "../recordings/";
+        const string RECORDING_SUFFIX = ".orec";
+
+        const string RECORD_TEXT = ICON_MDI_RECORD + string(" Record");
+        const string STOP_TEXT = ICON_MDI_STOP + string(" Stop");
+        const string OPEN_TEXT = ICON_MDI_FOLDER_OPEN + string(" Replay");
+        const string CLOSE_TEXT = ICON_MDI_CLOSE + string(" Close");
+
+        const ImVec4 RECORDING_COLOR = ImVec4(1.0, 0.3, 0.3, 1.0);
+
+        const int TEXT_BUFFER_SIZE = 256;
+        const double BYTES_PER_KILOBYTE = 1024.0;
+
+        char filename[TEXT_BUFFER_SIZE] = "recording"; //NOLINT(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+        float replayTime = 0;
+
+        auto GetPath() -> string {
+            return RECORDING_DIRECTORY + string((char*)filename) + RECORDING_SUFFIX;
+        }
+
+        auto AddFilenameEntry() -> void {
+            ImGui::InputTextWithHint("##recording", "recording name", (char*)filename, TEXT_BUFFER_SIZE * sizeof(char));
+        }
+
+        auto AddRecordButton() -> void {
+            if (!Recorder::IsRecording()) {
+                if (ImGui::Button(RECORD_TEXT.c_str())) {
+                    std::filesystem::create_directories(RECORDING_DIRECTORY);
+                    Recorder::Start(GetPath());
+                }
+                return;
+            }
+
+            ImGui::PushStyleColor(ImGuiCol_Text, RECORDING_COLOR);
+            if (ImGui::Button(STOP_TEXT.c_str())) {
+                Recorder::Stop();
+            }
+            ImGui::PopStyleColor();
+        }
+
+        auto AddReplayButton() -> void {
+            if (!Replay::IsOpen()) {
+                if (ImGui::Button(OPEN_TEXT.c_str())) {
+                    // Make sure everything recorded so far is on disk before we map the file
+                    Recorder::Stop();
+                    if (Replay::Open(GetPath())) {
+                        replayTime = float(Replay::GetTime());
+                    }
+                }
+                return;
+            }
+
+            if (ImGui::Button(CLOSE_TEXT.c_str())) {
+                Replay::Close();
+            }
+        }
+
+        auto AddRecordingStatus() -> void {
+            ImGui::PushFont(Fonts::Data());
+            ImGui::Text("%u states  %.1f KiB", Recorder::GetStateCount(), double(Recorder::GetBytesWritten()) / BYTES_PER_KILOBYTE);
+            ImGui::PopFont();
+        }
+
+        auto AddReplaySlider() -> void {
+            if (!Replay::IsOpen()) {
+                return;
+            }
+
+            if (ImGui::SliderFloat("##replay", &replayTime, float(Replay::GetStartTime()), float(Replay::GetEndTime()), "")) {
+                Replay::Seek(replayTime);
+            }
+
+            ImGui::PushFont(Fonts::Data());
+            ImGui::Text("%s", TimeFormat::FormatTime(int(Replay::GetTime())).c_str());
+            ImGui::PopFont();
+        }
+    }
+
+    auto Draw() -> void {
+        ImGui::PushFont(Fonts::Main());
+        AddFilenameEntry();
+        AddRecordButton();
+        ImGui::SameLine();
+        AddReplayButton();
+        ImGui::PopFont();
+
+        AddRecordingStatus();
+        AddReplaySlider();
+    }
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+
+
+namespace RecordingControl {
+    auto Draw() -> void;
+}
@@ -0,0 +1,82 @@
+#include "ToolsWindow.h"
+
+#include "rendering/interface/ToolsWindow/RecordingControl.h"
+#include "rendering/interface/ToolsWindow/EnsembleControl.h"
+#include "rendering/interface/ToolsWindow/PredictionControl.h"
+#include "rendering/interface/ToolsWindow/EventsControl.h"
+#include "rendering/interface/ToolsWindow/ConjunctionsControl.h"
+#include "rendering/interface/ToolsWindow/ManeuversControl.h"
+#include "rendering/interface/ToolsWindow/PorkchopControl.h"
+#include "rendering/interface/ToolsWindow/RailsControl.h"
+#include <depend/IconsMaterialDesignIcons_c.h>
+
+#include <imgui.h>
+
+#include <util/Types.h>
+
+
+namespace ToolsWindow {
+    namespace {
+        const ImVec2 WINDOW_SIZE = ImVec2(400, 260);
+        const ImVec2 WINDOW_POSITION = ImVec2(1465, 600);
+        const ImGuiWindowFlags WINDOW_FLAGS = ImGuiWindowFlags_NoBackground | ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove;
+
+        const string RECORDING_TAB_TEXT = ICON_MDI_RECORD_REC + string(" Recording");
+        const string ENSEMBLE_TAB_TEXT = ICON_MDI_SCATTER_PLOT + string(" Ensemble");
+        const string PREDICTION_TAB_TEXT = ICON_MDI_CHART_TIMELINE_VARIANT + string(" Prediction");
+        const string EVENTS_TAB_TEXT = ICON_MDI_ORBIT + string(" Events");
+        const string CONJUNCTIONS_TAB_TEXT = ICON_MDI_RADAR + string(" Conjunctions");
+        const string MANEUVERS_TAB_TEXT = ICON_MDI_ROCKET + string(" Maneuvers");
+        const string TRANSFERS_TAB_TEXT = ICON_MDI_SWAP_HORIZONTAL + string(" Transfers");
+        const string RAILS_TAB_TEXT = ICON_MDI_TRAIN + string(" Rails");
+
+        bool windowOpen = true;
+    }
+
+    auto Draw() -> void {
+        ZoneScoped;
+        ImGui::Begin("Tools Window", &windowOpen, WINDOW_FLAGS);
+        ImGui::SetWindowSize(WINDOW_SIZE);
+        ImGui::SetWindowPos(WINDOW_POSITION);
+
+        if (ImGui::BeginTabBar("Tools")) {
+            if (ImGui::BeginTabItem(RECORDING_TAB_TEXT.c_str())) {
+                RecordingControl::Draw();
+                ImGui::EndTabItem();
+            }
+            if (ImGui::BeginTabItem(ENSEMBLE_TAB_TEXT.c_str())) {
+                EnsembleControl::Draw();
+                ImGui::EndTabItem();
+            }
+            if (ImGui::BeginTabItem(PREDICTION_TAB_TEXT.c_str())) {
+                PredictionControl::Draw();
+                ImGui::EndTabItem();
+            }
+            if (ImGui::BeginTabItem(EVENTS_TAB_TEXT.c_str())) {
+                EventsControl::Draw();
+                ImGui::EndTabItem();
+            }
+            if (ImGui::BeginTabItem(CONJUNCTIONS_TAB_TEXT.c_str())) {
+                ConjunctionsControl::Draw();
+                ImGui::EndTabItem();
+            }
+            if (ImGui::BeginTabItem(MANEUVERS_TAB_TEXT.c_str())) {
+                ManeuversControl::Draw();
+                ImGui::EndTabItem();
+            }
+            if (ImGui::BeginTabItem(TRANSFERS_TAB_TEXT.c_str())) {
+                PorkchopControl::Draw();
+                ImGui::EndTabItem();
+            }
+            if (ImGui::BeginTabItem(RAILS_TAB_TEXT.c_str())) {
+                RailsControl::Draw();
+                ImGui::EndTabItem();
+            }
+            ImGui::EndTabBar();
+        }
+
+        ImGui::End();
+
+        PorkchopControl::DrawPlotWindow();
+    }
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+
+
+namespace ToolsWindow {
+    auto Draw() -> void;
+}
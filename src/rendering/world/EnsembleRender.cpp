@@ -0,0 +1,102 @@
+#include "EnsembleRender.h"
+
+#include <simulation/Ensemble.h>
+#include <main/Bodies.h>
+#include <rendering/VAO.h>
+#include <rendering/camera/Camera.h>
+#include <rendering/geometry/Rays.h>
+#include <rendering/shaders/Program.h>
+#include <util/Types.h>
+
+#include <memory>
+#include <glad/glad.h>
+
+using std::unique_ptr;
+
+
+
+namespace EnsembleRender {
+    namespace {
+        const int STRIDE = 6;
+
+        // Members are drawn slightly darker than the body itself so the cloud doesn't hide the real future path
+        const float CLOUD_BRIGHTNESS = 0.6;
+
+        unique_ptr<VAO> cloudVAO;
+        unique_ptr<Program> program;
+        bool visible = true;
+
+        auto AddVertex(vector<VERTEX_DATA_TYPE> &vertices, const vec3 position, const vec3 color) -> void {
+            vertices.push_back(position.x);
+            vertices.push_back(position.y);
+            vertices.push_back(position.z);
+            vertices.push_back(color.r);
+            vertices.push_back(color.g);
+            vertices.push_back(color.b);
+        }
+
+        auto RebuildVertices() -> void {
+            // The cloud only changes when a run completes, so it is uploaded once and drawn from the same buffer after that
+            ZoneScoped;
+            const vector<string> &ids = Ensemble::GetPerturbedIds();
+            const vector<vector<dvec3>> &paths = Ensemble::GetPaths();
+
+            vector<VERTEX_DATA_TYPE> vertices;
+            for (unsigned int i = 0; i < paths.size(); i++) {
+                const string &id = ids.at(i % ids.size());
+                const vec3 color = Bodies::GetBody(id).GetColor() * CLOUD_BRIGHTNESS;
+                for (const dvec3 &position : paths.at(i)) {
+                    AddVertex(vertices, Rays::Scale(position), color);
+                }
+            }
+
+            cloudVAO->Data(vertices, vertices.size() / STRIDE, GL_STATIC_DRAW);
+        }
+    }
+
+    auto Init() -> void {
+        Shader vertex = Shader("../resources/shaders/path-vertex.vsh", GL_VERTEX_SHADER);
+        Shader fragment = Shader("../resources/shaders/path-fragment.fsh", GL_FRAGMENT_SHADER);
+        program = std::make_unique<Program>(vertex, fragment);
+
+        cloudVAO = std::make_unique<VAO>();
+        cloudVAO->Init();
+        cloudVAO->AddVertexAttribute(VertexAttribute{
+            .index = 0,
+            .size = 3,
+            .type = GL_FLOAT,
+            .normalised = GL_FALSE,
+            .stride = STRIDE * sizeof(float),
+            .offset = nullptr});
+        cloudVAO->AddVertexAttribute(VertexAttribute{
+            .index = 1,
+            .size = 3,
+            .type = GL_FLOAT,
+            .normalised = GL_FALSE,
+            .stride = STRIDE * sizeof(float),
+            .offset = (void*)(3 * sizeof(float))}); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+    }
+
+    auto Update() -> void {
+        ZoneScoped;
+        if (Ensemble::TakeNewResult()) {
+            RebuildVertices();
+        }
+
+        if (!visible) {
+            return;
+        }
+
+        program->Use();
+        program->Set("cameraMatrix", Camera::GetMatrix());
+        cloudVAO->Render(GL_POINTS);
+    }
+
+    auto IsVisible() -> bool {
+        return visible;
+    }
+
+    auto SetVisible(const bool _visible) -> void {
+        visible = _visible;
+    }
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+
+
+namespace EnsembleRender {
+    auto Init() -> void;
+    auto Update() -> void;
+
+    auto IsVisible() -> bool;
+    auto SetVisible(const bool visible) -> void;
+}
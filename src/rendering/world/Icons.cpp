@@ -41,8 +41,8 @@ namespace Icons {
             // Occlusion check
             for (const auto &pair : Bodies::GetMassiveBodies()) {
 
-                // Make sure we're not checking if the body occludes itself
-                if (pair.second.GetId() == body.GetId()) {
+                // Make sure we're not checking if the body occludes itself, or something that is no longer drawn
+                if ((pair.second.GetId() == body.GetId()) || Bodies::IsAbsorbed(pair.first)) {
                     continue;
                 }
 
@@ -168,14 +168,14 @@ namespace Icons {
 
         // Massive icons
         for (const auto &pair : Bodies::GetMassiveBodies()) {
-            if (ShouldMassiveBeDrawn(pair.second)) {
+            if (!Bodies::IsAbsorbed(pair.first) && ShouldMassiveBeDrawn(pair.second)) {
                 icons.insert({pair.first, pair.second});
             }
         }
 
         // Massless icons
         for (const auto &pair : Bodies::GetMasslessBodies()) {
-            if (ShouldMasslessBeDrawn(pair.second)) {
+            if (!Bodies::IsAbsorbed(pair.first) && ShouldMasslessBeDrawn(pair.second)) {
                icons.insert({pair.first, pair.second});
             }
         }
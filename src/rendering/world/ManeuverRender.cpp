@@ -0,0 +1,196 @@
+#include "ManeuverRender.h"
+
+#include <simulation/Maneuvers.h>
+#include <simulation/Simulation.h>
+#include <simulation/Trajectory.h>
+#include <input/Mouse.h>
+#include <rendering/VAO.h>
+#include <rendering/camera/Camera.h>
+#include <rendering/geometry/Rays.h>
+#include <rendering/shaders/Program.h>
+#include <util/Types.h>
+
+#include <glm/geometric.hpp>
+
+#include <array>
+#include <memory>
+#include <glad/glad.h>
+
+using std::unique_ptr;
+
+
+
+namespace ManeuverRender {
+    namespace {
+        const int STRIDE = 6;
+        const unsigned int AXIS_COUNT = 3;
+
+        // Handles keep the same size on screen at any zoom level
+        const float HANDLE_LENGTH = 0.08;
+        const float NODE_SIZE = 8;
+        const float HANDLE_END_SIZE = 6;
+
+        // In the -1 to 1 screen coordinates used by Rays::WorldToScreen
+        const float SELECT_THRESHOLD = 0.03;
+
+        // Dragging a handle across the whole width of the screen changes the delta-v by this much
+        const double DRAG_SENSITIVITY = 1000; // m/s
+
+        const vec3 NODE_COLOR = vec3(1.0, 1.0, 1.0);
+        const std::array<vec3, AXIS_COUNT> AXIS_COLORS = {
+            vec3(0.2, 1.0, 0.2),  // prograde
+            vec3(0.8, 0.3, 1.0),  // normal
+            vec3(0.3, 0.8, 1.0)}; // radial
+
+        struct Handle {
+            unsigned int node;
+            unsigned int axis;
+            vec2 screenStart;
+            vec2 screenEnd;
+        };
+
+        unique_ptr<VAO> linesVAO;
+        unique_ptr<VAO> nodesVAO;
+        unique_ptr<VAO> handleEndsVAO;
+        unique_ptr<Program> program;
+
+        // Screen positions of the handles as they were last drawn
+        vector<Handle> handles;
+        int draggedHandle = -1;
+
+        auto AddVertex(vector<VERTEX_DATA_TYPE> &vertices, const vec3 position, const vec3 color) -> void {
+            vertices.push_back(position.x);
+            vertices.push_back(position.y);
+            vertices.push_back(position.z);
+            vertices.push_back(color.r);
+            vertices.push_back(color.g);
+            vertices.push_back(color.b);
+        }
+
+        auto CreateVAO() -> unique_ptr<VAO> {
+            unique_ptr<VAO> vao = std::make_unique<VAO>();
+            vao->Init();
+            vao->AddVertexAttribute(VertexAttribute{
+                .index = 0,
+                .size = 3,
+                .type = GL_FLOAT,
+                .normalised = GL_FALSE,
+                .stride = STRIDE * sizeof(float),
+                .offset = nullptr});
+            vao->AddVertexAttribute(VertexAttribute{
+                .index = 1,
+                .size = 3,
+                .type = GL_FLOAT,
+                .normalised = GL_FALSE,
+                .stride = STRIDE * sizeof(float),
+                .offset = (void*)(3 * sizeof(float))}); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+            return vao;
+        }
+
+        auto StartDrag() -> void {
+            const vec2 mouse = Mouse::GetScreenPosition();
+            float closestDistance = SELECT_THRESHOLD;
+            for (unsigned int i = 0; i < handles.size(); i++) {
+                const float distance = glm::distance(mouse, handles.at(i).screenEnd);
+                if (distance < closestDistance) {
+                    closestDistance = distance;
+                    draggedHandle = int(i);
+                }
+            }
+        }
+
+        auto StopDrag() -> void {
+            draggedHandle = -1;
+        }
+
+        auto Drag(const vector<ManeuverNode> &nodes) -> void {
+            if ((draggedHandle == -1) || (unsigned(draggedHandle) >= handles.size())) {
+                return;
+            }
+
+            // Only movement along the handle counts, so each handle changes exactly one component
+            const Handle &handle = handles.at(draggedHandle);
+            const vec2 handleDirection = handle.screenEnd - handle.screenStart;
+            const float handleLength = glm::length(handleDirection);
+            const vec2 mouseDelta = Mouse::GetPositionDelta() * vec2(2, -2);
+            if ((handleLength == 0) || (handle.node >= nodes.size())) {
+                return;
+            }
+
+            const double amount = glm::dot(mouseDelta, handleDirection / handleLength) / 2;
+            if (amount != 0) {
+                dvec3 deltaV = nodes.at(handle.node).deltaV;
+                deltaV[int(handle.axis)] += amount * DRAG_SENSITIVITY;
+                Maneuvers::SetDeltaV(handle.node, deltaV);
+            }
+        }
+    }
+
+    auto Init() -> void {
+        Shader vertex = Shader("../resources/shaders/path-vertex.vsh", GL_VERTEX_SHADER);
+        Shader fragment = Shader("../resources/shaders/path-fragment.fsh", GL_FRAGMENT_SHADER);
+        program = std::make_unique<Program>(vertex, fragment);
+
+        linesVAO = CreateVAO();
+        nodesVAO = CreateVAO();
+        handleEndsVAO = CreateVAO();
+
+        Mouse::AddCallbackLeftPress(StartDrag);
+        Mouse::AddCallbackLeftRelease(StopDrag);
+    }
+
+    auto Update() -> void {
+        ZoneScoped;
+        const vector<ManeuverNode> nodes = Maneuvers::GetNodes();
+        Drag(nodes);
+
+        vector<VERTEX_DATA_TYPE> lineVertices;
+        vector<VERTEX_DATA_TYPE> nodeVertices;
+        vector<VERTEX_DATA_TYPE> handleEndVertices;
+        handles.clear();
+
+        for (unsigned int i = 0; i < nodes.size(); i++) {
+            // Nodes are only drawn once they are in the future and the prediction has reached them
+            const ManeuverNode &node = nodes.at(i);
+            OrbitPoint body;
+            OrbitPoint primary;
+            if ((node.time < Simulation::GetTimeStep()) || !Trajectory::Query(node.id, node.time, body) || !Trajectory::Query(node.primaryId, node.time, primary)) {
+                continue;
+            }
+
+            std::array<dvec3, AXIS_COUNT> axes;
+            Maneuvers::GetFrame(body, primary, axes.at(0), axes.at(1), axes.at(2));
+
+            const vec3 start = Rays::Scale(body.position);
+            const float length = HANDLE_LENGTH * glm::distance(Camera::GetPosition(), start);
+            AddVertex(nodeVertices, start, NODE_COLOR);
+            for (unsigned int axis = 0; axis < AXIS_COUNT; axis++) {
+                const vec3 end = start + (vec3(axes.at(axis)) * length);
+                AddVertex(lineVertices, start, AXIS_COLORS.at(axis));
+                AddVertex(lineVertices, end, AXIS_COLORS.at(axis));
+                AddVertex(handleEndVertices, end, AXIS_COLORS.at(axis));
+                handles.push_back(Handle{i, axis, Rays::WorldToScreen(start), Rays::WorldToScreen(end)});
+            }
+        }
+
+        if (nodeVertices.empty()) {
+            return;
+        }
+
+        program->Use();
+        program->Set("cameraMatrix", Camera::GetMatrix());
+        linesVAO->Data(lineVertices, lineVertices.size() / STRIDE, GL_DYNAMIC_DRAW);
+        linesVAO->Render(GL_LINES);
+        nodesVAO->Data(nodeVertices, nodeVertices.size() / STRIDE, GL_DYNAMIC_DRAW);
+        handleEndsVAO->Data(handleEndVertices, handleEndVertices.size() / STRIDE, GL_DYNAMIC_DRAW);
+        glPointSize(NODE_SIZE);
+        nodesVAO->Render(GL_POINTS);
+        glPointSize(HANDLE_END_SIZE);
+        handleEndsVAO->Render(GL_POINTS);
+        glPointSize(1);
+    }
+
+    auto IsDragging() -> bool {
+        return draggedHandle != -1;
+    }
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+
+
+namespace ManeuverRender {
+    auto Init() -> void;
+    auto Update() -> void;
+
+    // Whether a node's handle is being dragged, in which case the mouse shouldn't also rotate the camera
+    auto IsDragging() -> bool;
+}
@@ -9,6 +9,7 @@
 #include <rendering/VAO.h>
 #include <util/Types.h>
 #include <input/Mouse.h>
+#include <util/Parallel.h>
 
 #include <string>
 #include <glad/glad.h>
@@ -43,6 +44,20 @@ namespace MassiveRender {
                 .stride = STRIDE * sizeof(float),
                 .offset = (void*)(3 * sizeof(float))}); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
         }
+
+        auto AddVAO(const string &id, const vector<VERTEX_DATA_TYPE> &data) -> void {
+            // Add a corresponding VAO for the body
+            massive_vaos.insert(std::make_pair(id, VAO()));
+            VAO &vao = massive_vaos.at(id);
+            vao.Init();
+
+            // Add VAO vertex attributes
+            AddVertexAttributes(vao);
+
+            // Set VAO data
+            unsigned int vertexCount = data.size() / STRIDE;
+            vao.Data(data, vertexCount,  GL_STATIC_DRAW);
+        }
     }
 
 
@@ -75,17 +90,36 @@ namespace MassiveRender {
     }
 
     auto AddBody(const Massive &body) -> void {
-        // Add a corresponding VAO for the body
-        massive_vaos.insert(std::make_pair(body.GetId(), VAO()));
-        VAO &vao = massive_vaos.at(body.GetId());
-        vao.Init();
-
-        // Add VAO vertex attributes
-        AddVertexAttributes(vao);
-
-        // Set VAO data
-        vector<VERTEX_DATA_TYPE> data = body.GetSphereVertices();
-        unsigned int vertexCount = data.size() / STRIDE;
-        vao.Data(data, vertexCount,  GL_STATIC_DRAW);
+        AddVAO(body.GetId(), body.GenerateSphereVertices());
+    }
+
+    auto RemoveBody(const string &id) -> void {
+        massive_vaos.erase(id);
+    }
+
+    auto AddBodies(const vector<Massive> &bodies) -> void {
+        std::atomic<unsigned int> generated = 0;
+        AddBodies(bodies, GenerateMeshes(bodies, generated));
+    }
+
+    auto AddBodies(const vector<Massive> &bodies, const vector<vector<VERTEX_DATA_TYPE>> &meshes) -> void {
+        ZoneScoped;
+        // The VAOs have to be created on this thread, since it owns the OpenGL context
+        for (unsigned int i = 0; i < bodies.size(); i++) {
+            AddVAO(bodies.at(i).GetId(), meshes.at(i));
+        }
+    }
+
+    auto GenerateMeshes(const vector<Massive> &bodies, std::atomic<unsigned int> &generated) -> vector<vector<VERTEX_DATA_TYPE>> {
+        ZoneScoped;
+        // Generating the sphere meshes is pure CPU work, so it's split across worker threads
+        vector<vector<VERTEX_DATA_TYPE>> meshes(bodies.size());
+        Parallel::For(bodies.size(), [&bodies, &meshes, &generated](const unsigned int begin, const unsigned int end) {
+            for (unsigned int i = begin; i < end; i++) {
+                meshes.at(i) = bodies.at(i).GenerateSphereVertices();
+                generated++;
+            }
+        });
+        return meshes;
     }
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include <bodies/Massive.h>
 
+#include <atomic>
+
 
 
 namespace MassiveRender {
@@ -9,4 +11,10 @@ namespace MassiveRender {
     auto PreReset() -> void;
     auto Update() -> void;
     auto AddBody(const Massive &body) -> void;
+    auto RemoveBody(const string &id) -> void;
+    auto AddBodies(const vector<Massive> &bodies) -> void;
+    auto AddBodies(const vector<Massive> &bodies, const vector<vector<VERTEX_DATA_TYPE>> &meshes) -> void;
+
+    // Does not touch OpenGL, so can be called from any thread; generated is incremented as each mesh is finished
+    auto GenerateMeshes(const vector<Massive> &bodies, std::atomic<unsigned int> &generated) -> vector<vector<VERTEX_DATA_TYPE>>;
 }
\ No newline at end of file
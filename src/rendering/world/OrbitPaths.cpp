@@ -1,9 +1,11 @@
 #include "OrbitPaths.h"
 
 #include <GL/gl.h>
+#include <simulation/Events.h>
 #include <simulation/OrbitPoint.h>
 #include "rendering/VAO.h"
 #include "simulation/SimulationState.h"
+#include "simulation/PathSampler.h"
 #include "util/Constants.h"
 #include "util/Log.h"
 
@@ -18,6 +20,8 @@
 #include <util/Types.h>
 #include <main/Bodies.h>
 
+#include <algorithm>
+#include <limits>
 #include <utility>
 
 using std::unique_ptr;
@@ -29,7 +33,7 @@ namespace OrbitPaths {
     namespace {
 
         const unsigned int MAX_FUTURE_STATES = 200000;
-        const unsigned int MAX_PAST_STATES = 500;
+        const unsigned int MAX_PAST_VERTICES = 500;
 
         const int STRIDE = 6;
         const float PATH_WIDTH = 0.005;
@@ -37,37 +41,40 @@ namespace OrbitPaths {
         const float DISTANCE_THRESHOLD = 0.01;
         const float RATIO_OF_FUTURE_POINTS_TO_FADE_OVER = 0.05;
         const float PAST_POINT_BRIGHTNESS = 0.4;
+        const float PREVIEW_POINT_BRIGHTNESS = 0.5;
+
+        const unsigned int MAX_EVENT_MARKERS = 500;
+        const float EVENT_MARKER_SIZE = 6;
+        const vec3 PERIAPSIS_COLOR = vec3(1.0, 0.6, 0.0);
+        const vec3 APOAPSIS_COLOR = vec3(0.0, 0.8, 1.0);
+        const vec3 CLOSEST_APPROACH_COLOR = vec3(1.0, 0.2, 0.2);
+
+        // Each body's past and future path form a single line strip, with a vertex wherever PathSampler decided
+        // the path turned enough to need one; vertices up to the current time make up the past part
+        struct Path {
+            vector<VERTEX_DATA_TYPE> vertices;
+            vector<double> times;
+            unsigned int pastVertexCount;
+        };
 
         std::mutex threadMutex;
 
-        int pastVerticesToRemoveNextFramePerBody = 0;
-        int futureVerticesToRemoveNextFrame = 0;
-
-        unique_ptr<VAO> futurePointsVAO;
-        unique_ptr<VAO> pastPointsVAO;
+        unique_ptr<VAO> previewPointsVAO;
+        unique_ptr<VAO> pathVAO;
+        unique_ptr<VAO> eventMarkersVAO;
         unique_ptr<Program> program;
 
-        vector<VERTEX_DATA_TYPE> futureVertices;
-        unordered_map<string, vector<VERTEX_DATA_TYPE>> pastVertices;
+        unordered_map<string, Path> paths;
 
-        auto RemoveScheduledVertices() -> void {
-            ZoneScoped;
-            std::lock_guard<std::mutex> lock(threadMutex);
-            for (auto &pair : pastVertices) {
-                pair.second.erase(pair.second.begin(), pair.second.begin() + pastVerticesToRemoveNextFramePerBody*STRIDE);
-            }
-            futureVertices.erase(futureVertices.begin(), futureVertices.begin() + futureVerticesToRemoveNextFrame*STRIDE);
-        }
+        // Coarse points beyond the end of the refined future path, and the simulation time of each preview state
+        vector<VERTEX_DATA_TYPE> previewVertices;
+        vector<double> previewTimes;
+        unsigned int previewVerticesPerState = 0;
 
-        auto ScaleStateMap(vector<SimulationState> &unscaledPointMap) -> void {
-            ZoneScoped;
-            for (SimulationState &state : unscaledPointMap) {
-                state.Scale();
-            }
-        }
+        double currentTime = 0;
+        bool showEventMarkers = true;
 
         auto AddVertex(vector<VERTEX_DATA_TYPE> &vertices, const vec3 position, const vec3 color) -> void {
-            ZoneScoped;
             vertices.push_back(position.x);
             vertices.push_back(position.y);
             vertices.push_back(position.z);
@@ -76,25 +83,88 @@ namespace OrbitPaths {
             vertices.push_back(color.b);
         }
 
-        auto DrawFuturePoints(const unsigned int drawMethod) -> void {
-            ZoneNamed(prepareProgram, "Prepare Program");
+        auto CreateVAO() -> unique_ptr<VAO> {
+            unique_ptr<VAO> vao = std::make_unique<VAO>();
+            vao->Init();
+            vao->AddVertexAttribute(
+                VertexAttribute{
+                .index = 0,
+                .size = 3,
+                .type = GL_FLOAT,
+                .normalised = GL_FALSE,
+                .stride = STRIDE * sizeof(float),
+                .offset = nullptr});
+            vao->AddVertexAttribute(VertexAttribute{
+                .index = 1,
+                .size = 3,
+                .type = GL_FLOAT,
+                .normalised = GL_FALSE,
+                .stride = STRIDE * sizeof(float),
+                .offset = (void*)(3 * sizeof(float))}); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+            return vao;
+        }
+
+        auto GetEventColor(const EventType type) -> vec3 {
+            switch (type) {
+                case EVENT_TYPE_PERIAPSIS: return PERIAPSIS_COLOR;
+                case EVENT_TYPE_APOAPSIS: return APOAPSIS_COLOR;
+                case EVENT_TYPE_CLOSEST_APPROACH: return CLOSEST_APPROACH_COLOR;
+            }
+            return PATH_COLOR;
+        }
+
+        auto DrawPaths() -> void {
+            ZoneScoped;
             program->Use();
             program->Set("cameraMatrix", Camera::GetMatrix());
-            ZoneNamed(dataTransfer, "Data Transfer");
-            futurePointsVAO->Data(futureVertices, futureVertices.size() / STRIDE, GL_DYNAMIC_DRAW);
-            ZoneNamed(rendering, "Rendering");
-            futurePointsVAO->Render(drawMethod);
+
+            std::lock_guard<std::mutex> lock(threadMutex);
+            for (const auto &pair : paths) {
+                pathVAO->Data(pair.second.vertices, pair.second.vertices.size() / STRIDE, GL_DYNAMIC_DRAW);
+                pathVAO->Render(GL_LINE_STRIP);
+            }
         }
 
-        auto DrawPastPoints(const unsigned int drawMethod) -> void {
+        auto DrawPreviewPoints() -> void {
             ZoneScoped;
+            std::lock_guard<std::mutex> lock(threadMutex);
+            if (previewVertices.empty()) {
+                return;
+            }
             program->Use();
             program->Set("cameraMatrix", Camera::GetMatrix());
+            previewPointsVAO->Data(previewVertices, previewVertices.size() / STRIDE, GL_DYNAMIC_DRAW);
+            previewPointsVAO->Render(GL_POINTS);
+        }
+
+        auto DrawEventMarkers() -> void {
+            ZoneScoped;
+            if (!showEventMarkers) {
+                return;
+            }
+
+            // Events are recorded at their true positions, which the paths only approximate, but the difference
+            // is far too small to see at any zoom level where the markers could be told apart
+            vector<Event> events = Events::GetEvents(currentTime, std::numeric_limits<double>::max());
+            if (events.empty()) {
+                return;
+            }
+            if (events.size() > MAX_EVENT_MARKERS) {
+                events.resize(MAX_EVENT_MARKERS);
+            }
 
-            for (const auto &pair : pastVertices) {
-                pastPointsVAO->Data(pair.second, pair.second.size() / STRIDE, GL_DYNAMIC_DRAW);
-                pastPointsVAO->Render(drawMethod);
+            vector<VERTEX_DATA_TYPE> vertices;
+            vertices.reserve(events.size() * STRIDE);
+            for (const Event &event : events) {
+                AddVertex(vertices, Rays::Scale(event.position), GetEventColor(event.type));
             }
+
+            program->Use();
+            program->Set("cameraMatrix", Camera::GetMatrix());
+            eventMarkersVAO->Data(vertices, vertices.size() / STRIDE, GL_DYNAMIC_DRAW);
+            glPointSize(EVENT_MARKER_SIZE);
+            eventMarkersVAO->Render(GL_POINTS);
+            glPointSize(1);
         }
     }
 
@@ -104,106 +174,114 @@ namespace OrbitPaths {
         Shader fragment = Shader("../resources/shaders/path-fragment.fsh", GL_FRAGMENT_SHADER);
         program = std::make_unique<Program>(vertex, fragment);
 
-        // Create future points VAO
-        futurePointsVAO = std::make_unique<VAO>();
-        futurePointsVAO->Init();
-        futurePointsVAO->AddVertexAttribute(
-            VertexAttribute{
-            .index = 0,
-            .size = 3,
-            .type = GL_FLOAT,
-            .normalised = GL_FALSE,
-            .stride = STRIDE * sizeof(float),
-            .offset = nullptr});
-        futurePointsVAO->AddVertexAttribute(VertexAttribute{
-            .index = 1,
-            .size = 3,
-            .type = GL_FLOAT,
-            .normalised = GL_FALSE,
-            .stride = STRIDE * sizeof(float),
-            .offset = (void*)(3 * sizeof(float))}); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
-
-        // Create past points VAO
-        pastPointsVAO = std::make_unique<VAO>();
-        pastPointsVAO->Init();
-        pastPointsVAO->AddVertexAttribute(
-            VertexAttribute{
-            .index = 0,
-            .size = 3,
-            .type = GL_FLOAT,
-            .normalised = GL_FALSE,
-            .stride = STRIDE * sizeof(float),
-            .offset = nullptr});
-        pastPointsVAO->AddVertexAttribute(VertexAttribute{
-            .index = 1,
-            .size = 3,
-            .type = GL_FLOAT,
-            .normalised = GL_FALSE,
-            .stride = STRIDE * sizeof(float),
-            .offset = (void*)(3 * sizeof(float))}); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+        previewPointsVAO = CreateVAO();
+        pathVAO = CreateVAO();
+        eventMarkersVAO = CreateVAO();
     }
 
     auto NewBodyReset() -> void {
         std::lock_guard<std::mutex> lock(threadMutex);
-        futureVertices = vector<VERTEX_DATA_TYPE>();
-
-        pastVertices.clear();
+        paths.clear();
         for (const auto &pair : Bodies::GetBodies()) {
-            pastVertices.insert(std::make_pair(pair.first, vector<VERTEX_DATA_TYPE>()));
+            paths.insert(std::make_pair(pair.first, Path{}));
         }
 
-        pastVerticesToRemoveNextFramePerBody = 0;
-        futureVerticesToRemoveNextFrame = 0;
+        previewVertices = vector<VERTEX_DATA_TYPE>();
+        previewTimes.clear();
     }
 
     auto Update() -> void {
         ZoneScoped;
-        RemoveScheduledVertices();
-        futureVerticesToRemoveNextFrame = 0;
-        pastVerticesToRemoveNextFramePerBody = 0;
-        DrawFuturePoints(GL_POINTS);
-        DrawPastPoints(GL_LINE_STRIP);
+        DrawPaths();
+        DrawPreviewPoints();
+        DrawEventMarkers();
     }
 
-    auto AddNewState(const SimulationState &state) -> void {
+    auto AddVertices(const vector<PathVertex> &vertices) -> void {
         ZoneScoped;
-        // Add new state to future vertices
         std::lock_guard<std::mutex> lock(threadMutex);
-        for (const auto &pair : state.GetOrbitPoints()) {
-            AddVertex(futureVertices, Rays::Scale(pair.second.position), Bodies::GetBody(pair.first).GetColor());
+        for (const PathVertex &vertex : vertices) {
+            Path &path = paths[vertex.id];
+            AddVertex(path.vertices, vertex.position, Bodies::GetBody(vertex.id).GetColor());
+            path.times.push_back(vertex.time);
         }
     }
 
-    auto StepToNextState(const SimulationState &state) -> void {
+    auto AddPreviewState(const SimulationState &state) -> void {
         ZoneScoped;
         std::lock_guard<std::mutex> lock(threadMutex);
-        // The first vertices are now past points, so move them to the past points vector
-        bool deletePastVertex = false;
+        const unsigned int previousSize = previewVertices.size();
         for (const auto &pair : state.GetOrbitPoints()) {
-            ZoneScoped;
-            vector<VERTEX_DATA_TYPE> &pastBodyVertices = pastVertices.at(pair.first);
-            const Body &body = Bodies::GetBody(pair.first);
+            AddVertex(previewVertices, Rays::Scale(pair.second.position), Bodies::GetBody(pair.first).GetColor() * PREVIEW_POINT_BRIGHTNESS);
+        }
+        previewVerticesPerState = previewVertices.size() - previousSize;
+        previewTimes.push_back(state.GetTime());
+    }
 
-            AddVertex(
-                pastBodyVertices, 
-                Rays::Scale(pair.second.position), 
-                body.GetColor());
+    auto DiscardPreviewBefore(const double time) -> void {
+        ZoneScoped;
+        // Preview points that the refined path has caught up with are no longer needed
+        std::lock_guard<std::mutex> lock(threadMutex);
+        const auto firstKept = std::upper_bound(previewTimes.begin(), previewTimes.end(), time);
+        const unsigned int discardedStates = firstKept - previewTimes.begin();
+        if (discardedStates == 0) {
+            return;
+        }
+        previewTimes.erase(previewTimes.begin(), firstKept);
+        previewVertices.erase(previewVertices.begin(), previewVertices.begin() + (discardedStates * previewVerticesPerState));
+    }
 
-            // If there are too many vertices in the past vertex vector, remove the first element of it (tail of the path)
-            if (pastBodyVertices.size() > MAX_PAST_STATES) {
-                deletePastVertex = true;
-            }
+    auto ReplaceFuture(const string &id, const double time, const vector<PathVertex> &vertices) -> void {
+        ZoneScoped;
+        std::lock_guard<std::mutex> lock(threadMutex);
+        const auto found = paths.find(id);
+        if (found == paths.end()) {
+            return;
+        }
 
-            // Remove the first element of the future vertex map (the one we just moved to)
-            futureVerticesToRemoveNextFrame++;
+        Path &path = found->second;
+        const unsigned int firstReplaced = std::max(
+            unsigned(std::upper_bound(path.times.begin(), path.times.end(), time) - path.times.begin()),
+            path.pastVertexCount);
+        path.times.erase(path.times.begin() + firstReplaced, path.times.end());
+        path.vertices.erase(path.vertices.begin() + (firstReplaced * STRIDE), path.vertices.end());
+
+        const vec3 color = Bodies::GetBody(id).GetColor();
+        for (const PathVertex &vertex : vertices) {
+            AddVertex(path.vertices, vertex.position, color);
+            path.times.push_back(vertex.time);
         }
+    }
 
-        if (deletePastVertex) {
-            pastVerticesToRemoveNextFramePerBody++;
+    auto StepToTime(const double time) -> void {
+        ZoneScoped;
+        std::lock_guard<std::mutex> lock(threadMutex);
+        currentTime = time;
+        for (auto &pair : paths) {
+            Path &path = pair.second;
+            while ((path.pastVertexCount < path.times.size()) && (path.times.at(path.pastVertexCount) <= time)) {
+                path.pastVertexCount++;
+            }
+
+            // Remove the tail of the path once it gets too long
+            if (path.pastVertexCount > MAX_PAST_VERTICES) {
+                const unsigned int removedVertices = path.pastVertexCount - MAX_PAST_VERTICES;
+                path.vertices.erase(path.vertices.begin(), path.vertices.begin() + (removedVertices * STRIDE));
+                path.times.erase(path.times.begin(), path.times.begin() + removedVertices);
+                path.pastVertexCount = MAX_PAST_VERTICES;
+            }
         }
     }
 
     auto GetMaxFutureStates() -> unsigned int {
         return MAX_FUTURE_STATES;
     }
+
+    auto SetShowEventMarkers(const bool show) -> void {
+        showEventMarkers = show;
+    }
+
+    auto GetShowEventMarkers() -> bool {
+        return showEventMarkers;
+    }
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <simulation/PathSampler.h>
 #include <simulation/SimulationState.h>
 
 
@@ -9,8 +10,19 @@ namespace OrbitPaths {
     auto NewBodyReset() -> void;
     auto Update() -> void;
     
-    auto AddNewState(const SimulationState &state) -> void;
-    auto StepToNextState(const SimulationState &state) -> void;
+    auto AddVertices(const vector<PathVertex> &vertices) -> void;
+    auto AddPreviewState(const SimulationState &state) -> void;
+    auto DiscardPreviewBefore(const double time) -> void;
+
+    // Replaces the vertices of one body's future path after time
+    auto ReplaceFuture(const string &id, const double time, const vector<PathVertex> &vertices) -> void;
+
+    // Moves every vertex at or before time from the future part of each path to the past part
+    auto StepToTime(const double time) -> void;
 
     auto GetMaxFutureStates() -> unsigned int;
+
+    // Markers at upcoming periapses, apoapses and closest approaches
+    auto SetShowEventMarkers(const bool show) -> void;
+    auto GetShowEventMarkers() -> bool;
 }
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "BinaryScenario.h"
+
+#include <fstream>
+
+
+
+namespace BinaryScenario {
+    namespace {
+        const uint64_t ALIGNMENT = sizeof(double);
+
+        auto Align(const uint64_t size) -> uint64_t {
+            return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        }
+
+        auto GenerateStringTable(const ScenarioSnapshot &snapshot) -> string {
+            string table;
+            for (unsigned int i = 0; i < snapshot.ids.size(); i++) {
+                table += snapshot.ids.at(i);
+                table += '\0';
+                table += snapshot.names.at(i);
+                table += '\0';
+            }
+
+            // Pad so the arrays that follow are aligned to 8 bytes, which lets them be read in place from a mapped file
+            table.resize(Align(table.size()), '\0');
+            return table;
+        }
+    }
+
+    auto IsHeaderValid(const Header &header) -> bool {
+        return (header.magic == MAGIC) && (header.version == VERSION) && (header.stringTableSize % ALIGNMENT == 0);
+    }
+
+    auto GetFileSize(const Header &header) -> uint64_t {
+        return GetArrayOffset(header, SCENARIO_ARRAY_COUNT);
+    }
+
+    auto GetArrayOffset(const Header &header, const ScenarioArray array) -> uint64_t {
+        return sizeof(Header) + header.stringTableSize + (uint64_t(array) * header.bodyCount * sizeof(double));
+    }
+
+    auto ReadHeader(const string &path, Header &header) -> bool {
+        std::ifstream file(path, std::ios::binary);
+        file.read((char*)&header, sizeof(Header)); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+        return bool(file) && IsHeaderValid(header);
+    }
+
+    auto Save(const ScenarioSnapshot &snapshot, const string &path) -> bool {
+        ZoneScoped;
+        const string stringTable = GenerateStringTable(snapshot);
+
+        Header header{};
+        header.magic = MAGIC;
+        header.version = VERSION;
+        header.bodyCount = snapshot.ids.size();
+        header.time = snapshot.time;
+        header.stringTableSize = stringTable.size();
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write((const char*)&header, sizeof(Header)); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+        file.write(stringTable.data(), std::streamsize(stringTable.size()));
+        for (const vector<double> &array : snapshot.arrays) {
+            file.write((const char*)array.data(), std::streamsize(array.size() * sizeof(double))); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+        }
+        file.close();
+
+        if (!file) {
+            Log(ERROR, "Failed to write binary scenario to " + path);
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <scenarios/ScenarioSnapshot.h>
+#include <util/Types.h>
+
+#include <array>
+#include <cstdint>
+
+
+
+namespace BinaryScenario {
+
+    // File layout:
+    // - Header
+    // - String table: an id and a name for every body, each null-terminated, padded to a multiple of 8 bytes
+    // - SCENARIO_ARRAY_COUNT arrays of bodyCount doubles, in the order given by ScenarioArray
+    struct Header {
+        std::array<char, 8> magic;
+        uint32_t version;
+        uint32_t bodyCount;
+        double time;
+        uint64_t stringTableSize;
+    };
+
+    const std::array<char, 8> MAGIC = {'O', 'S', 'T', 'R', 'I', 'C', 'H', '\0'};
+    const uint32_t VERSION = 1;
+
+    auto IsHeaderValid(const Header &header) -> bool;
+    auto GetFileSize(const Header &header) -> uint64_t;
+    auto GetArrayOffset(const Header &header, const ScenarioArray array) -> uint64_t;
+
+    auto ReadHeader(const string &path, Header &header) -> bool;
+    auto Save(const ScenarioSnapshot &snapshot, const string &path) -> bool;
+}
@@ -0,0 +1,107 @@
+#include "Checkpoints.h"
+
+#include <scenarios/Scenarios.h>
+#include <scenarios/BinaryScenario.h>
+#include <main/Bodies.h>
+
+#include <chrono>
+#include <filesystem>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+
+namespace Checkpoints {
+    namespace {
+        const string CHECKPOINT_DIRECTORY = "../checkpoints/";
+        const string CHECKPOINT_PATH = CHECKPOINT_DIRECTORY + "checkpoint.osc";
+
+        const std::chrono::seconds CHECKPOINT_INTERVAL = std::chrono::seconds(60);
+
+        pid_t child = -1;
+        std::chrono::steady_clock::time_point lastCheckpoint = std::chrono::steady_clock::now();
+
+        auto WriteCheckpoint() -> void {
+            // Runs in the child; the previous checkpoint is only replaced once the new one is completely written,
+            // so a crash part way through a checkpoint never leaves us with nothing to resume from
+            if (!Scenarios::WriteScenario(Scenarios::TakeSnapshot(), CHECKPOINT_PATH, SCENARIO_FORMAT_BINARY)) {
+                _exit(1);
+            }
+            // _exit skips atexit handlers and static destructors, which belong to the parent
+            _exit(0);
+        }
+
+        auto ReapChild(const bool wait) -> void {
+            if (child == -1) {
+                return;
+            }
+
+            int status = 0;
+            const pid_t result = waitpid(child, &status, wait ? 0 : WNOHANG);
+            if (result == 0) {
+                return;
+            }
+
+            if ((result == -1) || !WIFEXITED(status) || (WEXITSTATUS(status) != 0)) {
+                Log(WARN, "Failed to write checkpoint to " + CHECKPOINT_PATH);
+            }
+            child = -1;
+        }
+
+        auto StartCheckpoint() -> void {
+            ZoneScoped;
+            std::filesystem::create_directories(CHECKPOINT_DIRECTORY);
+
+            // Must be called while the simulation update thread is joined, so the child sees a coherent state
+            // glibc makes malloc safe to use in the child even though other threads exist in the parent
+            const pid_t pid = fork();
+            if (pid == -1) {
+                Log(WARN, "Failed to fork checkpoint process");
+                return;
+            }
+
+            if (pid == 0) {
+                WriteCheckpoint();
+            }
+
+            child = pid;
+        }
+    }
+
+    auto FrameUpdate() -> void {
+        ReapChild(false);
+
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if ((child != -1) || (now - lastCheckpoint < CHECKPOINT_INTERVAL) || (Bodies::GetBodyCount() == 0)) {
+            return;
+        }
+
+        lastCheckpoint = now;
+        StartCheckpoint();
+    }
+
+    auto Shutdown() -> void {
+        // Let a checkpoint in progress finish, otherwise it would be orphaned
+        ReapChild(true);
+
+        // A clean exit has nothing to recover, so the next startup shouldn't offer to resume
+        std::filesystem::remove(CHECKPOINT_PATH);
+    }
+
+    auto CheckpointExists() -> bool {
+        return std::filesystem::exists(CHECKPOINT_PATH);
+    }
+
+    auto GetCheckpointPath() -> string {
+        return CHECKPOINT_PATH;
+    }
+
+    auto GetCheckpointTime() -> double {
+        BinaryScenario::Header header {};
+        if (!BinaryScenario::ReadHeader(CHECKPOINT_PATH, header)) {
+            return 0;
+        }
+        return header.time;
+    }
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <util/Types.h>
+
+
+
+namespace Checkpoints {
+    // Periodically writes the current scenario to a binary checkpoint from a forked child process
+    // The child works on a copy-on-write image of the process, so the render thread only pays for the fork itself
+    auto FrameUpdate() -> void;
+
+    // Waits for a checkpoint in progress, then removes the checkpoint, since it is only needed after a crash
+    auto Shutdown() -> void;
+
+    auto CheckpointExists() -> bool;
+    auto GetCheckpointPath() -> string;
+    auto GetCheckpointTime() -> double;
+}
@@ -0,0 +1,107 @@
+#include "MappedScenario.h"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+
+MappedScenario::MappedScenario(const string &path)
+    : data(nullptr), size(0), valid(false), header(nullptr) {
+        ZoneScoped;
+        const int file = open(path.c_str(), O_RDONLY); // NOLINT(cppcoreguidelines-pro-type-vararg)
+        if (file == -1) {
+            Log(ERROR, "Failed to open binary scenario at " + path);
+            return;
+        }
+
+        struct stat status {};
+        if ((fstat(file, &status) == -1) || (uint64_t(status.st_size) < sizeof(BinaryScenario::Header))) {
+            Log(ERROR, "Binary scenario at " + path + " is too small to contain a header");
+            close(file);
+            return;
+        }
+
+        size = status.st_size;
+        data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        close(file); // The mapping stays valid after the file descriptor is closed
+
+        if (data == MAP_FAILED) { // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+            Log(ERROR, "Failed to map binary scenario at " + path);
+            data = nullptr;
+            return;
+        }
+
+        // We read each array front to back exactly once
+        madvise(data, size, MADV_SEQUENTIAL);
+
+        header = (const BinaryScenario::Header*)data; // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+        if (!BinaryScenario::IsHeaderValid(*header) || (BinaryScenario::GetFileSize(*header) > size)) {
+            Log(ERROR, "Binary scenario at " + path + " has an invalid header or is truncated");
+            return;
+        }
+
+        if (!ParseStringTable()) {
+            Log(ERROR, "Binary scenario at " + path + " has a malformed string table");
+            return;
+        }
+
+        valid = true;
+}
+
+MappedScenario::~MappedScenario() {
+    if (data != nullptr) {
+        munmap(data, size);
+    }
+}
+
+auto MappedScenario::ParseStringTable() -> bool {
+    // The table is a sequence of null-terminated (id, name) pairs, so we just need to find where each string starts
+    const char* current = (const char*)data + sizeof(BinaryScenario::Header); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const char* end = current + header->stringTableSize;                       // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    ids.reserve(header->bodyCount);
+    names.reserve(header->bodyCount);
+
+    for (unsigned int i = 0; i < 2 * header->bodyCount; i++) {
+        const void* terminator = memchr(current, '\0', end - current);
+        if (terminator == nullptr) {
+            return false;
+        }
+        if (i % 2 == 0) {
+            ids.push_back(current);
+        } else {
+            names.push_back(current);
+        }
+        current = (const char*)terminator + 1; // NOLINT(cppcoreguidelines-pro-type-cstyle-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+
+    return true;
+}
+
+auto MappedScenario::IsValid() const -> bool {
+    return valid;
+}
+
+auto MappedScenario::GetBodyCount() const -> unsigned int {
+    return header->bodyCount;
+}
+
+auto MappedScenario::GetTime() const -> double {
+    return header->time;
+}
+
+auto MappedScenario::GetId(const unsigned int index) const -> string {
+    return ids.at(index);
+}
+
+auto MappedScenario::GetName(const unsigned int index) const -> string {
+    return names.at(index);
+}
+
+auto MappedScenario::GetArray(const ScenarioArray array) const -> const double* {
+    return (const double*)((const char*)data + BinaryScenario::GetArrayOffset(*header, array)); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
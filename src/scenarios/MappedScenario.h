@@ -0,0 +1,34 @@
+#pragma once
+
+#include <scenarios/BinaryScenario.h>
+#include <util/Types.h>
+
+
+
+class MappedScenario {
+private:
+    void* data;
+    uint64_t size;
+    bool valid;
+
+    const BinaryScenario::Header* header;
+    vector<const char*> ids;
+    vector<const char*> names;
+
+    auto ParseStringTable() -> bool;
+
+public:
+    // Maps a binary scenario into memory; the arrays are read straight out of the mapping rather than being copied
+    MappedScenario(const string &path);
+    ~MappedScenario();
+
+    MappedScenario(const MappedScenario&) = delete;
+    auto operator=(const MappedScenario&) -> MappedScenario& = delete;
+
+    auto IsValid() const -> bool;
+    auto GetBodyCount() const -> unsigned int;
+    auto GetTime() const -> double;
+    auto GetId(const unsigned int index) const -> string;
+    auto GetName(const unsigned int index) const -> string;
+    auto GetArray(const ScenarioArray array) const -> const double*;
+};
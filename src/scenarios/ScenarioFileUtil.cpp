@@ -6,16 +6,22 @@
 
 #include <yaml-cpp/yaml.h>
 
+#include <cstdio>
 #include <iostream>
 #include <filesystem>
 #include <fstream>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 
 
 namespace ScenarioFileUtil {
     namespace {
         const string SCENARIO_DIRECTORY = "../scenarios/";
         const string YML_SUFFIX = ".yml";
+        const string BINARY_SUFFIX = ".osc";
+        const string TEMPORARY_SUFFIX = ".tmp";
 
         const float AMBIENT = 0.1;
         const float DIFFUSE = 0.8;
@@ -23,20 +29,75 @@ namespace ScenarioFileUtil {
         const float SHINE = 32;
     }
 
+    auto GetScenarioDirectory() -> string {
+        return SCENARIO_DIRECTORY;
+    }
+
     auto GetOnlyFilename(const string &path) -> string {
-        string withoutPrefix = path.substr(SCENARIO_DIRECTORY.size(), path.size() - SCENARIO_DIRECTORY.size());
-        string withoutSuffix = withoutPrefix.substr(0, withoutPrefix.size()-4);
-        return withoutSuffix;
+        return std::filesystem::path(path).stem();
+    }
+
+    auto AddPrefixAndSuffix(const string &path, const ScenarioFormat format) -> string {
+        return SCENARIO_DIRECTORY + path + ((format == SCENARIO_FORMAT_BINARY) ? BINARY_SUFFIX : YML_SUFFIX);
+    }
+
+    auto IsScenarioPath(const string &path) -> bool {
+        const string extension = std::filesystem::path(path).extension();
+        return (extension == YML_SUFFIX) || (extension == BINARY_SUFFIX);
     }
 
-    auto AddPrefixAndSuffix(const string &path) -> string {
-        return SCENARIO_DIRECTORY + path + YML_SUFFIX;
+    auto GetFormat(const string &path) -> ScenarioFormat {
+        return (std::filesystem::path(path).extension() == BINARY_SUFFIX) ? SCENARIO_FORMAT_BINARY : SCENARIO_FORMAT_YML;
     }
 
-    auto SaveFile(const YAML::Emitter &scenario, const string &path) -> void {
+    auto GetFormatName(const ScenarioFormat format) -> string {
+        return (format == SCENARIO_FORMAT_BINARY) ? "Binary" : "YAML";
+    }
+
+    auto SaveFile(const YAML::Emitter &scenario, const string &path) -> bool {
         std::ofstream file(path);
         file << scenario.c_str();
         file.close();
+
+        if (!file) {
+            Log(ERROR, "Failed to write scenario to " + path);
+            return false;
+        }
+        return true;
+    }
+
+    auto GetTemporaryPath(const string &path) -> string {
+        // The suffix means the scenario index ignores the file until it is renamed
+        return path + TEMPORARY_SUFFIX;
+    }
+
+    auto SyncAndReplace(const string &temporaryPath, const string &path) -> bool {
+        // Flush the new file to disk before renaming it over the old one, so a crash leaves either the old or the new
+        // file intact rather than a partially written one
+        const int file = open(temporaryPath.c_str(), O_RDONLY); // NOLINT(cppcoreguidelines-pro-type-vararg)
+        if ((file == -1) || (fsync(file) == -1)) {
+            Log(ERROR, "Failed to sync " + temporaryPath);
+            if (file != -1) {
+                close(file);
+            }
+            return false;
+        }
+        close(file);
+
+        if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+            Log(ERROR, "Failed to replace " + path);
+            return false;
+        }
+
+        // The rename itself lives in the directory, which needs syncing too
+        const string directory = std::filesystem::path(path).parent_path();
+        const int directoryFile = open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY); // NOLINT(cppcoreguidelines-pro-type-vararg)
+        if (directoryFile != -1) {
+            fsync(directoryFile);
+            close(directoryFile);
+        }
+
+        return true;
     }
 
     auto GenerateMaterial(const vec3 color) -> Material {
@@ -58,7 +119,9 @@ namespace ScenarioFileUtil {
     }
 
     auto GetTime(const YAML::Node &scenario) -> int {
-        return YMLUtil::GetInt(scenario, "time");
+        // Runs on the index thread; a missing time just shows as zero in the table
+        YMLUtil::ErrorCode error = YMLUtil::NONE;
+        return int(YMLUtil::GetDouble(scenario, "time", error));
     }
 
     auto GetScenarioFile(const YAML::Node &scenario, const string &path) -> ScenarioFile {
@@ -67,33 +130,36 @@ namespace ScenarioFileUtil {
         int rawTime = GetTime(scenario);
         string formattedTime = TimeFormat::FormatTime(rawTime);
 
-        return ScenarioFile{fileName, bodyCount, rawTime, formattedTime};
+        return ScenarioFile{fileName, SCENARIO_FORMAT_YML, bodyCount, rawTime, formattedTime};
     }
 
-    auto ScenarioExists(const string &scenarioPath) -> bool {
-        for (const auto &entry : std::filesystem::directory_iterator(SCENARIO_DIRECTORY)) {
-            const string path = entry.path();
-            if (path.substr(path.size()-4, 4) != ".yml") {
-                continue;
-            }
-            if (ScenarioFileUtil::GetOnlyFilename(path) == scenarioPath) {
-                return true;
-            }
-        }
+    auto GetScenarioFile(const BinaryScenario::Header &header, const string &path) -> ScenarioFile {
+        // Binary scenarios store everything the table needs in the header, so there's no need to read the rest of the file
+        string fileName = GetOnlyFilename(path);
+        int bodyCount = int(header.bodyCount);
+        int rawTime = int(header.time);
+        string formattedTime = TimeFormat::FormatTime(rawTime);
 
-        return false;
+        return ScenarioFile{fileName, SCENARIO_FORMAT_BINARY, bodyCount, rawTime, formattedTime};
     }
 
-    auto GetScenarios() -> vector<ScenarioFile> {
-        vector<ScenarioFile> scenarios;
-        for (const auto &entry : std::filesystem::directory_iterator(SCENARIO_DIRECTORY)) {
-            const string path = entry.path();
-            if (path.substr(path.size()-4, 4) != ".yml") {
-                continue;
+    auto ReadScenarioFile(const string &path, ScenarioFile &scenarioFile) -> bool {
+        if (GetFormat(path) == SCENARIO_FORMAT_BINARY) {
+            BinaryScenario::Header header{};
+            if (!BinaryScenario::ReadHeader(path, header)) {
+                return false;
             }
-            YAML::Node scenario = YAML::LoadFile(entry.path());
-            scenarios.emplace_back(GetScenarioFile(scenario, path));
+            scenarioFile = GetScenarioFile(header, path);
+            return true;
+        }
+
+        try {
+            YAML::Node scenario = YAML::LoadFile(path);
+            scenarioFile = GetScenarioFile(scenario, path);
+        } catch (const YAML::Exception &exception) {
+            Log(WARN, "Failed to parse scenario at " + path + ": " + exception.what());
+            return false;
         }
-        return scenarios;
+        return true;
     }
 }
\ No newline at end of file
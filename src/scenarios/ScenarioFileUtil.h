@@ -1,5 +1,6 @@
 #pragma once
 
+#include <scenarios/BinaryScenario.h>
 #include <util/Types.h>
 #include <rendering/structures/Material.h>
 
@@ -7,8 +8,14 @@
 
 
 
+enum ScenarioFormat {
+    SCENARIO_FORMAT_YML,
+    SCENARIO_FORMAT_BINARY
+};
+
 struct ScenarioFile {
     string nameWithoutExtension;
+    ScenarioFormat format;
     int bodyCount;
     int rawTime;
     string formattedTime;
@@ -16,9 +23,16 @@ struct ScenarioFile {
 
 namespace ScenarioFileUtil {
 
+    auto GetScenarioDirectory() -> string;
     auto GetOnlyFilename(const string &path) -> string;
-    auto SaveFile(const YAML::Emitter &scenario, const string &path) -> void;
-    auto AddPrefixAndSuffix(const string &path) -> string;
+    auto SaveFile(const YAML::Emitter &scenario, const string &path) -> bool;
+    auto GetTemporaryPath(const string &path) -> string;
+    auto SyncAndReplace(const string &temporaryPath, const string &path) -> bool;
+    auto AddPrefixAndSuffix(const string &path, const ScenarioFormat format) -> string;
+
+    auto IsScenarioPath(const string &path) -> bool;
+    auto GetFormat(const string &path) -> ScenarioFormat;
+    auto GetFormatName(const ScenarioFormat format) -> string;
 
     auto GenerateMaterial(const vec3 color) -> Material;
 
@@ -26,7 +40,7 @@ namespace ScenarioFileUtil {
     auto GetTime(const YAML::Node &scenario) -> int;
 
     auto GetScenarioFile(const YAML::Node &scenario, const string &path) -> ScenarioFile;
-    auto ScenarioExists(const string &scenarioPath) -> bool;
-    auto GetScenarios() -> vector<ScenarioFile>;
+    auto GetScenarioFile(const BinaryScenario::Header &header, const string &path) -> ScenarioFile;
+    auto ReadScenarioFile(const string &path, ScenarioFile &scenarioFile) -> bool;
     
-}
\ No newline at end of file
+}
@@ -0,0 +1,145 @@
+#include "ScenarioIndex.h"
+
+#include <filesystem>
+#include <mutex>
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+
+
+namespace ScenarioIndex {
+    namespace {
+        // How long the watcher blocks waiting for directory events before checking whether it should stop
+        const int POLL_TIMEOUT_MILLISECONDS = 250;
+
+        // If inotify isn't available, fall back to rescanning the directory every so often
+        const int FALLBACK_RESCAN_POLLS = 8;
+
+        const unsigned int EVENT_BUFFER_SIZE = 4096;
+        const uint32_t WATCH_MASK = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+
+        struct Entry {
+            std::filesystem::file_time_type modifiedTime;
+            uintmax_t size;
+            ScenarioFile scenarioFile;
+        };
+
+        // The index is keyed by path, and an entry is only re-read if its modified time or size changes
+        // The watcher thread is the only writer; the mutex is held just long enough to swap in a new index
+        std::mutex indexMutex;
+        unordered_map<string, Entry> index;
+
+        std::atomic_bool stopWatcher = false;
+        thread watcherThread;
+
+        auto Rescan() -> void {
+            ZoneScoped;
+            // Copy the current index so files can be parsed without holding the lock
+            unordered_map<string, Entry> previousIndex;
+            {
+                std::lock_guard<std::mutex> lock(indexMutex);
+                previousIndex = index;
+            }
+
+            unordered_map<string, Entry> scannedIndex;
+            std::error_code error;
+            for (const auto &directoryEntry : std::filesystem::directory_iterator(ScenarioFileUtil::GetScenarioDirectory(), error)) {
+                const string path = directoryEntry.path();
+                if (!ScenarioFileUtil::IsScenarioPath(path)) {
+                    continue;
+                }
+
+                const std::filesystem::file_time_type modifiedTime = directoryEntry.last_write_time(error);
+                const uintmax_t size = directoryEntry.file_size(error);
+                if (error) {
+                    continue;
+                }
+
+                // Reuse the cached metadata if the file hasn't changed since we last read it
+                auto existing = previousIndex.find(path);
+                if ((existing != previousIndex.end()) && (existing->second.modifiedTime == modifiedTime) && (existing->second.size == size)) {
+                    scannedIndex.insert(*existing);
+                    continue;
+                }
+
+                ScenarioFile scenarioFile;
+                if (ScenarioFileUtil::ReadScenarioFile(path, scenarioFile)) {
+                    scannedIndex.insert(std::make_pair(path, Entry{modifiedTime, size, scenarioFile}));
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(indexMutex);
+            index = std::move(scannedIndex);
+        }
+
+        auto DrainEvents(const int inotify) -> bool {
+            // We don't care which file changed, only that something did; a rescan is cheap since unchanged files are skipped
+            std::array<char, EVENT_BUFFER_SIZE> buffer {};
+            bool changed = false;
+            while (read(inotify, buffer.data(), buffer.size()) > 0) {
+                changed = true;
+            }
+            return changed;
+        }
+
+        auto Watch() -> void {
+            Rescan();
+
+            const int inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            const bool watching = (inotify != -1) && (inotify_add_watch(inotify, ScenarioFileUtil::GetScenarioDirectory().c_str(), WATCH_MASK) != -1);
+            if (!watching) {
+                Log(WARN, "Could not watch the scenario directory, falling back to periodic rescans");
+            }
+
+            int pollsSinceRescan = 0;
+            while (!stopWatcher) {
+                if (!watching) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(POLL_TIMEOUT_MILLISECONDS));
+                    if (++pollsSinceRescan >= FALLBACK_RESCAN_POLLS) {
+                        pollsSinceRescan = 0;
+                        Rescan();
+                    }
+                    continue;
+                }
+
+                pollfd descriptor{inotify, POLLIN, 0};
+                if ((poll(&descriptor, 1, POLL_TIMEOUT_MILLISECONDS) > 0) && DrainEvents(inotify)) {
+                    Rescan();
+                }
+            }
+
+            if (inotify != -1) {
+                close(inotify);
+            }
+        }
+    }
+
+    auto Init() -> void {
+        stopWatcher = false;
+        watcherThread = thread(Watch);
+    }
+
+    auto Shutdown() -> void {
+        stopWatcher = true;
+        if (watcherThread.joinable()) {
+            watcherThread.join();
+        }
+    }
+
+    auto GetScenarios() -> vector<ScenarioFile> {
+        std::lock_guard<std::mutex> lock(indexMutex);
+        vector<ScenarioFile> scenarios;
+        scenarios.reserve(index.size());
+        for (const auto &pair : index) {
+            scenarios.push_back(pair.second.scenarioFile);
+        }
+        return scenarios;
+    }
+
+    auto ScenarioExists(const string &filenameWithoutExtension, const ScenarioFormat format) -> bool {
+        std::lock_guard<std::mutex> lock(indexMutex);
+        return index.find(ScenarioFileUtil::AddPrefixAndSuffix(filenameWithoutExtension, format)) != index.end();
+    }
+}
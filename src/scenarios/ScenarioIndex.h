@@ -0,0 +1,14 @@
+#pragma once
+
+#include <scenarios/ScenarioFileUtil.h>
+#include <util/Types.h>
+
+
+
+namespace ScenarioIndex {
+    auto Init() -> void;
+    auto Shutdown() -> void;
+
+    auto GetScenarios() -> vector<ScenarioFile>;
+    auto ScenarioExists(const string &filenameWithoutExtension, const ScenarioFormat format) -> bool;
+}
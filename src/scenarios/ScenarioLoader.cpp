@@ -0,0 +1,141 @@
+#include "ScenarioLoader.h"
+
+#include <scenarios/Scenarios.h>
+#include <scenarios/YMLUtil.h>
+#include <simulation/Simulation.h>
+#include <rendering/world/MassiveRender.h>
+#include <main/Bodies.h>
+#include <main/Control.h>
+#include <util/Constants.h>
+
+#include <atomic>
+
+
+
+namespace ScenarioLoader {
+    namespace {
+        // Reading the file and generating meshes take roughly the same time, so they get half the progress bar each
+        const float READ_PROGRESS = 0.5;
+
+        struct LoadedScenario {
+            ScenarioSnapshot snapshot;
+            vector<Massive> massiveBodies;
+            vector<Massless> masslessBodies;
+            vector<vector<VERTEX_DATA_TYPE>> meshes;
+            YMLUtil::ErrorCode error;
+        };
+
+        thread worker;
+        std::atomic_bool finished = false;
+        std::atomic<float> progress = 0;
+        std::atomic<unsigned int> meshesGenerated = 0;
+
+        LoadedScenario loaded;
+        bool loadedAnyScenario = false;
+
+        auto CreateBodies() -> void {
+            const ScenarioSnapshot &snapshot = loaded.snapshot;
+            const auto &arrays = snapshot.arrays;
+            for (unsigned int i = 0; i < snapshot.ids.size(); i++) {
+                const vec3 color = vec3(arrays[SCENARIO_ARRAY_COLOR_R].at(i), arrays[SCENARIO_ARRAY_COLOR_G].at(i), arrays[SCENARIO_ARRAY_COLOR_B].at(i));
+                const dvec3 position = dvec3(arrays[SCENARIO_ARRAY_POSITION_X].at(i), arrays[SCENARIO_ARRAY_POSITION_Y].at(i), arrays[SCENARIO_ARRAY_POSITION_Z].at(i));
+                const dvec3 velocity = dvec3(arrays[SCENARIO_ARRAY_VELOCITY_X].at(i), arrays[SCENARIO_ARRAY_VELOCITY_Y].at(i), arrays[SCENARIO_ARRAY_VELOCITY_Z].at(i));
+                const double mass = arrays[SCENARIO_ARRAY_MASS].at(i);
+                const double radius = arrays[SCENARIO_ARRAY_RADIUS].at(i);
+
+                if (mass > MASS_THRESHOLD) {
+                    const Material material = ScenarioFileUtil::GenerateMaterial(color);
+                    loaded.massiveBodies.emplace_back(snapshot.ids.at(i), snapshot.names.at(i), color, position, velocity, mass, radius, material);
+                } else {
+                    loaded.masslessBodies.emplace_back(snapshot.ids.at(i), snapshot.names.at(i), color, position, velocity, mass, radius);
+                }
+            }
+        }
+
+        auto Load(const string &path, const ScenarioFormat format) -> void {
+            ZoneScoped;
+            loaded.error = Scenarios::ReadScenario(path, format, loaded.snapshot);
+            if (loaded.error == YMLUtil::NONE) {
+                CreateBodies();
+                progress = READ_PROGRESS;
+                loaded.meshes = MassiveRender::GenerateMeshes(loaded.massiveBodies, meshesGenerated);
+            }
+            progress = 1;
+            finished = true;
+        }
+
+        auto SwapIn() -> void {
+            // Everything expensive has already been done, so this is just handing the new bodies over
+            ZoneScoped;
+            Control::PreReset();
+            Simulation::SetTimeStep(loaded.snapshot.time);
+
+            // Add bodies in the same order as the file, so that body ids keep their order
+            unsigned int massive = 0;
+            unsigned int massless = 0;
+            Bodies::BeginBulkLoad();
+            for (const string &id : loaded.snapshot.ids) {
+                if ((massive < loaded.massiveBodies.size()) && (loaded.massiveBodies.at(massive).GetId() == id)) {
+                    Bodies::AddBody(loaded.massiveBodies.at(massive));
+                    massive++;
+                } else {
+                    Bodies::AddBody(loaded.masslessBodies.at(massless));
+                    massless++;
+                }
+            }
+            Bodies::CommitBulkLoad(loaded.meshes);
+
+            Control::PostReset();
+            loadedAnyScenario = true;
+        }
+    }
+
+    auto Start(const string &path, const ScenarioFormat format) -> void {
+        if (IsLoading()) {
+            Log(WARN, "Ignoring request to load " + path + " while another scenario is loading");
+            return;
+        }
+
+        loaded = LoadedScenario();
+        finished = false;
+        progress = 0;
+        meshesGenerated = 0;
+        worker = thread(Load, path, format);
+    }
+
+    auto FrameUpdate() -> void {
+        if (!worker.joinable() || !finished) {
+            return;
+        }
+
+        worker.join();
+        if (loaded.error != YMLUtil::NONE) {
+            YMLUtil::SetCurrentError(loaded.error);
+        } else {
+            SwapIn();
+        }
+        loaded = LoadedScenario();
+    }
+
+    auto Shutdown() -> void {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    auto IsLoading() -> bool {
+        return worker.joinable();
+    }
+
+    auto GetProgress() -> float {
+        // Mesh generation reports its own progress, so the second half of the bar moves smoothly
+        if ((progress >= READ_PROGRESS) && (progress < 1) && !loaded.massiveBodies.empty()) {
+            return READ_PROGRESS + ((1 - READ_PROGRESS) * float(meshesGenerated) / float(loaded.massiveBodies.size()));
+        }
+        return progress;
+    }
+
+    auto HasLoadedScenario() -> bool {
+        return loadedAnyScenario;
+    }
+}
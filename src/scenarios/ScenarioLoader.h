@@ -0,0 +1,18 @@
+#pragma once
+
+#include <scenarios/ScenarioFileUtil.h>
+#include <util/Types.h>
+
+
+
+namespace ScenarioLoader {
+    // Reads a scenario and builds its bodies and meshes on a background thread while the current scenario keeps running
+    // FrameUpdate swaps the new scenario in between frames once it is ready
+    auto Start(const string &path, const ScenarioFormat format) -> void;
+    auto FrameUpdate() -> void;
+    auto Shutdown() -> void;
+
+    auto IsLoading() -> bool;
+    auto GetProgress() -> float;
+    auto HasLoadedScenario() -> bool;
+}
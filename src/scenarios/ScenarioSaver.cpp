@@ -0,0 +1,91 @@
+#include "ScenarioSaver.h"
+
+#include <scenarios/Scenarios.h>
+
+#include <condition_variable>
+#include <mutex>
+
+
+
+namespace ScenarioSaver {
+    namespace {
+        struct SaveRequest {
+            ScenarioSnapshot snapshot;
+            string path;
+            ScenarioFormat format;
+        };
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        queue<SaveRequest> requests;
+        bool stopWorker = false;
+        thread worker;
+
+        SaveStatus status = SAVE_STATUS_IDLE;
+        string statusPath;
+
+        auto WorkerLoop() -> void {
+            while (true) {
+                SaveRequest request;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    condition.wait(lock, []{ return stopWorker || !requests.empty(); });
+                    if (requests.empty()) {
+                        return;
+                    }
+                    request = std::move(requests.front());
+                    requests.pop();
+                    status = SAVE_STATUS_SAVING;
+                    statusPath = request.path;
+                }
+
+                const bool saved = Scenarios::WriteScenario(request.snapshot, request.path, request.format);
+
+                // A later request may already be waiting, in which case it decides the status
+                std::lock_guard<std::mutex> lock(mutex);
+                if (requests.empty()) {
+                    status = saved ? SAVE_STATUS_SAVED : SAVE_STATUS_FAILED;
+                }
+                if (!saved) {
+                    Log(ERROR, "Failed to save scenario to " + request.path);
+                }
+            }
+        }
+    }
+
+    auto Save(ScenarioSnapshot snapshot, const string &path, const ScenarioFormat format) -> void {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!worker.joinable()) {
+                stopWorker = false;
+                worker = thread(WorkerLoop);
+            }
+            requests.push(SaveRequest{std::move(snapshot), path, format});
+            status = SAVE_STATUS_SAVING;
+            statusPath = path;
+        }
+        condition.notify_one();
+    }
+
+    auto Shutdown() -> void {
+        // Any queued saves are still written, so closing the window straight after saving does not lose the save
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopWorker = true;
+        }
+        condition.notify_one();
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    auto GetStatus() -> SaveStatus {
+        std::lock_guard<std::mutex> lock(mutex);
+        return status;
+    }
+
+    auto GetStatusPath() -> string {
+        std::lock_guard<std::mutex> lock(mutex);
+        return statusPath;
+    }
+}
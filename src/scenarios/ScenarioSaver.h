@@ -0,0 +1,23 @@
+#pragma once
+
+#include <scenarios/ScenarioFileUtil.h>
+#include <scenarios/ScenarioSnapshot.h>
+#include <util/Types.h>
+
+
+
+enum SaveStatus {
+    SAVE_STATUS_IDLE,
+    SAVE_STATUS_SAVING,
+    SAVE_STATUS_SAVED,
+    SAVE_STATUS_FAILED
+};
+
+namespace ScenarioSaver {
+    // Serializes and writes snapshots on a background I/O thread, in the order they were queued
+    auto Save(ScenarioSnapshot snapshot, const string &path, const ScenarioFormat format) -> void;
+    auto Shutdown() -> void;
+
+    auto GetStatus() -> SaveStatus;
+    auto GetStatusPath() -> string;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <util/Types.h>
+
+#include <array>
+
+
+
+// Per-body arrays stored in a scenario snapshot
+// This is also the order the arrays are laid out in a binary scenario, so new entries must only ever be appended
+enum ScenarioArray {
+    SCENARIO_ARRAY_MASS,
+    SCENARIO_ARRAY_RADIUS,
+    SCENARIO_ARRAY_COLOR_R,
+    SCENARIO_ARRAY_COLOR_G,
+    SCENARIO_ARRAY_COLOR_B,
+    SCENARIO_ARRAY_POSITION_X,
+    SCENARIO_ARRAY_POSITION_Y,
+    SCENARIO_ARRAY_POSITION_Z,
+    SCENARIO_ARRAY_VELOCITY_X,
+    SCENARIO_ARRAY_VELOCITY_Y,
+    SCENARIO_ARRAY_VELOCITY_Z,
+    SCENARIO_ARRAY_COUNT
+};
+
+struct ScenarioSnapshot {
+    double time;
+    vector<string> ids;
+    vector<string> names;
+    std::array<vector<double>, SCENARIO_ARRAY_COUNT> arrays;
+};
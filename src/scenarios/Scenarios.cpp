@@ -2,10 +2,13 @@
 
 #include <scenarios/YMLUtil.h>
 #include <scenarios/ScenarioFileUtil.h>
+#include <scenarios/BinaryScenario.h>
+#include <scenarios/MappedScenario.h>
+#include <scenarios/ScenarioSaver.h>
+#include <scenarios/ScenarioLoader.h>
 #include <bodies/Massive.h>
 #include <simulation/Simulation.h>
 #include <rendering/shaders/Util.h>
-#include <main/Control.h>
 #include <util/Log.h>
 #include <main/Bodies.h>
 #include <rendering/interface/TopRightWindow/SimulationData.h>
@@ -15,6 +18,7 @@
 #include <string>
 #include <chrono>
 #include <filesystem>
+#include <limits>
 
 
 
@@ -22,118 +26,211 @@ namespace Scenarios {
 
     namespace {
 
-        const double MASS_THRESHOLD = 100000; // Bodies above this mass (in kg) will be considered Massive
-        
-        string scenarioToLoadNextFrame = "";
+        string scenarioToLoadNextFrame = ""; // Full path to the scenario file
+        ScenarioFormat scenarioToLoadNextFrameFormat = SCENARIO_FORMAT_YML;
 
         auto ScenarioContainsRequiredKeys(const YAML::Node &scenario) -> bool {
             return scenario["time"]  && scenario["bodies"];
         }
 
-        auto LoadBody(const string &id, const YAML::Node &node) -> void {
-            string name =   YMLUtil::GetString(node, "name");
-            vec3 color =    YMLUtil::GetVec3  (node, "color");
-            double radius = YMLUtil::GetDouble(node, "radius");
-            double mass =   YMLUtil::GetDouble(node, "mass");
-            vec3 position = YMLUtil::GetVec3  (node, "position");
-            vec3 velocity = YMLUtil::GetVec3  (node, "velocity");
-            if (mass > MASS_THRESHOLD) {
-                Material material = ScenarioFileUtil::GenerateMaterial(color);
-                Bodies::AddBody(Massive(id, name, color, position, velocity, mass, radius, material));
-            } else {
-                Bodies::AddBody(Massless(id, name, color, position, velocity, mass, radius));
-            }
+        auto ReadBody(const string &id, const YAML::Node &node, ScenarioSnapshot &snapshot, YMLUtil::ErrorCode &error) -> void {
+            const vec3 color =     YMLUtil::GetVec3 (node, "color", error);
+            const dvec3 position = YMLUtil::GetDVec3(node, "position", error);
+            const dvec3 velocity = YMLUtil::GetDVec3(node, "velocity", error);
+            snapshot.ids.push_back(id);
+            snapshot.names.push_back(YMLUtil::GetString(node, "name", error));
+            snapshot.arrays[SCENARIO_ARRAY_MASS].push_back(YMLUtil::GetDouble(node, "mass", error));
+            snapshot.arrays[SCENARIO_ARRAY_RADIUS].push_back(YMLUtil::GetDouble(node, "radius", error));
+            snapshot.arrays[SCENARIO_ARRAY_COLOR_R].push_back(color.r);
+            snapshot.arrays[SCENARIO_ARRAY_COLOR_G].push_back(color.g);
+            snapshot.arrays[SCENARIO_ARRAY_COLOR_B].push_back(color.b);
+            snapshot.arrays[SCENARIO_ARRAY_POSITION_X].push_back(position.x);
+            snapshot.arrays[SCENARIO_ARRAY_POSITION_Y].push_back(position.y);
+            snapshot.arrays[SCENARIO_ARRAY_POSITION_Z].push_back(position.z);
+            snapshot.arrays[SCENARIO_ARRAY_VELOCITY_X].push_back(velocity.x);
+            snapshot.arrays[SCENARIO_ARRAY_VELOCITY_Y].push_back(velocity.y);
+            snapshot.arrays[SCENARIO_ARRAY_VELOCITY_Z].push_back(velocity.z);
         }
 
-        auto LoadBodies(const YAML::Node &scenario) -> void {
+        auto ReadYmlScenario(const string &path, ScenarioSnapshot &snapshot) -> YMLUtil::ErrorCode {
+            YAML::Node scenario;
+            try {
+                scenario = YAML::LoadFile(path);
+            } catch (const YAML::Exception &exception) {
+                Log(ERROR, "Failed to parse scenario " + path + ": " + exception.what());
+                return YMLUtil::INCORRECT_TYPE;
+            }
+
+            if (!ScenarioContainsRequiredKeys(scenario)) { 
+                return YMLUtil::MISSING_BASE_KEY;
+            }
+
+            // Errors are collected here rather than in YMLUtil's current error, since this runs on the loader thread
+            YMLUtil::ErrorCode error = YMLUtil::NONE;
+            snapshot.time = YMLUtil::GetDouble(scenario, "time", error);
+
             YAML::Node bodies = scenario["bodies"];
             for (YAML::const_iterator i = bodies.begin(); i != bodies.end(); i++) {
-                auto id = i->first.as<string>();
-                YAML::Node node = i->second;
-                LoadBody(id, node);
+                ReadBody(i->first.as<string>(), i->second, snapshot, error);
             }
-        }
-        
-        auto LoadTime(const YAML::Node &scenario) -> void {
-            int time = YMLUtil::GetInt(scenario, "time");
-            Simulation::SetTimeStep(time);
+
+            if (error != YMLUtil::NONE) {
+                Log(ERROR, "Scenario " + path + " has a body with missing or malformed keys");
+            }
+            return error;
         }
 
-        auto SaveBody(const string &id, YAML::Emitter &scenario, const Body &body) -> void {
-            scenario << id;
+        auto SaveBody(const ScenarioSnapshot &snapshot, const unsigned int i, YAML::Emitter &scenario) -> void {
+            const auto &arrays = snapshot.arrays;
+            scenario << snapshot.ids.at(i);
             scenario << YAML::BeginMap;
-            YMLUtil::SetString(scenario, "name", body.GetName());
-            YMLUtil::SetVec3(scenario, "color", body.GetColor());
-            YMLUtil::SetDouble(scenario, "radius", body.GetRadius());
-            YMLUtil::SetDouble(scenario, "mass", body.GetMass());
-            YMLUtil::SetVec3(scenario, "position", body.GetPosition());
-            YMLUtil::SetVec3(scenario, "velocity", body.GetVelocity());
+            YMLUtil::SetString(scenario, "name", snapshot.names.at(i));
+            YMLUtil::SetVec3(scenario, "color", vec3(arrays[SCENARIO_ARRAY_COLOR_R].at(i), arrays[SCENARIO_ARRAY_COLOR_G].at(i), arrays[SCENARIO_ARRAY_COLOR_B].at(i)));
+            YMLUtil::SetDouble(scenario, "radius", arrays[SCENARIO_ARRAY_RADIUS].at(i));
+            YMLUtil::SetDouble(scenario, "mass", arrays[SCENARIO_ARRAY_MASS].at(i));
+            YMLUtil::SetDVec3(scenario, "position", dvec3(arrays[SCENARIO_ARRAY_POSITION_X].at(i), arrays[SCENARIO_ARRAY_POSITION_Y].at(i), arrays[SCENARIO_ARRAY_POSITION_Z].at(i)));
+            YMLUtil::SetDVec3(scenario, "velocity", dvec3(arrays[SCENARIO_ARRAY_VELOCITY_X].at(i), arrays[SCENARIO_ARRAY_VELOCITY_Y].at(i), arrays[SCENARIO_ARRAY_VELOCITY_Z].at(i)));
             scenario << YAML::EndMap;
         }
 
-        auto SaveBodies(YAML::Emitter &scenario) -> void {
+        auto SaveBodies(const ScenarioSnapshot &snapshot, YAML::Emitter &scenario) -> void {
             scenario << YAML::Key << "bodies";
             scenario << YAML::Value << YAML::BeginMap;
-            for (const auto &pair : Bodies::GetBodies()) {
-                string id = pair.first;
-                Body body = pair.second;
-                SaveBody(id, scenario, body);
+            for (unsigned int i = 0; i < snapshot.ids.size(); i++) {
+                SaveBody(snapshot, i, scenario);
             }
             scenario << YAML::EndMap;
         }
 
-        auto SaveTime(YAML::Emitter &scenario) -> void {
+        auto SaveTime(const ScenarioSnapshot &snapshot, YAML::Emitter &scenario) -> void {
             scenario << YAML::Key << "time";
-            scenario << YAML::Value << int(Simulation::GetTimeStep());
+            scenario << YAML::Value << snapshot.time;
+        }
+
+        auto SaveYmlScenario(const ScenarioSnapshot &snapshot, const string &path) -> bool {
+            YAML::Emitter scenario;
+
+            // Emit enough digits that every double reads back as exactly the same value
+            scenario.SetDoublePrecision(std::numeric_limits<double>::max_digits10);
+
+            scenario << YAML::BeginMap;
+
+            SaveTime(snapshot, scenario);
+            SaveBodies(snapshot, scenario);
+
+            scenario << YAML::EndMap;
+
+            return ScenarioFileUtil::SaveFile(scenario, path);
         }
 
-        auto LoadScheduledScenario() -> void {
-            const string path = ScenarioFileUtil::AddPrefixAndSuffix(scenarioToLoadNextFrame);
+        auto ReadBinaryScenario(const string &path, ScenarioSnapshot &snapshot) -> YMLUtil::ErrorCode {
+            MappedScenario scenario(path);
 
-            if (!FileExists(path)) {
-                YMLUtil::SetCurrentError(YMLUtil::FILE_NOT_FOUND);
-                return;
+            if (!scenario.IsValid()) {
+                return YMLUtil::INCORRECT_TYPE;
             }
 
-            YAML::Node scenario = YAML::LoadFile(path);
+            const unsigned int bodyCount = scenario.GetBodyCount();
+            snapshot.time = scenario.GetTime();
+            snapshot.ids.reserve(bodyCount);
+            snapshot.names.reserve(bodyCount);
+            for (unsigned int i = 0; i < bodyCount; i++) {
+                snapshot.ids.push_back(scenario.GetId(i));
+                snapshot.names.push_back(scenario.GetName(i));
+            }
 
-            if (!ScenarioContainsRequiredKeys(scenario)) { 
-                YMLUtil::SetCurrentError(YMLUtil::MISSING_BASE_KEY);
-                return; 
+            // Each array is one straight copy out of the mapping
+            for (unsigned int array = 0; array < SCENARIO_ARRAY_COUNT; array++) {
+                const double* values = scenario.GetArray(ScenarioArray(array));
+                snapshot.arrays.at(array).assign(values, values + bodyCount); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
             }
 
-            Control::PreReset();
+            return YMLUtil::NONE;
+        }
+    }
 
-            LoadTime(scenario);
-            LoadBodies(scenario);
+    auto ReadScenario(const string &path, const ScenarioFormat format, ScenarioSnapshot &snapshot) -> YMLUtil::ErrorCode {
+        // Safe to call from any thread, since it only touches the snapshot
+        ZoneScoped;
+        if (!FileExists(path)) {
+            return YMLUtil::FILE_NOT_FOUND;
+        }
 
-            Control::PostReset();
+        if (format == SCENARIO_FORMAT_BINARY) {
+            return ReadBinaryScenario(path, snapshot);
         }
+
+        return ReadYmlScenario(path, snapshot);
     }
 
     auto FrameUpdate() -> void {
         if (scenarioToLoadNextFrame != "") {
-            LoadScheduledScenario();
+            ScenarioLoader::Start(scenarioToLoadNextFrame, scenarioToLoadNextFrameFormat);
             scenarioToLoadNextFrame = "";
         }
+        ScenarioLoader::FrameUpdate();
     }
 
-    auto ScheduleLoadScenario(const string &filenameWithoutExtension) -> void {
-        scenarioToLoadNextFrame = filenameWithoutExtension;
+    auto ScheduleLoadScenario(const string &filenameWithoutExtension, const ScenarioFormat format) -> void {
+        ScheduleLoadScenarioFromPath(ScenarioFileUtil::AddPrefixAndSuffix(filenameWithoutExtension, format), format);
     }
 
-    auto SaveScenario(const string &filenameWithoutExtension) -> void {
-        const string path = ScenarioFileUtil::AddPrefixAndSuffix(filenameWithoutExtension);
+    auto ScheduleLoadScenarioFromPath(const string &path, const ScenarioFormat format) -> void {
+        scenarioToLoadNextFrame = path;
+        scenarioToLoadNextFrameFormat = format;
+    }
 
-        YAML::Emitter scenario;
+    auto TakeSnapshot() -> ScenarioSnapshot {
+        ZoneScoped;
+        ScenarioSnapshot snapshot;
+        snapshot.time = Simulation::GetTimeStep();
 
-        scenario << YAML::BeginMap;
+        const vector<string> &ids = Bodies::GetBodyIds();
+        snapshot.ids.reserve(ids.size());
+        snapshot.names.reserve(ids.size());
+        for (vector<double> &array : snapshot.arrays) {
+            array.reserve(ids.size());
+        }
+
+        for (const string &id : ids) {
+            // Bodies absorbed in a merge have no mass and sit on the body they merged into, so they aren't saved
+            if (Bodies::IsAbsorbed(id)) {
+                continue;
+            }
+            const Body &body = Bodies::GetBody(id);
+            snapshot.ids.push_back(id);
+            snapshot.names.push_back(body.GetName());
+            snapshot.arrays[SCENARIO_ARRAY_MASS].push_back(body.GetMass());
+            snapshot.arrays[SCENARIO_ARRAY_RADIUS].push_back(body.GetRadius());
+            snapshot.arrays[SCENARIO_ARRAY_COLOR_R].push_back(body.GetColor().r);
+            snapshot.arrays[SCENARIO_ARRAY_COLOR_G].push_back(body.GetColor().g);
+            snapshot.arrays[SCENARIO_ARRAY_COLOR_B].push_back(body.GetColor().b);
+            snapshot.arrays[SCENARIO_ARRAY_POSITION_X].push_back(body.GetPosition().x);
+            snapshot.arrays[SCENARIO_ARRAY_POSITION_Y].push_back(body.GetPosition().y);
+            snapshot.arrays[SCENARIO_ARRAY_POSITION_Z].push_back(body.GetPosition().z);
+            snapshot.arrays[SCENARIO_ARRAY_VELOCITY_X].push_back(body.GetVelocity().x);
+            snapshot.arrays[SCENARIO_ARRAY_VELOCITY_Y].push_back(body.GetVelocity().y);
+            snapshot.arrays[SCENARIO_ARRAY_VELOCITY_Z].push_back(body.GetVelocity().z);
+        }
 
-        SaveTime(scenario);
-        SaveBodies(scenario);
+        return snapshot;
+    }
+
+    auto WriteScenario(const ScenarioSnapshot &snapshot, const string &path, const ScenarioFormat format) -> bool {
+        // Safe to call from any thread, since it only touches the snapshot
+        ZoneScoped;
+        const string temporaryPath = ScenarioFileUtil::GetTemporaryPath(path);
 
-        scenario << YAML::EndMap;
+        const bool written = (format == SCENARIO_FORMAT_BINARY)
+            ? BinaryScenario::Save(snapshot, temporaryPath)
+            : SaveYmlScenario(snapshot, temporaryPath);
+
+        return written && ScenarioFileUtil::SyncAndReplace(temporaryPath, path);
+    }
 
-        ScenarioFileUtil::SaveFile(scenario, path);
+    auto SaveScenario(const string &filenameWithoutExtension, const ScenarioFormat format) -> void {
+        // Copying the bodies into a snapshot is cheap; serializing and writing it happens on the save worker
+        const string path = ScenarioFileUtil::AddPrefixAndSuffix(filenameWithoutExtension, format);
+        ScenarioSaver::Save(TakeSnapshot(), path, format);
     }
 }
\ No newline at end of file
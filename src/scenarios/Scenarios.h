@@ -2,12 +2,18 @@
 
 #include <util/Types.h>
 #include <scenarios/ScenarioFileUtil.h>
+#include <scenarios/ScenarioSnapshot.h>
+#include <scenarios/YMLUtil.h>
 
 
 
 
 namespace Scenarios {
-    auto SaveScenario(const string &filenameWithoutExtension) -> void;
+    auto TakeSnapshot() -> ScenarioSnapshot;
+    auto ReadScenario(const string &path, const ScenarioFormat format, ScenarioSnapshot &snapshot) -> YMLUtil::ErrorCode;
+    auto WriteScenario(const ScenarioSnapshot &snapshot, const string &path, const ScenarioFormat format) -> bool;
+    auto SaveScenario(const string &filenameWithoutExtension, const ScenarioFormat format) -> void;
     auto FrameUpdate() -> void;
-    auto ScheduleLoadScenario(const string &filenameWithoutExtension) -> void;
+    auto ScheduleLoadScenario(const string &filenameWithoutExtension, const ScenarioFormat format) -> void;
+    auto ScheduleLoadScenarioFromPath(const string &path, const ScenarioFormat format) -> void;
 }
\ No newline at end of file
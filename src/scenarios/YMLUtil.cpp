@@ -17,47 +17,47 @@ namespace YMLUtil {
         return currentError;
     }
 
-    auto CheckKeyExists(const YAML::Node &node, const string &path) -> bool {
+    auto CheckKeyExists(const YAML::Node &node, const string &path, ErrorCode &error) -> bool {
         if (!node[path]) {
-            currentError = MISSING_KEY;
+            error = MISSING_KEY;
             return false;
         }
         return true;
     }
 
-    auto GetString(const YAML::Node &node, const string &path) -> string {
+    auto GetString(const YAML::Node &node, const string &path, ErrorCode &error) -> string {
         if (!node[path]) {
-            currentError = MISSING_KEY;
+            error = MISSING_KEY;
             return "";
         }
         return node[path].as<string>();
     }
 
-    auto GetInt(const YAML::Node &node, const string &path) -> int {
+    auto GetInt(const YAML::Node &node, const string &path, ErrorCode &error) -> int {
         if (!node[path]) {
-            currentError = MISSING_KEY;
+            error = MISSING_KEY;
             return 0;
         }
         return node[path].as<int>();
     }
 
-    auto GetDouble(const YAML::Node &node, const string &path) -> double {
+    auto GetDouble(const YAML::Node &node, const string &path, ErrorCode &error) -> double {
         if (!node[path]) {
-            currentError = MISSING_KEY;
+            error = MISSING_KEY;
             return 0.0;
         }
 
         return node[path].as<double>();
     }
 
-    auto GetVec3(const YAML::Node &node, const string &path) -> vec3 {
+    auto GetVec3(const YAML::Node &node, const string &path, ErrorCode &error) -> vec3 {
         if (!node[path]) {
-            currentError = MISSING_KEY;
+            error = MISSING_KEY;
             return vec3();
         }
 
         if (!node[path].IsSequence()) {
-            currentError = INCORRECT_TYPE;
+            error = INCORRECT_TYPE;
             return vec3();
         }
 
@@ -68,6 +68,24 @@ namespace YMLUtil {
         return vec3(x, y, z);
     }
 
+    auto GetDVec3(const YAML::Node &node, const string &path, ErrorCode &error) -> dvec3 {
+        if (!node[path]) {
+            error = MISSING_KEY;
+            return dvec3();
+        }
+
+        if (!node[path].IsSequence()) {
+            error = INCORRECT_TYPE;
+            return dvec3();
+        }
+
+        double x = node[path][0].as<double>();
+        double y = node[path][1].as<double>();
+        double z = node[path][2].as<double>();
+
+        return dvec3(x, y, z);
+    }
+
     auto SetString(YAML::Emitter &emitter, const string &key, const string &value) -> void {
         emitter << key << value;
     }
@@ -79,4 +97,8 @@ namespace YMLUtil {
     auto SetVec3(YAML::Emitter &emitter, const string &key, const vec3 &value) -> void {
         emitter << key << YAML::BeginSeq << value.x << value.y << value.z << YAML::EndSeq;
     }
+
+    auto SetDVec3(YAML::Emitter &emitter, const string &key, const dvec3 &value) -> void {
+        emitter << key << YAML::BeginSeq << value.x << value.y << value.z << YAML::EndSeq;
+    }
 }
\ No newline at end of file
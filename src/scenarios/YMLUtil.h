@@ -17,18 +17,24 @@ namespace YMLUtil {
         FILE_NOT_FOUND
     };
 
+    // The last error from loading a scenario, for the main thread to report
     auto SetCurrentError(const ErrorCode error) -> void;
 
     auto GetCurrentError() -> ErrorCode;
 
-    auto CheckKeyExists(const YAML::Node &node, const string &path) -> bool;
+    // The getters below set error if the key is missing or has the wrong type, and leave it alone otherwise, so one
+    // error can collect the result of reading a whole file; they only touch their arguments, so they are safe to call
+    // from any thread
+    auto CheckKeyExists(const YAML::Node &node, const string &path, ErrorCode &error) -> bool;
 
-    auto GetString(const YAML::Node &node, const string &path) -> string;
-    auto GetInt   (const YAML::Node &node, const string &path) -> int;
-    auto GetDouble(const YAML::Node &node, const string &path) -> double;
-    auto GetVec3  (const YAML::Node &node, const string &path) -> vec3;
+    auto GetString(const YAML::Node &node, const string &path, ErrorCode &error) -> string;
+    auto GetInt   (const YAML::Node &node, const string &path, ErrorCode &error) -> int;
+    auto GetDouble(const YAML::Node &node, const string &path, ErrorCode &error) -> double;
+    auto GetVec3  (const YAML::Node &node, const string &path, ErrorCode &error) -> vec3;
+    auto GetDVec3 (const YAML::Node &node, const string &path, ErrorCode &error) -> dvec3;
 
     auto SetVec3  (YAML::Emitter &emitter, const string &key, const vec3   &value) -> void;
+    auto SetDVec3 (YAML::Emitter &emitter, const string &key, const dvec3  &value) -> void;
     auto SetDouble(YAML::Emitter &emitter, const string &key, const double  value) -> void;
     auto SetString(YAML::Emitter &emitter, const string &key, const string &value) -> void;
 
@@ -0,0 +1,210 @@
+#include "Collisions.h"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+
+
+namespace Collisions {
+    namespace {
+        // Cells are a couple of times the median box, so a typical sphere covers at most two cells along each axis
+        const double CELL_SIZE_MULTIPLIER = 2;
+
+        // Spheres that would cover more cells than this along an axis are tested against every other sphere instead
+        // of being inserted into all of those cells
+        const int64_t MAX_CELLS_PER_AXIS = 4;
+
+        // The hash table has at least this many buckets per entry, to keep the chains short
+        const unsigned int BUCKETS_PER_ENTRY = 2;
+
+        // Axis aligned box around everything a sphere sweeps through during the step
+        struct Box {
+            dvec3 min;
+            dvec3 max;
+        };
+
+        struct Cell {
+            int64_t x;
+            int64_t y;
+            int64_t z;
+        };
+
+        struct Entry {
+            Cell cell;
+            unsigned int sphere;
+            int next;
+        };
+
+        auto GetBox(const SweptSphere &sphere) -> Box {
+            const dvec3 radius = dvec3(sphere.radius);
+            return Box{glm::min(sphere.start, sphere.end) - radius, glm::max(sphere.start, sphere.end) + radius};
+        }
+
+        auto GetExtent(const Box &box) -> double {
+            const dvec3 size = box.max - box.min;
+            return std::max(size.x, std::max(size.y, size.z));
+        }
+
+        auto BoxesOverlap(const Box &a, const Box &b) -> bool {
+            return (a.min.x <= b.max.x) && (b.min.x <= a.max.x)
+                && (a.min.y <= b.max.y) && (b.min.y <= a.max.y)
+                && (a.min.z <= b.max.z) && (b.min.z <= a.max.z);
+        }
+
+        auto GetCell(const dvec3 &position, const double cellSize) -> Cell {
+            return Cell{int64_t(std::floor(position.x / cellSize)), int64_t(std::floor(position.y / cellSize)), int64_t(std::floor(position.z / cellSize))};
+        }
+
+        auto CellsEqual(const Cell &a, const Cell &b) -> bool {
+            return (a.x == b.x) && (a.y == b.y) && (a.z == b.z);
+        }
+
+        auto HashCell(const Cell &cell, const uint64_t mask) -> unsigned int {
+            // The usual large primes for hashing grid cells (Teschner et al.)
+            return unsigned((uint64_t(cell.x) * 73856093U) ^ (uint64_t(cell.y) * 19349663U) ^ (uint64_t(cell.z) * 83492791U)) & mask;
+        }
+
+        auto FindFraction(const SweptSphere &a, const SweptSphere &b, double &fraction) -> bool {
+            // The spheres touch when the distance between their centres, which changes linearly over the step, first
+            // drops to the sum of their radii
+            const dvec3 displacement = a.start - b.start;
+            const dvec3 motion = (a.end - a.start) - (b.end - b.start);
+            const double reach = a.radius + b.radius;
+            const double c = glm::dot(displacement, displacement) - (reach * reach);
+            if (c <= 0) {
+                fraction = 0;
+                return true;
+            }
+
+            const double squaredMotion = glm::dot(motion, motion);
+            const double halfB = glm::dot(displacement, motion);
+            if ((squaredMotion == 0) || (halfB >= 0)) {
+                return false;
+            }
+
+            const double discriminant = (halfB * halfB) - (squaredMotion * c);
+            if (discriminant < 0) {
+                return false;
+            }
+
+            fraction = (-halfB - std::sqrt(discriminant)) / squaredMotion;
+            return fraction <= 1;
+        }
+
+        auto TestPair(const vector<SweptSphere> &spheres, const unsigned int first, const unsigned int second, vector<Contact> &contacts) -> void {
+            double fraction = 0;
+            if (FindFraction(spheres.at(first), spheres.at(second), fraction)) {
+                contacts.push_back(Contact{std::min(first, second), std::max(first, second), fraction});
+            }
+        }
+
+        auto CompareFraction(const Contact &a, const Contact &b) -> bool {
+            return a.fraction < b.fraction;
+        }
+    }
+
+    auto Find(const vector<SweptSphere> &spheres) -> vector<Contact> {
+        ZoneScoped;
+        vector<Box> boxes;
+        vector<double> extents;
+        boxes.reserve(spheres.size());
+        for (const SweptSphere &sphere : spheres) {
+            boxes.push_back(GetBox(sphere));
+            const double extent = GetExtent(boxes.back());
+            if (extent > 0) {
+                extents.push_back(extent);
+            }
+        }
+
+        // Nothing that has no size and doesn't move can hit anything
+        vector<Contact> contacts;
+        if (extents.empty()) {
+            return contacts;
+        }
+
+        // The median is found in linear time, and unlike the mean isn't thrown off by a few huge or fast bodies
+        std::nth_element(extents.begin(), extents.begin() + long(extents.size() / 2), extents.end());
+        const double cellSize = CELL_SIZE_MULTIPLIER * extents.at(extents.size() / 2);
+
+        vector<Cell> minCells;
+        vector<Cell> maxCells;
+        vector<unsigned int> large;
+        vector<bool> isLarge(spheres.size(), false);
+        uint64_t entryCount = 0;
+        minCells.reserve(spheres.size());
+        maxCells.reserve(spheres.size());
+        for (unsigned int i = 0; i < spheres.size(); i++) {
+            minCells.push_back(GetCell(boxes.at(i).min, cellSize));
+            maxCells.push_back(GetCell(boxes.at(i).max, cellSize));
+            const Cell &min = minCells.back();
+            const Cell &max = maxCells.back();
+            if ((max.x - min.x >= MAX_CELLS_PER_AXIS) || (max.y - min.y >= MAX_CELLS_PER_AXIS) || (max.z - min.z >= MAX_CELLS_PER_AXIS)) {
+                large.push_back(i);
+                isLarge.at(i) = true;
+                continue;
+            }
+            entryCount += uint64_t((max.x - min.x + 1) * (max.y - min.y + 1) * (max.z - min.z + 1));
+        }
+
+        // Every sphere goes into each cell its box covers, chained from the bucket that cell hashes to
+        uint64_t bucketCount = 1;
+        while (bucketCount < BUCKETS_PER_ENTRY * entryCount) {
+            bucketCount *= 2;
+        }
+        vector<int> buckets(bucketCount, -1);
+        vector<Entry> entries;
+        entries.reserve(entryCount);
+        for (unsigned int i = 0; i < spheres.size(); i++) {
+            if (isLarge.at(i)) {
+                continue;
+            }
+            const Cell &min = minCells.at(i);
+            const Cell &max = maxCells.at(i);
+            for (int64_t x = min.x; x <= max.x; x++) {
+                for (int64_t y = min.y; y <= max.y; y++) {
+                    for (int64_t z = min.z; z <= max.z; z++) {
+                        const Cell cell{x, y, z};
+                        int &bucket = buckets.at(HashCell(cell, bucketCount - 1));
+                        entries.push_back(Entry{cell, i, bucket});
+                        bucket = int(entries.size() - 1);
+                    }
+                }
+            }
+        }
+
+        // Two spheres can share several cells, so a pair is only tested in the cell holding the lowest corner of
+        // where their boxes overlap
+        for (const int head : buckets) {
+            for (int a = head; a >= 0; a = entries.at(a).next) {
+                const Entry &entryA = entries.at(a);
+                for (int b = entryA.next; b >= 0; b = entries.at(b).next) {
+                    const Entry &entryB = entries.at(b);
+                    if (!CellsEqual(entryA.cell, entryB.cell)) {
+                        continue;
+                    }
+                    const Box &boxA = boxes.at(entryA.sphere);
+                    const Box &boxB = boxes.at(entryB.sphere);
+                    if (BoxesOverlap(boxA, boxB) && CellsEqual(entryA.cell, GetCell(glm::max(boxA.min, boxB.min), cellSize))) {
+                        TestPair(spheres, entryA.sphere, entryB.sphere, contacts);
+                    }
+                }
+            }
+        }
+
+        // There are only a few large spheres unless the sizes are very uneven
+        for (const unsigned int i : large) {
+            for (unsigned int j = 0; j < spheres.size(); j++) {
+                if ((j != i) && (!isLarge.at(j) || (j > i)) && BoxesOverlap(boxes.at(i), boxes.at(j))) {
+                    TestPair(spheres, i, j, contacts);
+                }
+            }
+        }
+
+        std::sort(contacts.begin(), contacts.end(), CompareFraction);
+        return contacts;
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <util/Types.h>
+
+
+
+// A sphere moving in a straight line over one step
+struct SweptSphere {
+    dvec3 start;
+    dvec3 end;
+    double radius; // m
+};
+
+struct Contact {
+    unsigned int first;
+    unsigned int second;
+    double fraction; // of the step, when the spheres first touch
+};
+
+// Finds spheres that touch at any point during a step, not just at the end of it, so fast bodies can't pass through
+// each other between steps
+namespace Collisions {
+    // Sorted by fraction; the broad phase is a uniform spatial hash, so the cost is close to linear in the number of
+    // spheres as long as most of them are of similar size
+    auto Find(const vector<SweptSphere> &spheres) -> vector<Contact>;
+}
@@ -0,0 +1,220 @@
+#include "Conjunctions.h"
+
+#include <simulation/Hermite.h>
+#include <simulation/Simulation.h>
+#include <simulation/Trajectory.h>
+#include <main/Bodies.h>
+#include <util/Log.h>
+#include <util/Parallel.h>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <limits>
+#include <mutex>
+
+
+
+namespace Conjunctions {
+    namespace {
+        // Consecutive trajectory intervals screened together; longer windows mean fewer boxes to sort, but looser boxes
+        // and so more candidate pairs to check precisely
+        const unsigned int WINDOW_INTERVALS = 16;
+
+        // A cubic between two states with velocity change dv over time dt strays from the straight line between them by
+        // at most dv * dt / 4, so boxes around the states are grown by that much to be sure of containing the path
+        const double BULGE_FACTOR = 0.25;
+
+        const double SECONDS_PER_DAY = 86400;
+
+        // Axis aligned box around the path of one body through one window
+        struct Box {
+            unsigned int body;
+            dvec3 min;
+            dvec3 max;
+        };
+
+        // The trajectory as it was when screening started; the prediction keeps extending while we work
+        vector<string> ids;
+        vector<double> times;
+        vector<OrbitPoint> points;
+
+        thread worker;
+        std::atomic_bool finished = false;
+        std::atomic_bool cancel = false;
+        std::atomic<unsigned int> windowsCompleted = 0;
+        unsigned int windowCount = 0;
+
+        ConjunctionSettings settings;
+        std::mutex resultsMutex;
+        vector<Conjunction> results;
+
+        auto GetPoint(const unsigned int state, const unsigned int body) -> const OrbitPoint& {
+            return points.at((state * ids.size()) + body);
+        }
+
+        auto CreateBox(const unsigned int body, const unsigned int firstState, const unsigned int lastState) -> Box {
+            Box box{body, GetPoint(firstState, body).position, GetPoint(firstState, body).position};
+            double bulge = 0;
+            for (unsigned int state = firstState + 1; state <= lastState; state++) {
+                const OrbitPoint &point = GetPoint(state, body);
+                box.min = glm::min(box.min, point.position);
+                box.max = glm::max(box.max, point.position);
+                const double velocityChange = glm::length(point.velocity - GetPoint(state - 1, body).velocity);
+                bulge = std::max(bulge, BULGE_FACTOR * velocityChange * (times.at(state) - times.at(state - 1)));
+            }
+
+            // Two boxes grown by half the threshold overlap whenever their bodies could come within the threshold
+            const dvec3 padding = dvec3(bulge + (settings.threshold / 2));
+            box.min -= padding;
+            box.max += padding;
+            return box;
+        }
+
+        auto FindCandidates(vector<Box> &boxes) -> vector<std::pair<unsigned int, unsigned int>> {
+            // Sort and sweep along x, then check the other two axes for each pair whose x extents overlap
+            std::sort(boxes.begin(), boxes.end(), [](const Box &a, const Box &b) { return a.min.x < b.min.x; });
+            vector<std::pair<unsigned int, unsigned int>> candidates;
+            for (unsigned int i = 0; i < boxes.size(); i++) {
+                const Box &a = boxes.at(i);
+                for (unsigned int j = i + 1; (j < boxes.size()) && (boxes.at(j).min.x <= a.max.x); j++) {
+                    const Box &b = boxes.at(j);
+                    if ((a.min.y <= b.max.y) && (b.min.y <= a.max.y) && (a.min.z <= b.max.z) && (b.min.z <= a.max.z)) {
+                        candidates.emplace_back(std::min(a.body, b.body), std::max(a.body, b.body));
+                    }
+                }
+            }
+            return candidates;
+        }
+
+        auto CheckPair(const unsigned int body, const unsigned int other, const unsigned int firstState, const unsigned int lastState, vector<Conjunction> &found) -> void {
+            // Minima of distance are where the radial velocity goes from negative to positive
+            for (unsigned int state = firstState; state < lastState; state++) {
+                const OrbitPoint &bodyStart = GetPoint(state, body);
+                const OrbitPoint &bodyEnd = GetPoint(state + 1, body);
+                const OrbitPoint &otherStart = GetPoint(state, other);
+                const OrbitPoint &otherEnd = GetPoint(state + 1, other);
+                if ((Hermite::GetRadialVelocity(bodyStart, otherStart) >= 0) || (Hermite::GetRadialVelocity(bodyEnd, otherEnd) < 0)) {
+                    continue;
+                }
+
+                const double interval = times.at(state + 1) - times.at(state);
+                const double fraction = Hermite::FindRadialVelocityRoot(bodyStart, bodyEnd, otherStart, otherEnd, interval);
+                const OrbitPoint bodyPoint = Hermite::Interpolate(bodyStart, bodyEnd, interval, fraction);
+                const OrbitPoint otherPoint = Hermite::Interpolate(otherStart, otherEnd, interval, fraction);
+                const double distance = glm::length(bodyPoint.position - otherPoint.position);
+                if (distance <= settings.threshold) {
+                    found.push_back(Conjunction{
+                        ids.at(body),
+                        ids.at(other),
+                        times.at(state) + (fraction * interval),
+                        distance,
+                        glm::length(bodyPoint.velocity - otherPoint.velocity)});
+                }
+            }
+        }
+
+        auto ScreenWindows(const unsigned int begin, const unsigned int end) -> void {
+            vector<Conjunction> found;
+            vector<Box> boxes(ids.size());
+            for (unsigned int window = begin; (window < end) && !cancel; window++) {
+                const unsigned int firstState = window * WINDOW_INTERVALS;
+                const unsigned int lastState = std::min(firstState + WINDOW_INTERVALS, unsigned(times.size()) - 1);
+                for (unsigned int body = 0; body < ids.size(); body++) {
+                    boxes.at(body) = CreateBox(body, firstState, lastState);
+                }
+                for (const auto &candidate : FindCandidates(boxes)) {
+                    CheckPair(candidate.first, candidate.second, firstState, lastState, found);
+                }
+                windowsCompleted++;
+            }
+
+            std::lock_guard<std::mutex> lock(resultsMutex);
+            results.insert(results.end(), found.begin(), found.end());
+        }
+
+        auto Run() -> void {
+            ZoneScoped;
+            // Windows are handed out in contiguous ranges, which is fine since every window costs about the same
+            Parallel::For(windowCount, ScreenWindows);
+            std::sort(results.begin(), results.end(), [](const Conjunction &a, const Conjunction &b) { return a.time < b.time; });
+            finished = true;
+        }
+
+        auto Join() -> void {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    auto Start(const ConjunctionSettings &_settings) -> void {
+        Cancel();
+        settings = _settings;
+        results.clear();
+
+        const double startTime = Simulation::GetTimeStep();
+        const double endTime = startTime + settings.duration;
+        ids = Trajectory::GetIds();
+        Trajectory::GetStates(startTime, times, points);
+        const auto last = std::upper_bound(times.begin(), times.end(), endTime);
+        times.erase(last, times.end());
+        points.resize(times.size() * ids.size());
+
+        if ((times.size() < 2) || (ids.size() < 2)) {
+            Log(WARN, "Conjunction screening needs at least two bodies and some predicted trajectory");
+            windowCount = 0;
+            return;
+        }
+        if (times.back() < endTime) {
+            Log(INFO, "The trajectory has only been predicted " + std::to_string(int((times.back() - startTime) / SECONDS_PER_DAY)) + " days ahead, so only that far will be screened");
+        }
+
+        windowCount = (times.size() - 2) / WINDOW_INTERVALS + 1;
+        windowsCompleted = 0;
+        finished = false;
+        cancel = false;
+        worker = thread(Run);
+    }
+
+    auto Cancel() -> void {
+        cancel = true;
+        Join();
+        cancel = false;
+    }
+
+    auto PreReset() -> void {
+        Cancel();
+        results.clear();
+        ids.clear();
+        times.clear();
+        points.clear();
+    }
+
+    auto IsRunning() -> bool {
+        return worker.joinable() && !finished;
+    }
+
+    auto GetProgress() -> float {
+        return (windowCount == 0) ? 0 : float(windowsCompleted) / float(windowCount);
+    }
+
+    auto GetResults() -> const vector<Conjunction>& {
+        return results;
+    }
+
+    auto Export(const string &path) -> bool {
+        std::ofstream file(path);
+        file.precision(std::numeric_limits<double>::max_digits10);
+        file << "body,other_body,time,distance,relative_speed\n";
+        for (const Conjunction &conjunction : results) {
+            file << conjunction.id << "," << conjunction.otherId << "," << conjunction.time << ","
+                 << conjunction.distance << "," << conjunction.relativeSpeed << "\n";
+        }
+        file.close();
+        return bool(file);
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <util/Types.h>
+
+
+
+struct ConjunctionSettings {
+    double threshold; // m
+    double duration; // s
+};
+
+struct Conjunction {
+    string id;
+    string otherId;
+    double time;
+    double distance; // m
+    double relativeSpeed; // m/s
+};
+
+// Finds every pair of bodies that passes within a threshold distance of each other over the predicted trajectory
+namespace Conjunctions {
+    // Screens the trajectory from the current time up to duration ahead, or as far as it has been predicted
+    auto Start(const ConjunctionSettings &settings) -> void;
+    auto Cancel() -> void;
+    auto PreReset() -> void;
+
+    auto IsRunning() -> bool;
+    auto GetProgress() -> float;
+
+    // Sorted by time; only valid while no screening is running
+    auto GetResults() -> const vector<Conjunction>&;
+
+    // Writes the results as .csv
+    auto Export(const string &path) -> bool;
+}
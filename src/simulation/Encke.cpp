@@ -0,0 +1,61 @@
+#include "Encke.h"
+
+#include <simulation/Kepler.h>
+
+#include <glm/geometric.hpp>
+
+#include <cmath>
+
+
+
+namespace Encke {
+    namespace {
+        // Rectifying more often costs nothing much, but letting the deviation grow makes the perturbation less
+        // accurate, since it is evaluated at a position the reference orbit doesn't pass through
+        const double RECTIFY_RATIO = 0.01;
+
+        auto F(const double q) -> double {
+            // Battin's f(q) = (1 + q)^(3/2) - 1, written so it doesn't lose precision when q is small
+            return q * (3 + (3 * q) + (q * q)) / (1 + std::pow(1 + q, 1.5));
+        }
+    }
+
+    auto Seed(const string &primaryId, const OrbitPoint &relative, const dvec3 &perturbation) -> EnckeOrbit {
+        return EnckeOrbit{primaryId, relative, dvec3(0, 0, 0), dvec3(0, 0, 0), perturbation};
+    }
+
+    auto GetDeviationAcceleration(const dvec3 &referencePosition, const dvec3 &deviation, const double mu, const dvec3 &perturbation) -> dvec3 {
+        // Battin, An Introduction to the Mathematics and Methods of Astrodynamics, section 9.3
+        const dvec3 position = referencePosition + deviation;
+        const double q = glm::dot(deviation, deviation - (2.0 * position)) / glm::dot(position, position);
+        const double referenceDistance = glm::length(referencePosition);
+        const double referenceDistanceCubed = referenceDistance * referenceDistance * referenceDistance;
+        return perturbation - ((mu / referenceDistanceCubed) * ((F(q) * position) + deviation));
+    }
+
+    auto RectifyIfNeeded(EnckeOrbit &orbit, const dvec3 &perturbation) -> void {
+        if (glm::length(orbit.deviation) < RECTIFY_RATIO * glm::length(orbit.reference.position)) {
+            return;
+        }
+        orbit.reference.position += orbit.deviation;
+        orbit.reference.velocity += orbit.deviationVelocity;
+        orbit.deviation = dvec3(0, 0, 0);
+        orbit.deviationVelocity = dvec3(0, 0, 0);
+        orbit.deviationAcceleration = perturbation;
+    }
+
+    auto Drift(EnckeOrbit &orbit, const double mu, const double timeStep) -> dvec3 {
+        orbit.reference = Kepler::Propagate(orbit.reference, mu, timeStep);
+        orbit.deviation += (orbit.deviationVelocity * timeStep) + (0.5 * orbit.deviationAcceleration * timeStep * timeStep);
+        orbit.deviationVelocity += 0.5 * orbit.deviationAcceleration * timeStep;
+        return orbit.reference.position + orbit.deviation;
+    }
+
+    auto Kick(EnckeOrbit &orbit, const double mu, const dvec3 &perturbation, const double timeStep) -> dvec3 {
+        orbit.deviationAcceleration = GetDeviationAcceleration(orbit.reference.position, orbit.deviation, mu, perturbation);
+        orbit.deviationVelocity += 0.5 * orbit.deviationAcceleration * timeStep;
+        const dvec3 velocity = orbit.reference.velocity + orbit.deviationVelocity;
+        RectifyIfNeeded(orbit, perturbation);
+        return velocity;
+    }
+}
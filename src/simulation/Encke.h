@@ -0,0 +1,36 @@
+#pragma once
+
+#include <simulation/OrbitPoint.h>
+#include <util/Types.h>
+
+
+
+// A body followed with Encke's method: a reference Kepler orbit around its primary, plus a small deviation from it
+// that is integrated numerically; the deviation only has to follow the perturbations, so it stays accurate at step
+// sizes far too large to integrate the primary's pull directly
+struct EnckeOrbit {
+    string primaryId;
+    OrbitPoint reference;           // relative to the primary
+    dvec3 deviation;
+    dvec3 deviationVelocity;
+    dvec3 deviationAcceleration;
+};
+
+namespace Encke {
+    // Starts a new reference orbit through the given point (relative to the primary), with no deviation from it
+    auto Seed(const string &primaryId, const OrbitPoint &relative, const dvec3 &perturbation) -> EnckeOrbit;
+
+    // The acceleration of the deviation, given the perturbing acceleration (everything except the primary's
+    // two-body pull, relative to the primary); mu is G * (sum of both masses)
+    auto GetDeviationAcceleration(const dvec3 &referencePosition, const dvec3 &deviation, const double mu, const dvec3 &perturbation) -> dvec3;
+
+    // Once the deviation is a noticeable fraction of the orbit, the reference is moved onto the true orbit
+    auto RectifyIfNeeded(EnckeOrbit &orbit, const dvec3 &perturbation) -> void;
+
+    // A step is split in two around calculating the acceleration at the new position: Drift moves the reference orbit
+    // exactly and the deviation by the first half of a velocity Verlet step, and returns the new position relative to
+    // the primary; Kick finishes the step with the perturbation at that position, rectifies if needed, and returns
+    // the new velocity relative to the primary
+    auto Drift(EnckeOrbit &orbit, const double mu, const double timeStep) -> dvec3;
+    auto Kick(EnckeOrbit &orbit, const double mu, const dvec3 &perturbation, const double timeStep) -> dvec3;
+}
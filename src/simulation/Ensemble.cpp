@@ -0,0 +1,401 @@
+#include "Ensemble.h"
+
+#include <simulation/Simulation.h>
+#include <main/Bodies.h>
+#include <util/Constants.h>
+#include <util/Parallel.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <random>
+
+
+
+namespace Ensemble {
+    namespace {
+        // Structure of arrays for a contiguous range of ensemble members
+        // Every value is indexed by [body * memberCount + member], so the innermost loops run across members; the same
+        // body in neighbouring members sits in neighbouring memory, and those loops map straight onto SIMD lanes
+        struct Block {
+            unsigned int memberCount;
+            vector<double> px, py, pz;
+            vector<double> vx, vy, vz;
+            vector<double> ax, ay, az;
+
+            // Scratch space for the mixed-precision kernel (squared distances, then inverse distances), and the
+            // double-precision accelerations it is checked against
+            vector<float> inverseDistances;
+            vector<double> referenceAx, referenceAy, referenceAz;
+        };
+
+        // The scenario as it was when the run started; the simulation keeps running while we work
+        struct InitialState {
+            vector<string> ids;
+            vector<double> masses;
+            vector<unsigned int> massiveIndices;
+            vector<dvec3> positions;
+            vector<dvec3> velocities;
+            vector<unsigned int> perturbedIndices;
+            vector<string> perturbedIds;
+        };
+
+        thread worker;
+        std::atomic_bool finished = false;
+        std::atomic_bool cancel = false;
+        std::atomic<uint64_t> stepsCompleted = 0;
+        uint64_t stepsTotal = 0;
+        bool newResult = false;
+
+        EnsembleSettings settings;
+
+        // Accumulated over every block checked during the run
+        std::mutex reportMutex;
+        bool reportChecked = false;
+        double reportForceError = 0;
+        double reportDoubleSeconds = 0;
+        double reportMixedSeconds = 0;
+        InitialState initial;
+        vector<vector<dvec3>> paths;
+
+        auto CaptureInitialState() -> void {
+            initial = InitialState();
+            for (const string &id : Bodies::GetBodyIds()) {
+                // Bodies absorbed in a merge sit on the body they merged into, so integrating them would divide by zero
+                if (Bodies::IsAbsorbed(id)) {
+                    continue;
+                }
+                const unsigned int i = initial.ids.size();
+                const Body &body = Bodies::GetBody(id);
+                initial.ids.push_back(id);
+                initial.masses.push_back(body.GetMass());
+                initial.positions.push_back(body.GetPosition());
+                initial.velocities.push_back(body.GetVelocity());
+                if (Bodies::GetMassiveBodies().count(id) != 0) {
+                    initial.massiveIndices.push_back(i);
+                }
+                if (std::find(settings.perturbedIds.begin(), settings.perturbedIds.end(), id) != settings.perturbedIds.end()) {
+                    initial.perturbedIndices.push_back(i);
+                    initial.perturbedIds.push_back(id);
+                }
+            }
+        }
+
+        auto FillBlock(Block &block, const unsigned int firstMember) -> void {
+            const unsigned int bodyCount = initial.ids.size();
+            const unsigned int size = bodyCount * block.memberCount;
+            for (vector<double>* array : {&block.px, &block.py, &block.pz, &block.vx, &block.vy, &block.vz, &block.ax, &block.ay, &block.az}) {
+                array->assign(size, 0);
+            }
+            if (settings.mixedPrecision) {
+                block.inverseDistances.assign(block.memberCount, 0);
+                for (vector<double>* array : {&block.referenceAx, &block.referenceAy, &block.referenceAz}) {
+                    array->assign(size, 0);
+                }
+            }
+
+            for (unsigned int body = 0; body < bodyCount; body++) {
+                for (unsigned int member = 0; member < block.memberCount; member++) {
+                    const unsigned int index = (body * block.memberCount) + member;
+                    block.px.at(index) = initial.positions.at(body).x;
+                    block.py.at(index) = initial.positions.at(body).y;
+                    block.pz.at(index) = initial.positions.at(body).z;
+                    block.vx.at(index) = initial.velocities.at(body).x;
+                    block.vy.at(index) = initial.velocities.at(body).y;
+                    block.vz.at(index) = initial.velocities.at(body).z;
+                }
+            }
+
+            // Every member seeds its own generator, so the perturbations don't depend on how members are split into blocks
+            for (unsigned int member = 0; member < block.memberCount; member++) {
+                std::mt19937_64 generator(settings.seed + firstMember + member);
+                std::normal_distribution<double> positionError(0, settings.positionSigma);
+                std::normal_distribution<double> velocityError(0, settings.velocitySigma);
+                for (const unsigned int body : initial.perturbedIndices) {
+                    const unsigned int index = (body * block.memberCount) + member;
+                    block.px.at(index) += positionError(generator);
+                    block.py.at(index) += positionError(generator);
+                    block.pz.at(index) += positionError(generator);
+                    block.vx.at(index) += velocityError(generator);
+                    block.vy.at(index) += velocityError(generator);
+                    block.vz.at(index) += velocityError(generator);
+                }
+            }
+        }
+
+        // The kernels below take __restrict pointers, since the arrays never overlap and telling the compiler so is what
+        // lets it vectorize the loops across members
+        // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        auto AccumulateAcceleration(const unsigned int n, const double gm,
+                const double* __restrict pxi, const double* __restrict pyi, const double* __restrict pzi,
+                const double* __restrict pxj, const double* __restrict pyj, const double* __restrict pzj,
+                double* __restrict ax, double* __restrict ay, double* __restrict az) -> void {
+            for (unsigned int member = 0; member < n; member++) {
+                const double dx = pxj[member] - pxi[member];
+                const double dy = pyj[member] - pyi[member];
+                const double dz = pzj[member] - pzi[member];
+                const double distanceSquared = (dx * dx) + (dy * dy) + (dz * dz);
+                const double scale = gm / (distanceSquared * std::sqrt(distanceSquared));
+                ax[member] += dx * scale;
+                ay[member] += dy * scale;
+                az[member] += dz * scale;
+            }
+        }
+
+        auto AccumulateAccelerationMixed(const unsigned int n, const double gm,
+                const double* __restrict pxi, const double* __restrict pyi, const double* __restrict pzi,
+                const double* __restrict pxj, const double* __restrict pyj, const double* __restrict pzj,
+                float* __restrict inverseDistances,
+                double* __restrict ax, double* __restrict ay, double* __restrict az) -> void {
+            // Displacements are taken and the pull is added in double, since positions are far larger than the
+            // distances between bodies; only the square root and division run in float, at twice the SIMD width
+            // Split into separate loops so each one is vectorized at its own width; the displacement is taken again in
+            // the last loop because rereading the positions costs less than storing it and loading it back
+            for (unsigned int member = 0; member < n; member++) {
+                const double dx = pxj[member] - pxi[member];
+                const double dy = pyj[member] - pyi[member];
+                const double dz = pzj[member] - pzi[member];
+                inverseDistances[member] = float((dx * dx) + (dy * dy) + (dz * dz));
+            }
+
+            // A correctly rounded float square root and division, so the only error is float rounding; the cube is left
+            // to the double loop, since 1/d^3 drops below the smallest normal float at about 30 AU
+            for (unsigned int member = 0; member < n; member++) {
+                inverseDistances[member] = 1.0F / std::sqrt(inverseDistances[member]);
+            }
+
+            for (unsigned int member = 0; member < n; member++) {
+                const double dx = pxj[member] - pxi[member];
+                const double dy = pyj[member] - pyi[member];
+                const double dz = pzj[member] - pzi[member];
+                const double inverseDistance = inverseDistances[member];
+                const double scale = gm * inverseDistance * inverseDistance * inverseDistance;
+                ax[member] += dx * scale;
+                ay[member] += dy * scale;
+                az[member] += dz * scale;
+            }
+        }
+
+        auto Integrate(const unsigned int n, const double* __restrict derivative, double* __restrict value, const double timeStep) -> void {
+            for (unsigned int i = 0; i < n; i++) {
+                value[i] += derivative[i] * timeStep;
+            }
+        }
+        // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+        auto CalculateAccelerations(Block &block, const bool mixedPrecision, vector<double> &ax, vector<double> &ay, vector<double> &az) -> void {
+            // Same model as SimulationState: every body is pulled by every massive body except itself
+            const unsigned int n = block.memberCount;
+            std::fill(ax.begin(), ax.end(), 0);
+            std::fill(ay.begin(), ay.end(), 0);
+            std::fill(az.begin(), az.end(), 0);
+
+            for (unsigned int i = 0; i < initial.ids.size(); i++) {
+                for (const unsigned int j : initial.massiveIndices) {
+                    if (i == j) {
+                        continue;
+                    }
+                    if (mixedPrecision) {
+                        AccumulateAccelerationMixed(n, GRAVITATIONAL_CONSTANT * initial.masses.at(j),
+                            &block.px.at(i * n), &block.py.at(i * n), &block.pz.at(i * n),
+                            &block.px.at(j * n), &block.py.at(j * n), &block.pz.at(j * n),
+                            block.inverseDistances.data(),
+                            &ax.at(i * n), &ay.at(i * n), &az.at(i * n));
+                    } else {
+                        AccumulateAcceleration(n, GRAVITATIONAL_CONSTANT * initial.masses.at(j),
+                            &block.px.at(i * n), &block.py.at(i * n), &block.pz.at(i * n),
+                            &block.px.at(j * n), &block.py.at(j * n), &block.pz.at(j * n),
+                            &ax.at(i * n), &ay.at(i * n), &az.at(i * n));
+                    }
+                }
+            }
+        }
+
+        auto CalculateAccelerations(Block &block) -> void {
+            CalculateAccelerations(block, settings.mixedPrecision, block.ax, block.ay, block.az);
+        }
+
+        auto CheckMixedPrecision(Block &block) -> void {
+            // Both kernels are run and timed on the same positions; only done at the start and end of each block,
+            // since the double-precision kernel costs as much as a step
+            const auto start = std::chrono::steady_clock::now();
+            CalculateAccelerations(block, false, block.referenceAx, block.referenceAy, block.referenceAz);
+            const auto middle = std::chrono::steady_clock::now();
+            CalculateAccelerations(block);
+            const auto end = std::chrono::steady_clock::now();
+
+            double forceError = 0;
+            for (unsigned int i = 0; i < block.ax.size(); i++) {
+                const dvec3 reference(block.referenceAx.at(i), block.referenceAy.at(i), block.referenceAz.at(i));
+                const double magnitude = glm::length(reference);
+                if (magnitude > 0) {
+                    const dvec3 acceleration(block.ax.at(i), block.ay.at(i), block.az.at(i));
+                    forceError = std::max(forceError, glm::length(acceleration - reference) / magnitude);
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(reportMutex);
+            reportChecked = true;
+            reportForceError = std::max(reportForceError, forceError);
+            reportDoubleSeconds += std::chrono::duration<double>(middle - start).count();
+            reportMixedSeconds += std::chrono::duration<double>(end - middle).count();
+        }
+
+        auto ResetReport() -> void {
+            std::lock_guard<std::mutex> lock(reportMutex);
+            reportChecked = false;
+            reportForceError = 0;
+            reportDoubleSeconds = 0;
+            reportMixedSeconds = 0;
+        }
+
+        auto Step(Block &block, const double timeStep) -> void {
+            // Velocity Verlet, as in SimulationState, but with every position updated before any acceleration is recalculated
+            const unsigned int size = block.px.size();
+            Integrate(size, block.ax.data(), block.vx.data(), 0.5 * timeStep);
+            Integrate(size, block.ay.data(), block.vy.data(), 0.5 * timeStep);
+            Integrate(size, block.az.data(), block.vz.data(), 0.5 * timeStep);
+            Integrate(size, block.vx.data(), block.px.data(), timeStep);
+            Integrate(size, block.vy.data(), block.py.data(), timeStep);
+            Integrate(size, block.vz.data(), block.pz.data(), timeStep);
+
+            CalculateAccelerations(block);
+
+            Integrate(size, block.ax.data(), block.vx.data(), 0.5 * timeStep);
+            Integrate(size, block.ay.data(), block.vy.data(), 0.5 * timeStep);
+            Integrate(size, block.az.data(), block.vz.data(), 0.5 * timeStep);
+        }
+
+        auto Sample(const Block &block, const unsigned int firstMember) -> void {
+            const unsigned int perturbedCount = initial.perturbedIndices.size();
+            for (unsigned int member = 0; member < block.memberCount; member++) {
+                for (unsigned int p = 0; p < perturbedCount; p++) {
+                    const unsigned int index = (initial.perturbedIndices.at(p) * block.memberCount) + member;
+                    paths.at(((firstMember + member) * perturbedCount) + p).emplace_back(block.px.at(index), block.py.at(index), block.pz.at(index));
+                }
+            }
+        }
+
+        auto PropagateMembers(const unsigned int begin, const unsigned int end) -> void {
+            // Members are independent, so each thread runs its own block for the whole duration without synchronising
+            ZoneScoped;
+            const double timeStep = Simulation::GetTimeStepSize();
+
+            Block block;
+            block.memberCount = end - begin;
+            FillBlock(block, begin);
+            if (settings.mixedPrecision) {
+                CheckMixedPrecision(block);
+            } else {
+                CalculateAccelerations(block);
+            }
+            Sample(block, begin);
+
+            for (unsigned int step = 1; step <= settings.stepCount; step++) {
+                if (cancel) {
+                    return;
+                }
+                Step(block, timeStep);
+                if (step % settings.sampleInterval == 0) {
+                    Sample(block, begin);
+                }
+                stepsCompleted += block.memberCount;
+            }
+
+            if (settings.mixedPrecision) {
+                CheckMixedPrecision(block);
+            }
+        }
+
+        auto Run() -> void {
+            ZoneScoped;
+            Parallel::For(settings.memberCount, PropagateMembers);
+            finished = true;
+        }
+
+        auto Join() -> void {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    auto Start(const EnsembleSettings &_settings) -> void {
+        Cancel();
+
+        settings = _settings;
+        settings.sampleInterval = std::max(1U, settings.sampleInterval);
+        CaptureInitialState();
+        if (initial.perturbedIndices.empty() || (settings.memberCount == 0)) {
+            Log(WARN, "Ensemble needs at least one member and one perturbed body");
+            return;
+        }
+
+        const unsigned int perturbedCount = initial.perturbedIndices.size();
+        paths = vector<vector<dvec3>>(settings.memberCount * perturbedCount);
+        for (vector<dvec3> &path : paths) {
+            path.reserve((settings.stepCount / settings.sampleInterval) + 1);
+        }
+
+        ResetReport();
+        stepsCompleted = 0;
+        stepsTotal = uint64_t(settings.stepCount) * settings.memberCount;
+        finished = false;
+        cancel = false;
+        newResult = false;
+        worker = thread(Run);
+    }
+
+    auto Cancel() -> void {
+        cancel = true;
+        Join();
+        cancel = false;
+    }
+
+    auto PreReset() -> void {
+        Cancel();
+        paths.clear();
+        initial = InitialState();
+        ResetReport();
+        newResult = true;
+    }
+
+    auto IsRunning() -> bool {
+        return worker.joinable() && !finished;
+    }
+
+    auto GetProgress() -> float {
+        return (stepsTotal == 0) ? 0 : float(stepsCompleted) / float(stepsTotal);
+    }
+
+    auto TakeNewResult() -> bool {
+        if (worker.joinable() && finished) {
+            Join();
+            newResult = true;
+        }
+
+        const bool result = newResult;
+        newResult = false;
+        return result;
+    }
+
+    auto GetPaths() -> const vector<vector<dvec3>>& {
+        return paths;
+    }
+
+    auto GetPerturbedIds() -> const vector<string>& {
+        return initial.perturbedIds;
+    }
+
+    auto GetMixedPrecisionReport(MixedPrecisionReport &report) -> bool {
+        std::lock_guard<std::mutex> lock(reportMutex);
+        if (!reportChecked || (reportMixedSeconds <= 0)) {
+            return false;
+        }
+        report.forceError = reportForceError;
+        report.speedup = reportDoubleSeconds / reportMixedSeconds;
+        return true;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <util/Types.h>
+
+
+
+struct EnsembleSettings {
+    vector<string> perturbedIds;
+    unsigned int memberCount;
+    double positionSigma; // m
+    double velocitySigma; // m/s
+    unsigned int stepCount;
+    unsigned int sampleInterval;
+    uint64_t seed;
+
+    // Evaluates the inverse distances in float; each block is checked against the double-precision kernel
+    bool mixedPrecision;
+};
+
+// How the mixed-precision kernel compared with the double-precision kernel over a run
+struct MixedPrecisionReport {
+    double forceError; // largest acceleration error, relative to the acceleration
+    double speedup; // double-precision kernel time divided by mixed-precision kernel time
+};
+
+namespace Ensemble {
+    // Propagates memberCount copies of the current scenario, with Gaussian errors added to the initial position and
+    // velocity of the perturbed bodies, and samples the paths those bodies take in every copy
+    auto Start(const EnsembleSettings &settings) -> void;
+    auto Cancel() -> void;
+    auto PreReset() -> void;
+
+    auto IsRunning() -> bool;
+    auto GetProgress() -> float;
+
+    // Returns true exactly once after each run completes, so the renderer knows to rebuild its vertices
+    auto TakeNewResult() -> bool;
+
+    // Sampled positions, indexed by [member * GetPerturbedIds().size() + perturbed body]
+    // Perturbed bodies are in the same order as Bodies::GetBodyIds, which may differ from the order in the settings
+    auto GetPaths() -> const vector<vector<dvec3>>&;
+    auto GetPerturbedIds() -> const vector<string>&;
+
+    // Returns false unless the last run used mixed precision and at least one block has been checked
+    auto GetMixedPrecisionReport(MixedPrecisionReport &report) -> bool;
+}
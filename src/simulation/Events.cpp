@@ -0,0 +1,256 @@
+#include "Events.h"
+
+#include <simulation/Hermite.h>
+#include <main/Bodies.h>
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <mutex>
+
+
+
+namespace Events {
+    namespace {
+        struct Pair {
+            unsigned int body;
+            unsigned int other;
+            bool primary; // whether other is body's primary, rather than just another body
+        };
+
+        // Every pair is checked each step, so closest approaches are only tracked when that stays cheap
+        // compared to the step itself
+        const unsigned int MAX_PAIRWISE_BODIES = 32;
+        const unsigned int MAX_PAST_EVENTS = 1000;
+
+        std::mutex mutex;
+
+        vector<string> ids;
+        vector<Pair> pairs;
+
+        bool hasPrevious = false;
+        double previousTime = 0;
+        vector<OrbitPoint> previousPoints;
+        vector<double> previousRadialVelocities;
+
+        vector<Event> events;
+
+        auto FindPrimary(const vector<OrbitPoint> &points, const unsigned int body) -> int {
+            // The more massive body exerting the strongest pull on body, or -1 if there is none
+            const double mass = Bodies::GetBody(ids.at(body)).GetMass();
+            int primary = -1;
+            double strongestPull = 0;
+            for (unsigned int other = 0; other < ids.size(); other++) {
+                const double otherMass = Bodies::GetBody(ids.at(other)).GetMass();
+                if ((other == body) || (otherMass <= mass)) {
+                    continue;
+                }
+                // A body that merged into another sits exactly on it
+                const dvec3 displacement = points.at(other).position - points.at(body).position;
+                const double distanceSquared = glm::dot(displacement, displacement);
+                const double pull = (distanceSquared > 0) ? otherMass / distanceSquared : 0;
+                if (pull > strongestPull) {
+                    strongestPull = pull;
+                    primary = int(other);
+                }
+            }
+            return primary;
+        }
+
+        auto GeneratePairs(const vector<OrbitPoint> &points) -> void {
+            pairs.clear();
+            vector<int> primaries(ids.size());
+            for (unsigned int body = 0; body < ids.size(); body++) {
+                primaries.at(body) = FindPrimary(points, body);
+                if (primaries.at(body) != -1) {
+                    pairs.push_back(Pair{body, unsigned(primaries.at(body)), true});
+                }
+            }
+
+            if (ids.size() > MAX_PAIRWISE_BODIES) {
+                return;
+            }
+
+            // Pairs already tracked through periapsis would only report the same events again
+            for (unsigned int body = 0; body < ids.size(); body++) {
+                for (unsigned int other = body + 1; other < ids.size(); other++) {
+                    if ((primaries.at(body) != int(other)) && (primaries.at(other) != int(body))) {
+                        pairs.push_back(Pair{body, other, false});
+                    }
+                }
+            }
+        }
+
+        auto DetectPair(const Pair &pair, const double startTime, const double endTime,
+                        const OrbitPoint &bodyStart, const OrbitPoint &bodyEnd, const OrbitPoint &otherStart, const OrbitPoint &otherEnd,
+                        const double startRadial, const double endRadial, vector<Event> &found) -> void {
+            const bool approaching = startRadial < 0;
+            if ((startRadial == 0) || ((endRadial >= 0) != approaching)) {
+                return;
+            }
+
+            // Approaching then receding is a minimum of distance; the reverse is only interesting around a primary
+            if (!approaching && !pair.primary) {
+                return;
+            }
+
+            const EventType type = !pair.primary ? EVENT_TYPE_CLOSEST_APPROACH : (approaching ? EVENT_TYPE_PERIAPSIS : EVENT_TYPE_APOAPSIS);
+            const double interval = endTime - startTime;
+            const double fraction = Hermite::FindRadialVelocityRoot(bodyStart, bodyEnd, otherStart, otherEnd, interval);
+            const OrbitPoint body = Hermite::Interpolate(bodyStart, bodyEnd, interval, fraction);
+            const OrbitPoint other = Hermite::Interpolate(otherStart, otherEnd, interval, fraction);
+            found.push_back(Event{
+                type,
+                ids.at(pair.body),
+                ids.at(pair.other),
+                startTime + (fraction * interval),
+                glm::length(body.position - other.position),
+                body.position,
+                other.position});
+        }
+
+        auto SortEvents(vector<Event> &toSort) -> void {
+            std::stable_sort(toSort.begin(), toSort.end(), [](const Event &a, const Event &b) { return a.time < b.time; });
+        }
+
+        auto Detect(const double time, const vector<OrbitPoint> &points) -> void {
+            // Must be called with the mutex held
+            vector<double> radialVelocities(pairs.size());
+            for (unsigned int i = 0; i < pairs.size(); i++) {
+                radialVelocities.at(i) = Hermite::GetRadialVelocity(points.at(pairs.at(i).body), points.at(pairs.at(i).other));
+            }
+
+            if (hasPrevious && (time > previousTime)) {
+                vector<Event> newEvents;
+                for (unsigned int i = 0; i < pairs.size(); i++) {
+                    const Pair &pair = pairs.at(i);
+                    DetectPair(pair, previousTime, time,
+                        previousPoints.at(pair.body), points.at(pair.body), previousPoints.at(pair.other), points.at(pair.other),
+                        previousRadialVelocities.at(i), radialVelocities.at(i), newEvents);
+                }
+                SortEvents(newEvents);
+                events.insert(events.end(), newEvents.begin(), newEvents.end());
+            }
+
+            hasPrevious = true;
+            previousTime = time;
+            previousPoints = points;
+            previousRadialVelocities = radialVelocities;
+        }
+    }
+
+    auto NewBodyReset(const SimulationState &initialState) -> void {
+        std::lock_guard<std::mutex> lock(mutex);
+        const unordered_map<string, OrbitPoint> &statePoints = initialState.GetOrbitPoints();
+        ids.clear();
+        for (const auto &pair : statePoints) {
+            ids.push_back(pair.first);
+        }
+        std::sort(ids.begin(), ids.end());
+
+        vector<OrbitPoint> points;
+        for (const string &id : ids) {
+            points.push_back(statePoints.at(id));
+        }
+        GeneratePairs(points);
+
+        hasPrevious = false;
+        events.clear();
+    }
+
+    auto AddState(const SimulationState &state) -> void {
+        ZoneScoped;
+        const unordered_map<string, OrbitPoint> &statePoints = state.GetOrbitPoints();
+        vector<OrbitPoint> points;
+        points.reserve(ids.size());
+        for (const string &id : ids) {
+            points.push_back(statePoints.at(id));
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        Detect(state.GetTime(), points);
+    }
+
+    auto AddStates(const vector<double> &times, const vector<OrbitPoint> &points) -> void {
+        ZoneScoped;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (unsigned int state = 0; state < times.size(); state++) {
+            const auto first = points.begin() + long(state * ids.size());
+            Detect(times.at(state), vector<OrbitPoint>(first, first + long(ids.size())));
+        }
+    }
+
+    auto RedetectBody(const string &id, const vector<double> &times, const vector<OrbitPoint> &points) -> void {
+        ZoneScoped;
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto index = std::lower_bound(ids.begin(), ids.end(), id);
+        if ((index == ids.end()) || (*index != id) || times.empty()) {
+            return;
+        }
+        const unsigned int body = index - ids.begin();
+        const unsigned int bodyCount = ids.size();
+
+        // Every event involving the body after the first state may have changed
+        events.erase(std::remove_if(events.begin(), events.end(), [&id, &times](const Event &event) {
+            return (event.time > times.front()) && ((event.id == id) || (event.otherId == id));
+        }), events.end());
+
+        vector<Event> newEvents;
+        for (unsigned int i = 0; i < pairs.size(); i++) {
+            const Pair &pair = pairs.at(i);
+            if ((pair.body != body) && (pair.other != body)) {
+                continue;
+            }
+
+            double startRadial = Hermite::GetRadialVelocity(points.at(pair.body), points.at(pair.other));
+            for (unsigned int state = 0; state + 1 < times.size(); state++) {
+                const unsigned int start = state * bodyCount;
+                const unsigned int end = (state + 1) * bodyCount;
+                const double endRadial = Hermite::GetRadialVelocity(points.at(end + pair.body), points.at(end + pair.other));
+                DetectPair(pair, times.at(state), times.at(state + 1),
+                    points.at(start + pair.body), points.at(end + pair.body), points.at(start + pair.other), points.at(end + pair.other),
+                    startRadial, endRadial, newEvents);
+                startRadial = endRadial;
+            }
+
+            // Detection continues from the last state, which must be the last state that was added
+            if (hasPrevious) {
+                previousRadialVelocities.at(i) = startRadial;
+            }
+        }
+        if (hasPrevious) {
+            previousPoints.at(body) = points.at(((times.size() - 1) * bodyCount) + body);
+        }
+
+        events.insert(events.end(), newEvents.begin(), newEvents.end());
+        SortEvents(events);
+    }
+
+    auto StepToTime(const double time) -> void {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto firstFuture = std::lower_bound(events.begin(), events.end(), time,
+            [](const Event &event, const double time) { return event.time < time; });
+        const unsigned int pastEvents = firstFuture - events.begin();
+        if (pastEvents > MAX_PAST_EVENTS) {
+            events.erase(events.begin(), events.begin() + (pastEvents - MAX_PAST_EVENTS));
+        }
+    }
+
+    auto GetEvents(const double startTime, const double endTime) -> vector<Event> {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto start = std::lower_bound(events.begin(), events.end(), startTime,
+            [](const Event &event, const double time) { return event.time < time; });
+        const auto end = std::upper_bound(start, events.end(), endTime,
+            [](const double time, const Event &event) { return time < event.time; });
+        return vector<Event>(start, end);
+    }
+
+    auto GetTypeName(const EventType type) -> string {
+        switch (type) {
+            case EVENT_TYPE_PERIAPSIS: return "Periapsis";
+            case EVENT_TYPE_APOAPSIS: return "Apoapsis";
+            case EVENT_TYPE_CLOSEST_APPROACH: return "Closest approach";
+        }
+        return "";
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <simulation/OrbitPoint.h>
+#include <simulation/SimulationState.h>
+#include <util/Types.h>
+
+
+
+enum EventType {
+    EVENT_TYPE_PERIAPSIS,
+    EVENT_TYPE_APOAPSIS,
+    EVENT_TYPE_CLOSEST_APPROACH
+};
+
+struct Event {
+    EventType type;
+    string id;
+    string otherId; // the primary for periapsis and apoapsis
+    double time;
+    double distance; // m
+    dvec3 position;
+    dvec3 otherPosition;
+};
+
+// Detects orbital events as the prediction is extended, one step at a time
+// Periapsis and apoapsis are found relative to each body's primary (the more massive body pulling on it hardest
+// at the start), and closest approaches between every other pair of bodies in small scenarios
+// Events are safe to query from any thread
+namespace Events {
+    auto NewBodyReset(const SimulationState &initialState) -> void;
+
+    // States must be added in time order
+    auto AddState(const SimulationState &state) -> void;
+
+    // Adds states in the layout used by Trajectory::GetStates, with bodies ordered by id
+    auto AddStates(const vector<double> &times, const vector<OrbitPoint> &points) -> void;
+
+    // Replaces every event involving one body after the first of the given states, for when only that body's path has
+    // changed; states are in the same layout as for AddStates, and the last must be the last state added
+    auto RedetectBody(const string &id, const vector<double> &times, const vector<OrbitPoint> &points) -> void;
+
+    // Events before time may be discarded
+    auto StepToTime(const double time) -> void;
+
+    // Sorted by time
+    auto GetEvents(const double startTime, const double endTime) -> vector<Event>;
+
+    auto GetTypeName(const EventType type) -> string;
+}
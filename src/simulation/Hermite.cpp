@@ -0,0 +1,81 @@
+#include "Hermite.h"
+
+#include <glm/geometric.hpp>
+
+
+
+namespace Hermite {
+    namespace {
+        const unsigned int MAX_ROOT_ITERATIONS = 50;
+        const double ROOT_TOLERANCE = 1.0e-9;
+    }
+
+    auto Interpolate(const OrbitPoint &start, const OrbitPoint &end, const double interval, const double fraction) -> OrbitPoint {
+        const double s = fraction;
+        const double s2 = s * s;
+        const double s3 = s2 * s;
+
+        // Basis functions for the start position, start tangent, end position and end tangent
+        const double h00 = (2 * s3) - (3 * s2) + 1;
+        const double h10 = s3 - (2 * s2) + s;
+        const double h01 = (-2 * s3) + (3 * s2);
+        const double h11 = s3 - s2;
+
+        // and their derivatives with respect to s, divided by the interval to get a velocity
+        const double d00 = (6 * s2) - (6 * s);
+        const double d10 = (3 * s2) - (4 * s) + 1;
+        const double d01 = (-6 * s2) + (6 * s);
+        const double d11 = (3 * s2) - (2 * s);
+
+        const dvec3 startTangent = start.velocity * interval;
+        const dvec3 endTangent = end.velocity * interval;
+
+        return OrbitPoint{
+            (h00 * start.position) + (h10 * startTangent) + (h01 * end.position) + (h11 * endTangent),
+            ((d00 * start.position) + (d10 * startTangent) + (d01 * end.position) + (d11 * endTangent)) / interval};
+    }
+
+    auto GetRadialVelocity(const OrbitPoint &body, const OrbitPoint &other) -> double {
+        return glm::dot(body.position - other.position, body.velocity - other.velocity);
+    }
+
+    auto FindRadialVelocityRoot(const OrbitPoint &bodyStart, const OrbitPoint &bodyEnd, const OrbitPoint &otherStart, const OrbitPoint &otherEnd, const double interval) -> double {
+        // Illinois false position; the root is known to be bracketed, and this converges much faster than bisection
+        // while staying just as safe
+        double start = 0;
+        double end = 1;
+        double startRadial = GetRadialVelocity(bodyStart, otherStart);
+        double endRadial = GetRadialVelocity(bodyEnd, otherEnd);
+        double fraction = 0.5;
+        int side = 0;
+
+        for (unsigned int i = 0; (i < MAX_ROOT_ITERATIONS) && (end - start > ROOT_TOLERANCE); i++) {
+            fraction = ((start * endRadial) - (end * startRadial)) / (endRadial - startRadial);
+            const double radial = GetRadialVelocity(
+                Interpolate(bodyStart, bodyEnd, interval, fraction),
+                Interpolate(otherStart, otherEnd, interval, fraction));
+
+            if (radial == 0) {
+                break;
+            }
+
+            if ((radial > 0) == (endRadial > 0)) {
+                end = fraction;
+                endRadial = radial;
+                if (side == -1) {
+                    startRadial /= 2;
+                }
+                side = -1;
+            } else {
+                start = fraction;
+                startRadial = radial;
+                if (side == 1) {
+                    endRadial /= 2;
+                }
+                side = 1;
+            }
+        }
+
+        return fraction;
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <simulation/OrbitPoint.h>
+#include <util/Types.h>
+
+
+
+namespace Hermite {
+    // Cubic Hermite interpolation between two states interval seconds apart, fraction being 0 at start and 1 at end
+    // Position and velocity at both ends match exactly, so interpolated motion is smooth across consecutive intervals
+    auto Interpolate(const OrbitPoint &start, const OrbitPoint &end, const double interval, const double fraction) -> OrbitPoint;
+
+    // Proportional to the rate of change of the distance between two bodies, so zero at every minimum and maximum of it
+    auto GetRadialVelocity(const OrbitPoint &body, const OrbitPoint &other) -> double;
+
+    // The fraction of the interval at which the radial velocity of two interpolated bodies crosses zero
+    // The radial velocity must have opposite signs at the start and end
+    auto FindRadialVelocityRoot(const OrbitPoint &bodyStart, const OrbitPoint &bodyEnd, const OrbitPoint &otherStart, const OrbitPoint &otherEnd, const double interval) -> double;
+}
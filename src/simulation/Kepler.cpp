@@ -0,0 +1,85 @@
+#include "Kepler.h"
+
+#include <glm/geometric.hpp>
+
+#include <cmath>
+
+
+
+namespace Kepler {
+    namespace {
+        const double SERIES_THRESHOLD = 1.0e-6;
+        const unsigned int MAX_ITERATIONS = 50;
+        const double TOLERANCE = 1.0e-12; // relative to the universal anomaly
+    }
+
+    auto C(const double z) -> double {
+        if (z > SERIES_THRESHOLD) {
+            return (1 - std::cos(std::sqrt(z))) / z;
+        }
+        if (z < -SERIES_THRESHOLD) {
+            return (std::cosh(std::sqrt(-z)) - 1) / -z;
+        }
+        return (1.0 / 2.0) - (z / 24.0);
+    }
+
+    auto S(const double z) -> double {
+        if (z > SERIES_THRESHOLD) {
+            const double root = std::sqrt(z);
+            return (root - std::sin(root)) / (root * root * root);
+        }
+        if (z < -SERIES_THRESHOLD) {
+            const double root = std::sqrt(-z);
+            return (std::sinh(root) - root) / (root * root * root);
+        }
+        return (1.0 / 6.0) - (z / 120.0);
+    }
+
+    auto Propagate(const OrbitPoint &point, const double mu, const double timeStep) -> OrbitPoint {
+        // Curtis, Orbital Mechanics for Engineering Students, algorithms 3.3 and 3.4
+        const double r0 = glm::length(point.position);
+        const double v0 = glm::length(point.velocity);
+        if ((r0 == 0) || (mu <= 0) || (timeStep == 0)) {
+            return point;
+        }
+
+        const double rootMu = std::sqrt(mu);
+        const double radialVelocity = glm::dot(point.position, point.velocity) / r0;
+        const double alpha = (2 / r0) - (v0 * v0 / mu); // reciprocal of the semi-major axis
+
+        // Newton's method on the universal Kepler equation for the universal anomaly x, starting from Vallado's
+        // estimates (Fundamentals of Astrodynamics, algorithm 8), since the elliptic one is far too large for hyperbolas
+        double x = rootMu * alpha * timeStep;
+        if (alpha < -SERIES_THRESHOLD / r0) {
+            const double a = 1 / alpha;
+            const double sign = (timeStep > 0) ? 1 : -1;
+            x = sign * std::sqrt(-a) * std::log((-2 * mu * alpha * timeStep)
+                / (glm::dot(point.position, point.velocity) + (sign * std::sqrt(-mu * a) * (1 - (r0 * alpha)))));
+        } else if (alpha <= SERIES_THRESHOLD / r0) {
+            x = rootMu * timeStep / r0;
+        }
+        for (unsigned int i = 0; i < MAX_ITERATIONS; i++) {
+            const double z = alpha * x * x;
+            const double c = C(z);
+            const double s = S(z);
+            const double F = (r0 * radialVelocity / rootMu * x * x * c) + ((1 - (alpha * r0)) * x * x * x * s) + (r0 * x) - (rootMu * timeStep);
+            const double derivative = (r0 * radialVelocity / rootMu * x * (1 - (z * s))) + ((1 - (alpha * r0)) * x * x * c) + r0;
+            const double correction = F / derivative;
+            x -= correction;
+            if (std::abs(correction) <= TOLERANCE * std::abs(x)) {
+                break;
+            }
+        }
+
+        const double z = alpha * x * x;
+        const double c = C(z);
+        const double s = S(z);
+        const double f = 1 - (x * x / r0 * c);
+        const double g = timeStep - (x * x * x / rootMu * s);
+        const dvec3 position = (f * point.position) + (g * point.velocity);
+        const double r = glm::length(position);
+        const double fDot = rootMu / (r * r0) * ((z * x * s) - x);
+        const double gDot = 1 - (x * x / r * c);
+        return OrbitPoint{position, (fDot * point.position) + (gDot * point.velocity)};
+    }
+}
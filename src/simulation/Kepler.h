@@ -0,0 +1,16 @@
+#pragma once
+
+#include <simulation/OrbitPoint.h>
+#include <util/Types.h>
+
+
+
+// Closed-form two-body motion in universal variables, which work the same for elliptic, parabolic and hyperbolic orbits
+namespace Kepler {
+    // Stumpff functions C(z) and S(z)
+    auto C(const double z) -> double;
+    auto S(const double z) -> double;
+
+    // Moves a point, relative to the central body, timeStep seconds along its orbit; mu is G * (sum of both masses)
+    auto Propagate(const OrbitPoint &point, const double mu, const double timeStep) -> OrbitPoint;
+}
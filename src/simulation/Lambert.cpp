@@ -0,0 +1,99 @@
+#include "Lambert.h"
+
+#include <simulation/Kepler.h>
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+
+
+namespace Lambert {
+    namespace {
+        // Universal variable z is the square of the change in eccentric anomaly, so 4 pi^2 is one whole revolution;
+        // the lower bound is far enough into hyperbolic orbits for any transfer worth considering
+        const double MAX_Z = 4.0 * M_PI * M_PI;
+        const double MIN_Z = -4.0 * M_PI * M_PI;
+
+        const unsigned int MAX_ITERATIONS = 60;
+        const double TOLERANCE = 1.0e-10; // relative to the time of flight
+        const double SERIES_THRESHOLD = 1.0e-6;
+    }
+
+    auto Solve(const dvec3 &r1, const dvec3 &r2, const double timeOfFlight, const double mu, const dvec3 &normal, dvec3 &v1, dvec3 &v2) -> bool {
+        // Curtis, Orbital Mechanics for Engineering Students, algorithm 5.2, with Newton's method kept inside a
+        // bracket that shrinks every iteration, so it can fall back to bisection wherever Newton would diverge
+        if (timeOfFlight <= 0) {
+            return false;
+        }
+
+        const double r1Length = glm::length(r1);
+        const double r2Length = glm::length(r2);
+        const double cosAngle = std::clamp(glm::dot(r1, r2) / (r1Length * r2Length), -1.0, 1.0);
+        double angle = std::acos(cosAngle);
+        if (glm::dot(glm::cross(r1, r2), normal) < 0) {
+            angle = (2 * M_PI) - angle;
+        }
+
+        // Transfers through exactly 0 or 180 degrees don't define a plane
+        const double A = std::sin(angle) * std::sqrt(r1Length * r2Length / (1 - cosAngle));
+        if (!std::isfinite(A) || (A == 0)) {
+            return false;
+        }
+
+        const double target = std::sqrt(mu) * timeOfFlight;
+        double low = MIN_Z;
+        double high = MAX_Z;
+        double z = 0;
+        double y = 0;
+        bool converged = false;
+
+        for (unsigned int i = 0; i < MAX_ITERATIONS; i++) {
+            const double c = Kepler::C(z);
+            const double s = Kepler::S(z);
+            y = r1Length + r2Length + (A * ((z * s) - 1) / std::sqrt(c));
+
+            // Orbits with y below zero don't exist, and the time of flight increases with z, so the answer is above
+            if (y <= 0) {
+                low = z;
+                z = (low + high) / 2;
+                continue;
+            }
+
+            const double yOverC = y / c;
+            const double F = (yOverC * std::sqrt(yOverC) * s) + (A * std::sqrt(y)) - target;
+            if (std::abs(F) < TOLERANCE * target) {
+                converged = true;
+                break;
+            }
+            if (F < 0) {
+                low = z;
+            } else {
+                high = z;
+            }
+
+            double derivative = 0;
+            if (std::abs(z) > SERIES_THRESHOLD) {
+                derivative = (yOverC * std::sqrt(yOverC) * (((1 / (2 * z)) * (c - (3 * s / (2 * c)))) + (3 * s * s / (4 * c))))
+                    + ((A / 8) * ((3 * s * std::sqrt(y) / c) + (A * std::sqrt(c / y))));
+            } else {
+                derivative = (std::sqrt(2.0) / 40 * y * std::sqrt(y)) + ((A / 8) * (std::sqrt(y) + (A * std::sqrt(1 / (2 * y)))));
+            }
+
+            const double next = z - (F / derivative);
+            z = ((next > low) && (next < high)) ? next : (low + high) / 2;
+        }
+
+        if (!converged) {
+            return false;
+        }
+
+        const double f = 1 - (y / r1Length);
+        const double g = A * std::sqrt(y / mu);
+        const double gDot = 1 - (y / r2Length);
+        v1 = (r2 - (f * r1)) / g;
+        v2 = ((gDot * r2) - r1) / g;
+        return true;
+    }
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <util/Types.h>
+
+
+
+namespace Lambert {
+    // Finds the two-body orbit that goes from position r1 to position r2 in timeOfFlight seconds, without completing
+    // a whole revolution, and travels round in the same sense as normal (the direction of its angular momentum)
+    // Positions are relative to the central body, and mu is G * (mass of the central body)
+    // Returns false if no such orbit was found; v1 and v2 are the velocities at r1 and r2
+    auto Solve(const dvec3 &r1, const dvec3 &r2, const double timeOfFlight, const double mu, const dvec3 &normal, dvec3 &v1, dvec3 &v2) -> bool;
+}
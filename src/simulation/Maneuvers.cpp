@@ -0,0 +1,302 @@
+#include "Maneuvers.h"
+
+#include <simulation/Encke.h>
+#include <simulation/Hermite.h>
+#include <simulation/SoiHierarchy.h>
+#include <main/Bodies.h>
+#include <util/Constants.h>
+#include <util/Log.h>
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+
+
+namespace Maneuvers {
+    namespace {
+        std::mutex mutex;
+
+        double gridStartTime = 0;
+        double gridStepSize = 1;
+
+        vector<ManeuverNode> nodes;
+        unordered_map<string, double> edits;
+
+        auto AddEdit(const string &id, const double time) -> void {
+            const auto edit = edits.find(id);
+            if (edit == edits.end()) {
+                edits[id] = time;
+            } else {
+                edit->second = std::min(edit->second, time);
+            }
+        }
+
+        auto ToInertial(const ManeuverNode &node, const OrbitPoint &body, const OrbitPoint &primary) -> dvec3 {
+            dvec3 prograde;
+            dvec3 normal;
+            dvec3 radial;
+            GetFrame(body, primary, prograde, normal, radial);
+            return (node.deltaV.x * prograde) + (node.deltaV.y * normal) + (node.deltaV.z * radial);
+        }
+
+        auto IsDue(const ManeuverNode &node, const double previousTime, const double time) -> bool {
+            // Step times drift slightly from the grid as they are accumulated, so a node is due at the step nearest to it
+            const double tolerance = gridStepSize / 2;
+            return (node.time > previousTime + tolerance) && (node.time <= time + tolerance);
+        }
+
+        auto InterpolateBody(const vector<double> &times, const vector<OrbitPoint> &points, const unsigned int bodyCount, const unsigned int body, const unsigned int sample, const double fraction) -> OrbitPoint {
+            return Hermite::Interpolate(
+                points.at((sample * bodyCount) + body),
+                points.at(((sample + 1) * bodyCount) + body),
+                times.at(sample + 1) - times.at(sample),
+                fraction);
+        }
+
+        // skip is the index of a massive body to leave out, so the acceleration of a massive body can be calculated
+        auto CalculateAcceleration(const dvec3 &position, const vector<OrbitPoint> &massivePoints, const vector<double> &massiveParameters, const int skip = -1) -> dvec3 {
+            dvec3 acceleration = dvec3(0, 0, 0);
+            for (unsigned int i = 0; i < massivePoints.size(); i++) {
+                if ((int(i) == skip) || (massiveParameters.at(i) == 0)) {
+                    continue;
+                }
+                const dvec3 displacement = massivePoints.at(i).position - position;
+                const double distance = glm::length(displacement);
+                acceleration += displacement * (massiveParameters.at(i) / (distance * distance * distance));
+            }
+            return acceleration;
+        }
+
+        auto FoldMerges(const vector<bool> &merges, const vector<OrbitPoint> &massivePoints, const vector<double> &bodyMasses, vector<double> &masses, vector<double> &parameters) -> void {
+            // A body the prediction merges sits exactly on the body it merged into from then on, so once it is found on
+            // top of another body its mass is added to that body's and it no longer pulls on anything itself
+            masses = bodyMasses;
+            for (unsigned int i = 0; i < masses.size(); i++) {
+                if (!merges.at(i)) {
+                    continue;
+                }
+                for (unsigned int j = 0; j < masses.size(); j++) {
+                    if ((j != i) && (masses.at(j) > 0) && (massivePoints.at(j).position == massivePoints.at(i).position)) {
+                        masses.at(j) += masses.at(i);
+                        masses.at(i) = 0;
+                        break;
+                    }
+                }
+            }
+
+            for (unsigned int i = 0; i < masses.size(); i++) {
+                parameters.at(i) = GRAVITATIONAL_CONSTANT * masses.at(i);
+            }
+        }
+
+        auto CalculatePerturbation(const OrbitPoint &point, const dvec3 &acceleration, const OrbitPoint &primary, const dvec3 &primaryAcceleration, const double mu) -> dvec3 {
+            // The same as SimulationState::CalculatePerturbation
+            const dvec3 displacement = point.position - primary.position;
+            const double distance = glm::length(displacement);
+            return acceleration - primaryAcceleration + (displacement * (mu / (distance * distance * distance)));
+        }
+    }
+
+    auto NewBodyReset(const double startTime, const double stepSize) -> void {
+        std::lock_guard<std::mutex> lock(mutex);
+        gridStartTime = startTime;
+        gridStepSize = stepSize;
+        nodes.clear();
+        edits.clear();
+    }
+
+    auto Add(const string &id, const double time) -> bool {
+        // Moving a massive body would change the path of everything else, which needs a full reset
+        if (Bodies::GetMasslessBodies().count(id) == 0) {
+            Log(WARN, "Maneuver nodes can only be added to massless bodies");
+            return false;
+        }
+
+        const string primaryId = Bodies::FindStrongestPull(id, {});
+        if (primaryId.empty()) {
+            Log(WARN, "Maneuver nodes need a massive body to measure directions relative to");
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        const double snappedTime = gridStartTime + (std::round((time - gridStartTime) / gridStepSize) * gridStepSize);
+        nodes.push_back(ManeuverNode{id, primaryId, snappedTime, dvec3(0, 0, 0)});
+        std::stable_sort(nodes.begin(), nodes.end(), [](const ManeuverNode &a, const ManeuverNode &b) { return a.time < b.time; });
+        return true;
+    }
+
+    auto Remove(const unsigned int index) -> void {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (index < nodes.size()) {
+            AddEdit(nodes.at(index).id, nodes.at(index).time);
+            nodes.erase(nodes.begin() + index);
+        }
+    }
+
+    auto SetDeltaV(const unsigned int index, const dvec3 &deltaV) -> void {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (index < nodes.size()) {
+            nodes.at(index).deltaV = deltaV;
+            AddEdit(nodes.at(index).id, nodes.at(index).time);
+        }
+    }
+
+    auto GetNodes() -> vector<ManeuverNode> {
+        std::lock_guard<std::mutex> lock(mutex);
+        return nodes;
+    }
+
+    auto TakeEdits() -> unordered_map<string, double> {
+        std::lock_guard<std::mutex> lock(mutex);
+        unordered_map<string, double> taken;
+        std::swap(taken, edits);
+        return taken;
+    }
+
+    auto Apply(SimulationState &state, const double previousTime) -> void {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const ManeuverNode &node : nodes) {
+            if (!IsDue(node, previousTime, state.GetTime())) {
+                continue;
+            }
+            OrbitPoint point = state.GetOrbitPoints().at(node.id);
+            point.velocity += ToInertial(node, point, state.GetOrbitPoints().at(node.primaryId));
+            state.SetOrbitPoint(node.id, point, state.GetOldAcceleration(node.id));
+        }
+    }
+
+    auto GetFrame(const OrbitPoint &body, const OrbitPoint &primary, dvec3 &prograde, dvec3 &normal, dvec3 &radial) -> void {
+        const dvec3 position = body.position - primary.position;
+        const dvec3 velocity = body.velocity - primary.velocity;
+        prograde = glm::normalize(velocity);
+        normal = glm::normalize(glm::cross(position, velocity));
+        radial = glm::cross(prograde, normal);
+    }
+
+    auto Repropagate(const string &id, const vector<string> &ids, const vector<double> &times, vector<OrbitPoint> &points, const unordered_map<string, string> &absorbed, vector<PathVertex> &vertices) -> dvec3 {
+        ZoneScoped;
+        const unsigned int bodyCount = ids.size();
+        const unsigned int body = std::find(ids.begin(), ids.end(), id) - ids.begin();
+
+        vector<unsigned int> massiveIndices;
+        vector<string> massiveIds;
+        vector<double> bodyMasses;
+        vector<bool> merges;
+        unordered_map<string, unsigned int> massiveLookup;
+        for (unsigned int i = 0; i < bodyCount; i++) {
+            const auto massive = Bodies::GetMassiveBodies().find(ids.at(i));
+            if ((massive != Bodies::GetMassiveBodies().end()) && !Bodies::IsAbsorbed(ids.at(i))) {
+                massiveLookup[ids.at(i)] = massiveIndices.size();
+                massiveIndices.push_back(i);
+                massiveIds.push_back(ids.at(i));
+                bodyMasses.push_back(massive->second.GetMass());
+                merges.push_back(absorbed.find(ids.at(i)) != absorbed.end());
+            }
+        }
+        vector<double> massiveMasses;
+        vector<double> massiveParameters(massiveIndices.size());
+
+        vector<ManeuverNode> bodyNodes;
+        vector<unsigned int> primaryIndices;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const ManeuverNode &node : nodes) {
+                if (node.id == id) {
+                    bodyNodes.push_back(node);
+                    primaryIndices.push_back(std::find(ids.begin(), ids.end(), node.primaryId) - ids.begin());
+                }
+            }
+        }
+
+        vector<OrbitPoint> massivePoints(massiveIndices.size());
+        for (unsigned int i = 0; i < massiveIndices.size(); i++) {
+            massivePoints.at(i) = points.at(massiveIndices.at(i));
+        }
+        FoldMerges(merges, massivePoints, bodyMasses, massiveMasses, massiveParameters);
+
+        // Encke's method around the body's parent in the sphere-of-influence hierarchy, as SimulationState integrates
+        // massless bodies, so the recomputed path matches the one it replaces up to the first node; the reference
+        // orbit is seeded from the first state, and again after a change of parent or a burn
+        const double tolerance = gridStepSize / 2;
+        const double bodyMass = Bodies::GetBody(id).GetMass();
+        OrbitPoint point = points.at(body);
+        double time = times.front();
+        dvec3 acceleration = CalculateAcceleration(point.position, massivePoints, massiveParameters);
+        SoiHierarchy hierarchy;
+        int hierarchySample = -1;
+        EnckeOrbit orbit;
+        bool seeded = false;
+
+        PathSampler sampler;
+        sampler.ResumeBody(id, point);
+
+        unsigned int sample = 0;
+        while (sample + 1 < times.size()) {
+            // The parent is found from where the bodies are at the start of the step, like SimulationState does
+            // This runs between frames for every grid step to the horizon, so which massive body is whose parent is
+            // only redone once per stored state, and the hierarchy is just moved along in between
+            if (hierarchySample != int(sample)) {
+                FoldMerges(merges, massivePoints, bodyMasses, massiveMasses, massiveParameters);
+                hierarchy.Build(massiveIds, massivePoints, massiveMasses);
+                hierarchySample = int(sample);
+            } else {
+                hierarchy.Move(massivePoints);
+            }
+            const int parent = hierarchy.FindParent(id, point.position);
+            const int primary = (parent < 0) ? -1 : int(massiveLookup.at(hierarchy.GetId(parent)));
+            const double mu = (parent < 0) ? 0 : GRAVITATIONAL_CONSTANT * (hierarchy.GetMass(parent) + bodyMass);
+            if ((primary >= 0) && (!seeded || (orbit.primaryId != hierarchy.GetId(parent)))) {
+                const OrbitPoint &primaryPoint = massivePoints.at(primary);
+                const dvec3 primaryAcceleration = CalculateAcceleration(primaryPoint.position, massivePoints, massiveParameters, primary);
+                const OrbitPoint relative{point.position - primaryPoint.position, point.velocity - primaryPoint.velocity};
+                orbit = Encke::Seed(hierarchy.GetId(parent), relative, CalculatePerturbation(point, acceleration, primaryPoint, primaryAcceleration, mu));
+                seeded = true;
+            }
+
+            const double previousTime = time;
+            time += gridStepSize;
+            const bool reachedSample = std::abs(times.at(sample + 1) - time) < tolerance;
+            const double fraction = reachedSample ? 1 : (time - times.at(sample)) / (times.at(sample + 1) - times.at(sample));
+            for (unsigned int i = 0; i < massiveIndices.size(); i++) {
+                massivePoints.at(i) = InterpolateBody(times, points, bodyCount, massiveIndices.at(i), sample, fraction);
+            }
+
+            if (primary >= 0) {
+                const OrbitPoint &primaryPoint = massivePoints.at(primary);
+                point.position = primaryPoint.position + Encke::Drift(orbit, mu, gridStepSize);
+                acceleration = CalculateAcceleration(point.position, massivePoints, massiveParameters);
+                const dvec3 primaryAcceleration = CalculateAcceleration(primaryPoint.position, massivePoints, massiveParameters, primary);
+                const dvec3 perturbation = CalculatePerturbation(point, acceleration, primaryPoint, primaryAcceleration, mu);
+                point.velocity = primaryPoint.velocity + Encke::Kick(orbit, mu, perturbation, gridStepSize);
+            } else {
+                // Without any massive bodies there is no parent, and nothing to integrate against
+                point.position += (point.velocity * gridStepSize) + (0.5 * acceleration * gridStepSize * gridStepSize);
+                point.velocity += 0.5 * acceleration * gridStepSize;
+                acceleration = CalculateAcceleration(point.position, massivePoints, massiveParameters);
+                point.velocity += 0.5 * acceleration * gridStepSize;
+            }
+
+            for (unsigned int i = 0; i < bodyNodes.size(); i++) {
+                if (IsDue(bodyNodes.at(i), previousTime, time)) {
+                    const OrbitPoint primaryPoint = InterpolateBody(times, points, bodyCount, primaryIndices.at(i), sample, fraction);
+                    point.velocity += ToInertial(bodyNodes.at(i), point, primaryPoint);
+
+                    // The point no longer follows from the reference orbit, so a new one is started from it
+                    seeded = false;
+                }
+            }
+
+            sampler.SampleBody(id, point, time, vertices);
+
+            if (reachedSample) {
+                sample++;
+                points.at((sample * bodyCount) + body) = point;
+            }
+        }
+
+        return acceleration;
+    }
+}
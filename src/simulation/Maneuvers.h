@@ -0,0 +1,46 @@
+#pragma once
+
+#include <simulation/OrbitPoint.h>
+#include <simulation/PathSampler.h>
+#include <simulation/SimulationState.h>
+#include <util/Types.h>
+
+
+
+struct ManeuverNode {
+    string id;
+    string primaryId;
+    double time;
+    dvec3 deltaV; // m/s along the prograde, normal and radial directions relative to the primary
+};
+
+// Impulsive changes in velocity planned for massless bodies
+// Massless bodies don't pull on anything, so editing a node only changes its own body's path from the node onwards,
+// which can be recomputed against the stored paths of the massive bodies without touching anything else
+namespace Maneuvers {
+    // Nodes are snapped to the integration steps that follow startTime, so they are applied at exactly their time
+    auto NewBodyReset(const double startTime, const double stepSize) -> void;
+
+    // Returns false if the body can't have nodes
+    auto Add(const string &id, const double time) -> bool;
+    auto Remove(const unsigned int index) -> void;
+    auto SetDeltaV(const unsigned int index, const dvec3 &deltaV) -> void;
+
+    // Sorted by time
+    auto GetNodes() -> vector<ManeuverNode>;
+
+    // The earliest time each body's predicted path is out of date from, for every body edited since this was last called
+    auto TakeEdits() -> unordered_map<string, double>;
+
+    // Applies every node after previousTime and up to the time of state
+    auto Apply(SimulationState &state, const double previousTime) -> void;
+
+    // Unit vectors along which a node's delta-v is measured
+    auto GetFrame(const OrbitPoint &body, const OrbitPoint &primary, dvec3 &prograde, dvec3 &normal, dvec3 &radial) -> void;
+
+    // Recomputes the path of one massless body through states in the layout used by Trajectory::GetStates, starting
+    // from its point in the first state, while the massive bodies follow their stored paths
+    // absorbed maps each body the prediction merges to the body it merged into, as in SimulationState::GetAbsorbed
+    // Returns the body's acceleration at the last state
+    auto Repropagate(const string &id, const vector<string> &ids, const vector<double> &times, vector<OrbitPoint> &points, const unordered_map<string, string> &absorbed, vector<PathVertex> &vertices) -> dvec3;
+}
@@ -0,0 +1,66 @@
+#include "OrbitalElements.h"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+
+
+namespace OrbitalElementsUtil {
+    namespace {
+        // Below this, eccentricity or inclination are treated as zero and the angles they define fall back to zero
+        const double SMALL = 1e-11;
+        const double TWO_PI = 2.0 * M_PI;
+
+        auto AngleBetween(const dvec3 &a, const dvec3 &b) -> double {
+            return std::acos(std::clamp(glm::dot(a, b) / (glm::length(a) * glm::length(b)), -1.0, 1.0));
+        }
+    }
+
+    auto Calculate(const dvec3 &position, const dvec3 &velocity, const double mu) -> OrbitalElements {
+        // https://en.wikipedia.org/wiki/Orbital_elements (using y as the reference 'up' axis, like the rest of the renderer)
+        const dvec3 up = dvec3(0, 1, 0);
+        const dvec3 reference = dvec3(1, 0, 0);
+
+        const double r = glm::length(position);
+        const double v = glm::length(velocity);
+        const dvec3 h = glm::cross(position, velocity);
+        const dvec3 node = glm::cross(up, h);
+        const dvec3 eccentricityVector = (glm::cross(velocity, h) / mu) - (position / r);
+
+        OrbitalElements elements {};
+        elements.eccentricity = glm::length(eccentricityVector);
+        elements.semiMajorAxis = 1.0 / ((2.0 / r) - ((v * v) / mu));
+        elements.inclination = AngleBetween(h, up);
+
+        if (glm::length(node) > SMALL) {
+            elements.longitudeOfAscendingNode = AngleBetween(reference, node);
+            if (node.z > 0) {
+                elements.longitudeOfAscendingNode = TWO_PI - elements.longitudeOfAscendingNode;
+            }
+        }
+
+        if (elements.eccentricity > SMALL) {
+            if (glm::length(node) > SMALL) {
+                elements.argumentOfPeriapsis = AngleBetween(node, eccentricityVector);
+                if (glm::dot(eccentricityVector, up) < 0) {
+                    elements.argumentOfPeriapsis = TWO_PI - elements.argumentOfPeriapsis;
+                }
+            }
+            elements.trueAnomaly = AngleBetween(eccentricityVector, position);
+            if (glm::dot(position, velocity) < 0) {
+                elements.trueAnomaly = TWO_PI - elements.trueAnomaly;
+            }
+        }
+
+        return elements;
+    }
+
+    auto GetPeriod(const OrbitalElements &elements, const double mu) -> double {
+        if ((elements.eccentricity >= 1) || (elements.semiMajorAxis <= 0)) {
+            return 0;
+        }
+        return TWO_PI * std::sqrt(elements.semiMajorAxis * elements.semiMajorAxis * elements.semiMajorAxis / mu);
+    }
+}
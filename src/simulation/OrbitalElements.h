@@ -0,0 +1,23 @@
+#pragma once
+
+#include <util/Types.h>
+
+
+
+// Classical (osculating) Keplerian elements of a two-body orbit; angles are in radians
+struct OrbitalElements {
+    double semiMajorAxis;   // m, negative for hyperbolic orbits
+    double eccentricity;
+    double inclination;
+    double longitudeOfAscendingNode;
+    double argumentOfPeriapsis;
+    double trueAnomaly;
+};
+
+namespace OrbitalElementsUtil {
+    // position and velocity are relative to the central body, and mu is G * (mass of central body + mass of orbiting body)
+    auto Calculate(const dvec3 &position, const dvec3 &velocity, const double mu) -> OrbitalElements;
+
+    // Returns 0 for orbits that are not closed
+    auto GetPeriod(const OrbitalElements &elements, const double mu) -> double;
+}
@@ -0,0 +1,156 @@
+#include "OsculatingElements.h"
+
+#include <main/Bodies.h>
+#include <util/Constants.h>
+#include <util/Parallel.h>
+
+#include <tracy/Tracy.hpp>
+
+
+
+namespace OsculatingElements {
+    namespace {
+        // Massive bodies are kept as separate flat arrays so the search for each body's primary is a tight loop
+        vector<string> massiveIds;
+        vector<double> massiveX;
+        vector<double> massiveY;
+        vector<double> massiveZ;
+        vector<double> massiveVX;
+        vector<double> massiveVY;
+        vector<double> massiveVZ;
+        vector<double> massiveMass;
+
+        vector<string> bodyIds;
+        vector<OrbitPoint> bodyPoints;
+        vector<double> bodyMass;
+
+        // Written by the simulation thread, and swapped into the published batch between updates
+        // Bodies without a primary are left with an empty primaryId
+        vector<BodyElements> pending;
+        vector<string> pendingIds;
+        bool pendingReady = false;
+
+        vector<BodyElements> published;
+        vector<string> publishedIds;
+        unordered_map<string, unsigned int> publishedIndices;
+
+        auto Gather(const SimulationState &state) -> void {
+            massiveIds.clear();
+            massiveX.clear();
+            massiveY.clear();
+            massiveZ.clear();
+            massiveVX.clear();
+            massiveVY.clear();
+            massiveVZ.clear();
+            massiveMass.clear();
+            bodyIds.clear();
+            bodyPoints.clear();
+            bodyMass.clear();
+
+            const unordered_map<string, Massive> &massiveBodies = Bodies::GetMassiveBodies();
+            for (const auto &pair : state.GetOrbitPoints()) {
+                const double mass = state.GetMass(pair.first);
+                bodyIds.push_back(pair.first);
+                bodyPoints.push_back(pair.second);
+                bodyMass.push_back(mass);
+                if ((massiveBodies.find(pair.first) != massiveBodies.end()) && !state.IsAbsorbed(pair.first)) {
+                    massiveIds.push_back(pair.first);
+                    massiveX.push_back(pair.second.position.x);
+                    massiveY.push_back(pair.second.position.y);
+                    massiveZ.push_back(pair.second.position.z);
+                    massiveVX.push_back(pair.second.velocity.x);
+                    massiveVY.push_back(pair.second.velocity.y);
+                    massiveVZ.push_back(pair.second.velocity.z);
+                    massiveMass.push_back(mass);
+                }
+            }
+        }
+
+        auto FindPrimary(const unsigned int body) -> int {
+            // Returns -1 if nothing else has mass
+            const dvec3 &position = bodyPoints.at(body).position;
+            const unsigned int massiveCount = massiveIds.size();
+            int primary = -1;
+            double strongestPull = 0;
+            for (unsigned int i = 0; i < massiveCount; i++) {
+                const double dx = massiveX[i] - position.x;
+                const double dy = massiveY[i] - position.y;
+                const double dz = massiveZ[i] - position.z;
+                const double distanceSquared = (dx * dx) + (dy * dy) + (dz * dz);
+                // The body itself is the only massive body at zero distance
+                const double pull = (distanceSquared > 0) ? massiveMass[i] / distanceSquared : 0;
+                if (pull > strongestPull) {
+                    strongestPull = pull;
+                    primary = int(i);
+                }
+            }
+            return primary;
+        }
+
+        auto CalculateRange(const unsigned int begin, const unsigned int end) -> void {
+            for (unsigned int body = begin; body < end; body++) {
+                BodyElements &elements = pending.at(body);
+                const int primary = FindPrimary(body);
+                if (primary < 0) {
+                    elements.primaryId.clear();
+                    continue;
+                }
+
+                const auto i = unsigned(primary);
+                const OrbitPoint &point = bodyPoints.at(body);
+                const dvec3 position = point.position - dvec3(massiveX[i], massiveY[i], massiveZ[i]);
+                const dvec3 velocity = point.velocity - dvec3(massiveVX[i], massiveVY[i], massiveVZ[i]);
+                const double mu = GRAVITATIONAL_CONSTANT * (bodyMass.at(body) + massiveMass[i]);
+
+                elements.primaryId = massiveIds.at(i);
+                elements.elements = OrbitalElementsUtil::Calculate(position, velocity, mu);
+                elements.period = OrbitalElementsUtil::GetPeriod(elements.elements, mu);
+            }
+        }
+    }
+
+    auto NewBodyReset() -> void {
+        pending.clear();
+        pendingIds.clear();
+        pendingReady = false;
+        published.clear();
+        publishedIds.clear();
+        publishedIndices.clear();
+    }
+
+    auto Calculate(const SimulationState &state) -> void {
+        ZoneScoped;
+        Gather(state);
+        pending.resize(bodyIds.size());
+        Parallel::For(bodyIds.size(), CalculateRange);
+        pendingIds.swap(bodyIds);
+        pendingReady = true;
+    }
+
+    auto Publish() -> void {
+        ZoneScoped;
+        if (!pendingReady) {
+            return;
+        }
+        published.swap(pending);
+        pendingReady = false;
+
+        // The bodies and the order they come out of the state in rarely change, so the lookup is only rebuilt when they do
+        if (pendingIds != publishedIds) {
+            publishedIds.swap(pendingIds);
+            publishedIndices.clear();
+            for (unsigned int i = 0; i < publishedIds.size(); i++) {
+                publishedIndices[publishedIds.at(i)] = i;
+            }
+        }
+    }
+
+    auto Get(const string &id, BodyElements &elements) -> bool {
+        const auto index = publishedIndices.find(id);
+        if ((index == publishedIndices.end()) || published.at(index->second).primaryId.empty()) {
+            return false;
+        }
+        elements = published.at(index->second);
+        return true;
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <simulation/OrbitalElements.h>
+#include <simulation/SimulationState.h>
+#include <util/Types.h>
+
+
+
+struct BodyElements {
+    string primaryId;
+    OrbitalElements elements;
+    double period; // s, 0 for orbits that are not closed
+};
+
+// Osculating elements of every body around its primary (the massive body pulling on it hardest), computed in one
+// batch on the simulation thread so the interface only has to look them up
+namespace OsculatingElements {
+    auto NewBodyReset() -> void;
+
+    // Called on the simulation thread with the latest state
+    auto Calculate(const SimulationState &state) -> void;
+
+    // Called on the main thread while the simulation thread is not running, to make the last batch visible
+    auto Publish() -> void;
+
+    // Returns false if the body has no primary, or no batch has been published since the last reset
+    auto Get(const string &id, BodyElements &elements) -> bool;
+}
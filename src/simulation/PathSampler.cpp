@@ -0,0 +1,75 @@
+#include "PathSampler.h"
+
+#include <rendering/geometry/Rays.h>
+
+#include <glm/geometric.hpp>
+
+#include <cmath>
+
+
+
+namespace {
+    // The largest angle the path may turn through between two vertices; the gap between the drawn chord and the
+    // true arc is then at most about 1 - cos(angle / 2) of the local radius of curvature, so it looks equally
+    // smooth at every zoom level
+    const double MAX_TURN_ANGLE = 2.0 * M_PI / 180.0;
+    const double MIN_TURN_COSINE = std::cos(MAX_TURN_ANGLE);
+
+    // Even a perfectly straight path gets a vertex this often, so the path is handed from future to past in
+    // reasonably small pieces
+    const unsigned int MAX_STEPS_BETWEEN_VERTICES = 200;
+
+    auto GetDirection(const dvec3 &velocity) -> dvec3 {
+        // Stationary bodies have no direction, and only get vertices from MAX_STEPS_BETWEEN_VERTICES
+        const double speed = glm::length(velocity);
+        return (speed > 0) ? velocity / speed : dvec3(0, 0, 0);
+    }
+
+    auto HasTurned(const dvec3 &previousDirection, const dvec3 &direction) -> bool {
+        const bool moving = (glm::dot(previousDirection, previousDirection) > 0) && (glm::dot(direction, direction) > 0);
+        return moving && (glm::dot(previousDirection, direction) < MIN_TURN_COSINE);
+    }
+}
+
+auto PathSampler::Emit(const string &id, const OrbitPoint &point, const double time, vector<PathVertex> &vertices) -> void {
+    vertices.push_back(PathVertex{id, Rays::Scale(point.position), time});
+    bodies[id] = BodySampler{GetDirection(point.velocity), 0};
+}
+
+auto PathSampler::Start(const SimulationState &state, vector<PathVertex> &vertices) -> void {
+    bodies.clear();
+    for (const auto &pair : state.GetOrbitPoints()) {
+        Emit(pair.first, pair.second, state.GetTime(), vertices);
+    }
+}
+
+auto PathSampler::Resume(const SimulationState &state) -> void {
+    bodies.clear();
+    for (const auto &pair : state.GetOrbitPoints()) {
+        ResumeBody(pair.first, pair.second);
+    }
+}
+
+auto PathSampler::Sample(const SimulationState &state, vector<PathVertex> &vertices) -> void {
+    ZoneScoped;
+    for (const auto &pair : state.GetOrbitPoints()) {
+        SampleBody(pair.first, pair.second, state.GetTime(), vertices);
+    }
+}
+
+auto PathSampler::ResumeBody(const string &id, const OrbitPoint &point) -> void {
+    bodies[id] = BodySampler{GetDirection(point.velocity), 0};
+}
+
+auto PathSampler::SampleBody(const string &id, const OrbitPoint &point, const double time, vector<PathVertex> &vertices) -> void {
+    const auto body = bodies.find(id);
+    if (body == bodies.end()) {
+        Emit(id, point, time, vertices);
+        return;
+    }
+
+    body->second.stepsSinceLastVertex++;
+    if (HasTurned(body->second.direction, GetDirection(point.velocity)) || (body->second.stepsSinceLastVertex >= MAX_STEPS_BETWEEN_VERTICES)) {
+        Emit(id, point, time, vertices);
+    }
+}
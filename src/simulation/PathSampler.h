@@ -0,0 +1,39 @@
+#pragma once
+
+#include <simulation/SimulationState.h>
+#include <util/Types.h>
+
+
+
+struct PathVertex {
+    string id;
+    vec3 position; // scaled
+    double time;
+};
+
+// Chooses which states of each body become vertices of its path, based on how sharply the path is turning
+// Paths stay dense around tight bends such as periapsis, and sparse along nearly straight arcs
+class PathSampler {
+private:
+    struct BodySampler {
+        dvec3 direction;
+        unsigned int stepsSinceLastVertex;
+    };
+
+    unordered_map<string, BodySampler> bodies;
+
+    auto Emit(const string &id, const OrbitPoint &point, const double time, vector<PathVertex> &vertices) -> void;
+
+public:
+    // Emits a vertex for every body, used for the first state of a path
+    auto Start(const SimulationState &state, vector<PathVertex> &vertices) -> void;
+
+    // Continues sampling from state without emitting anything, used when the path up to state already exists
+    auto Resume(const SimulationState &state) -> void;
+
+    auto Sample(const SimulationState &state, vector<PathVertex> &vertices) -> void;
+
+    // The same as Resume and Sample, but for a single body whose path is being computed separately
+    auto ResumeBody(const string &id, const OrbitPoint &point) -> void;
+    auto SampleBody(const string &id, const OrbitPoint &point, const double time, vector<PathVertex> &vertices) -> void;
+};
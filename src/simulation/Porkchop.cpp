@@ -0,0 +1,179 @@
+#include "Porkchop.h"
+
+#include <simulation/Lambert.h>
+#include <simulation/Trajectory.h>
+#include <main/Bodies.h>
+#include <util/Constants.h>
+#include <util/Log.h>
+#include <util/Parallel.h>
+
+#include <glm/geometric.hpp>
+
+#include <atomic>
+#include <limits>
+
+
+
+namespace Porkchop {
+    namespace {
+        thread worker;
+        std::atomic_bool finished = false;
+        std::atomic_bool cancel = false;
+        std::atomic<unsigned int> rowsCompleted = 0;
+        bool newResult = false;
+
+        PorkchopSettings settings;
+        string centralId;
+        double mu = 0;
+
+        // Positions and velocities relative to the central body, looked up before the run starts
+        vector<OrbitPoint> departurePoints;
+        vector<OrbitPoint> arrivalPoints;
+        vector<double> departureTimes;
+        vector<double> arrivalTimes;
+
+        vector<double> departureDeltaV;
+        vector<double> arrivalDeltaV;
+
+        auto GetGridTimes(const double start, const double end, const unsigned int count) -> vector<double> {
+            vector<double> times;
+            for (unsigned int i = 0; i < count; i++) {
+                times.push_back((count == 1) ? start : start + ((end - start) * i / (count - 1)));
+            }
+            return times;
+        }
+
+        auto QueryRelative(const string &id, const vector<double> &times, vector<OrbitPoint> &points) -> bool {
+            const vector<string> ids = {id, centralId};
+            vector<OrbitPoint> queried;
+            points.clear();
+            for (const double time : times) {
+                if (!Trajectory::Query(ids, time, queried)) {
+                    return false;
+                }
+                points.push_back(OrbitPoint{queried.at(0).position - queried.at(1).position, queried.at(0).velocity - queried.at(1).velocity});
+            }
+            return true;
+        }
+
+        auto SolveRows(const unsigned int begin, const unsigned int end) -> void {
+            // Each row is one departure time, against every arrival time
+            const double noTransfer = std::numeric_limits<double>::quiet_NaN();
+            for (unsigned int departure = begin; (departure < end) && !cancel; departure++) {
+                const OrbitPoint &start = departurePoints.at(departure);
+                const dvec3 normal = glm::cross(start.position, start.velocity);
+                for (unsigned int arrival = 0; arrival < settings.arrivalCount; arrival++) {
+                    const unsigned int index = (arrival * settings.departureCount) + departure;
+                    const OrbitPoint &finish = arrivalPoints.at(arrival);
+                    dvec3 v1;
+                    dvec3 v2;
+                    if (Lambert::Solve(start.position, finish.position, arrivalTimes.at(arrival) - departureTimes.at(departure), mu, normal, v1, v2)) {
+                        departureDeltaV.at(index) = glm::length(v1 - start.velocity);
+                        arrivalDeltaV.at(index) = glm::length(finish.velocity - v2);
+                    } else {
+                        departureDeltaV.at(index) = noTransfer;
+                        arrivalDeltaV.at(index) = noTransfer;
+                    }
+                }
+                rowsCompleted++;
+            }
+        }
+
+        auto Run() -> void {
+            ZoneScoped;
+            Parallel::For(settings.departureCount, SolveRows);
+            finished = true;
+        }
+
+        auto Join() -> void {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    auto Start(const PorkchopSettings &_settings) -> void {
+        Cancel();
+        settings = _settings;
+        departureDeltaV.clear();
+        arrivalDeltaV.clear();
+        newResult = true;
+        if ((settings.departureCount == 0) || (settings.arrivalCount == 0) || (settings.departureId == settings.arrivalId)) {
+            Log(WARN, "Transfer windows need two different bodies and at least one departure and arrival time");
+            return;
+        }
+
+        // The central body is whatever pulls hardest on the departure body, other than the two bodies themselves
+        centralId = Bodies::FindStrongestPull(settings.departureId, {settings.arrivalId});
+        if (centralId.empty()) {
+            Log(WARN, "Transfer windows need a massive body for the transfer to orbit around");
+            return;
+        }
+        mu = GRAVITATIONAL_CONSTANT * Bodies::GetBody(centralId).GetMass();
+
+        departureTimes = GetGridTimes(settings.departureStart, settings.departureEnd, settings.departureCount);
+        arrivalTimes = GetGridTimes(settings.arrivalStart, settings.arrivalEnd, settings.arrivalCount);
+        if (!QueryRelative(settings.departureId, departureTimes, departurePoints) || !QueryRelative(settings.arrivalId, arrivalTimes, arrivalPoints)) {
+            Log(WARN, "Transfer window dates must be within the predicted trajectory");
+            return;
+        }
+
+        departureDeltaV.assign(uint64_t(settings.departureCount) * settings.arrivalCount, 0);
+        arrivalDeltaV.assign(departureDeltaV.size(), 0);
+        rowsCompleted = 0;
+        finished = false;
+        cancel = false;
+
+        // Only the early returns above have a result to show straight away; the plot is rebuilt from a run once the
+        // worker has finished writing it
+        newResult = false;
+        worker = thread(Run);
+    }
+
+    auto Cancel() -> void {
+        cancel = true;
+        Join();
+        cancel = false;
+    }
+
+    auto PreReset() -> void {
+        Cancel();
+        departureDeltaV.clear();
+        arrivalDeltaV.clear();
+        newResult = true;
+    }
+
+    auto IsRunning() -> bool {
+        return worker.joinable() && !finished;
+    }
+
+    auto GetProgress() -> float {
+        return (settings.departureCount == 0) ? 0 : float(rowsCompleted) / float(settings.departureCount);
+    }
+
+    auto TakeNewResult() -> bool {
+        if (worker.joinable() && finished) {
+            Join();
+            newResult = true;
+        }
+        const bool result = newResult;
+        newResult = false;
+        return result;
+    }
+
+    auto GetDepartureDeltaV() -> const vector<double>& {
+        return departureDeltaV;
+    }
+
+    auto GetArrivalDeltaV() -> const vector<double>& {
+        return arrivalDeltaV;
+    }
+
+    auto GetSettings() -> const PorkchopSettings& {
+        return settings;
+    }
+
+    auto GetCentralId() -> const string& {
+        return centralId;
+    }
+}
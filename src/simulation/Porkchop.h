@@ -0,0 +1,39 @@
+#pragma once
+
+#include <util/Types.h>
+
+
+
+struct PorkchopSettings {
+    string departureId;
+    string arrivalId;
+    double departureStart; // simulation time, s
+    double departureEnd;
+    double arrivalStart;
+    double arrivalEnd;
+    unsigned int departureCount;
+    unsigned int arrivalCount;
+};
+
+// Solves Lambert's problem for every combination of departure and arrival time on a grid, using positions from the
+// predicted trajectory, to show when transfers between two bodies are cheapest
+namespace Porkchop {
+    auto Start(const PorkchopSettings &settings) -> void;
+    auto Cancel() -> void;
+    auto PreReset() -> void;
+
+    auto IsRunning() -> bool;
+    auto GetProgress() -> float;
+
+    // Returns true exactly once after each run completes, so the plot knows to rebuild
+    auto TakeNewResult() -> bool;
+
+    // Indexed by [arrival * departureCount + departure], in m/s; NaN wherever there is no transfer
+    // Departure delta-v is relative to the departure body, and arrival delta-v relative to the arrival body
+    auto GetDepartureDeltaV() -> const vector<double>&;
+    auto GetArrivalDeltaV() -> const vector<double>&;
+
+    // The settings and central body of the last run
+    auto GetSettings() -> const PorkchopSettings&;
+    auto GetCentralId() -> const string&;
+}
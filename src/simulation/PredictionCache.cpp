@@ -0,0 +1,391 @@
+#include "PredictionCache.h"
+
+#include <simulation/Rails.h>
+#include <simulation/Regularization.h>
+#include <simulation/Recording.h>
+#include <simulation/Trajectory.h>
+#include <rendering/world/OrbitPaths.h>
+#include <main/Bodies.h>
+#include <util/Hash.h>
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+
+namespace PredictionCache {
+    namespace {
+        // File layout:
+        // - Header
+        // - String table: the id of every body, each null-terminated, padded to a multiple of 8 bytes
+        // - Final state: position, velocity and last acceleration of every body, so computation can resume from it
+        // - vertexCount path vertices, in the order they were sampled
+        // - trajectoryStateCount trajectory states, each a time followed by the OrbitPoint of every body
+        struct Header {
+            std::array<char, 8> magic;
+            uint32_t version;
+            uint32_t bodyCount;
+            uint64_t stringTableSize;
+            uint64_t stepCount;
+            uint64_t vertexCount;
+            uint64_t trajectoryStateCount;
+            double time;
+        };
+
+        struct Vertex {
+            uint32_t body; // index into the string table
+            std::array<float, 3> position;
+            double time;
+        };
+
+        const std::array<char, 8> MAGIC = {'O', 'S', 'T', 'R', 'P', 'R', 'D', '\0'};
+        const uint32_t VERSION = 6;
+
+        const string CACHE_DIRECTORY = "../predictions/";
+        const string CACHE_SUFFIX = ".opc";
+
+        const unsigned int VALUES_PER_FINAL_BODY = 9;
+
+        // Trajectory states are stored as raw OrbitPoints
+        static_assert(sizeof(OrbitPoint) == 6 * sizeof(double));
+
+        // Scenarios with very many bodies would need an enormous file, and are quick to recompute relative to
+        // how long they take to read back anyway, so capturing is abandoned once the file would exceed this
+        const uint64_t MAX_CACHE_SIZE = uint64_t(256) * 1024 * 1024;
+
+        // Everything needed to write a cache file, copied out so the file can be written on the I/O thread while the
+        // simulation carries on
+        struct WriteRequest {
+            string path;
+            Header header;
+            string stringTable;
+            vector<double> finalState;
+            vector<Vertex> vertices;
+            vector<double> trajectoryTimes;
+            vector<OrbitPoint> trajectoryPoints;
+        };
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        queue<WriteRequest> requests;
+        bool stopWorker = false;
+        thread worker;
+
+        string cachePath;
+        double startTime = 0;
+        vector<string> ids;
+        unordered_map<string, uint32_t> indices;
+        vector<Vertex> vertices;
+        unsigned int cachedStepCount = 0;
+        bool capturing = false;
+
+        auto GenerateKey(const SimulationState &initialState, const double timeStepSize) -> string {
+            // Everything the prediction depends on: the integrator and encounter settings, and the mass, radius, starting point and rails flag of every body
+            const unordered_map<string, OrbitPoint> &points = initialState.GetOrbitPoints();
+            Hash hash;
+            hash.Add(uint64_t(VERSION));
+            hash.Add(timeStepSize);
+            hash.Add(initialState.GetTime());
+            hash.Add(uint64_t(Regularization::IsEnabled()));
+            hash.Add(Regularization::GetSoftening());
+            for (const string &id : ids) {
+                const OrbitPoint &point = points.at(id);
+                hash.Add(id);
+                hash.Add(Bodies::GetBody(id).GetMass());
+                hash.Add(Bodies::GetBody(id).GetRadius());
+                hash.Add(uint64_t(Bodies::GetMassiveBodies().count(id)));
+                // Only added for bodies on rails, so predictions cached before rails existed are still found
+                if (Rails::IsOnRails(id)) {
+                    hash.Add(string("rails"));
+                }
+                if (initialState.IsAbsorbed(id)) {
+                    hash.Add(string("absorbed"));
+                }
+                hash.Add(&point.position, sizeof(point.position));
+                hash.Add(&point.velocity, sizeof(point.velocity));
+            }
+            return hash.GetHex();
+        }
+
+        auto ParseStringTable(const char* current, const char* end, const unsigned int bodyCount, vector<string> &fileIds) -> bool {
+            for (unsigned int i = 0; i < bodyCount; i++) {
+                const void* terminator = memchr(current, '\0', end - current);
+                if (terminator == nullptr) {
+                    return false;
+                }
+                fileIds.emplace_back(current);
+                current = (const char*)terminator + 1; // NOLINT(cppcoreguidelines-pro-type-cstyle-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            }
+            return true;
+        }
+
+        auto Restore(const char* data, const uint64_t size, SimulationState &futureState) -> unsigned int {
+            Header header {};
+            memcpy(&header, data, sizeof(header));
+            if ((header.magic != MAGIC) || (header.version != VERSION) || (header.bodyCount != ids.size())) {
+                return 0;
+            }
+
+            const uint64_t finalStateOffset = sizeof(Header) + header.stringTableSize;
+            const uint64_t verticesOffset = finalStateOffset + (header.bodyCount * VALUES_PER_FINAL_BODY * sizeof(double));
+            const uint64_t verticesSize = header.vertexCount * sizeof(Vertex);
+            const uint64_t trajectoryOffset = verticesOffset + verticesSize;
+            const uint64_t trajectoryStateSize = sizeof(double) + (header.bodyCount * sizeof(OrbitPoint));
+            if (trajectoryOffset + (header.trajectoryStateCount * trajectoryStateSize) != size) {
+                return 0;
+            }
+
+            vector<string> fileIds;
+            if (!ParseStringTable(data + sizeof(Header), data + finalStateOffset, header.bodyCount, fileIds) || (fileIds != ids)) { // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                return 0;
+            }
+
+            // Everything is checked before anything is applied, so a bad file leaves the future state untouched
+            vertices.resize(header.vertexCount);
+            memcpy(vertices.data(), data + verticesOffset, verticesSize); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            for (const Vertex &vertex : vertices) {
+                if (vertex.body >= ids.size()) {
+                    return 0;
+                }
+            }
+
+            vector<double> finalState(header.bodyCount * VALUES_PER_FINAL_BODY);
+            memcpy(finalState.data(), data + finalStateOffset, finalState.size() * sizeof(double)); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            for (unsigned int i = 0; i < ids.size(); i++) {
+                const unsigned int offset = i * VALUES_PER_FINAL_BODY;
+                const OrbitPoint point{
+                    dvec3(finalState.at(offset + 0), finalState.at(offset + 1), finalState.at(offset + 2)),
+                    dvec3(finalState.at(offset + 3), finalState.at(offset + 4), finalState.at(offset + 5))};
+                const dvec3 acceleration(finalState.at(offset + 6), finalState.at(offset + 7), finalState.at(offset + 8));
+                futureState.SetOrbitPoint(ids.at(i), point, acceleration);
+            }
+            futureState.SetTime(header.time);
+
+            // The cached vertices also seed the capture buffer, so a prediction cut short last time can be extended and rewritten
+            vector<PathVertex> pathVertices;
+            pathVertices.reserve(vertices.size());
+            for (const Vertex &vertex : vertices) {
+                pathVertices.push_back(PathVertex{ids.at(vertex.body), vec3(vertex.position[0], vertex.position[1], vertex.position[2]), vertex.time});
+            }
+            OrbitPaths::AddVertices(pathVertices);
+
+            vector<OrbitPoint> points(header.bodyCount);
+            for (uint64_t state = 0; state < header.trajectoryStateCount; state++) {
+                const char* stateData = data + trajectoryOffset + (state * trajectoryStateSize); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                double time = 0;
+                memcpy(&time, stateData, sizeof(double));
+                memcpy(points.data(), stateData + sizeof(double), header.bodyCount * sizeof(OrbitPoint)); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                Trajectory::AddState(time, points);
+            }
+
+            return header.stepCount;
+        }
+
+        auto Capture(const SimulationState &futureState, const unsigned int stepCount) -> WriteRequest {
+            WriteRequest request;
+            request.path = cachePath;
+            request.stringTable = Recording::GenerateStringTable(ids);
+
+            // The trajectory is only included if it still reaches back to the start of the prediction
+            if ((Trajectory::GetIds() == ids) && (Trajectory::GetStartTime() == startTime)) {
+                Trajectory::GetStates(startTime, request.trajectoryTimes, request.trajectoryPoints);
+            }
+
+            request.header = Header{MAGIC, VERSION, uint32_t(ids.size()), request.stringTable.size(), stepCount, vertices.size(), request.trajectoryTimes.size(), futureState.GetTime()};
+
+            const unordered_map<string, OrbitPoint> &points = futureState.GetOrbitPoints();
+            for (const string &id : ids) {
+                const OrbitPoint &point = points.at(id);
+                const dvec3 acceleration = futureState.GetOldAcceleration(id);
+                request.finalState.insert(request.finalState.end(), {
+                    point.position.x, point.position.y, point.position.z,
+                    point.velocity.x, point.velocity.y, point.velocity.z,
+                    acceleration.x, acceleration.y, acceleration.z});
+            }
+
+            request.vertices = std::move(vertices);
+            vertices = vector<Vertex>();
+            return request;
+        }
+
+        auto Write(const WriteRequest &request) -> bool {
+            // Written under a temporary name first, so a half-written file is never mistaken for a valid cache
+            std::filesystem::create_directories(CACHE_DIRECTORY);
+            const string temporaryPath = request.path + ".tmp";
+            const uint64_t bodyCount = request.header.bodyCount;
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            file.write((const char*)&request.header, sizeof(request.header)); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+            file.write(request.stringTable.data(), std::streamsize(request.stringTable.size()));
+            file.write((const char*)request.finalState.data(), std::streamsize(request.finalState.size() * sizeof(double))); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+            file.write((const char*)request.vertices.data(), std::streamsize(request.vertices.size() * sizeof(Vertex))); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+            for (unsigned int state = 0; state < request.trajectoryTimes.size(); state++) {
+                file.write((const char*)&request.trajectoryTimes.at(state), sizeof(double)); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+                file.write((const char*)&request.trajectoryPoints.at(state * bodyCount), std::streamsize(bodyCount * sizeof(OrbitPoint))); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+            }
+            file.close();
+
+            if (!file) {
+                std::filesystem::remove(temporaryPath);
+                return false;
+            }
+
+            std::filesystem::rename(temporaryPath, request.path);
+            return true;
+        }
+
+        auto WorkerLoop() -> void {
+            while (true) {
+                WriteRequest request;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    condition.wait(lock, []{ return stopWorker || !requests.empty(); });
+                    if (requests.empty()) {
+                        return;
+                    }
+                    request = std::move(requests.front());
+                    requests.pop();
+                }
+
+                if (!Write(request)) {
+                    Log(WARN, "Failed to write cached prediction to " + request.path);
+                }
+            }
+        }
+
+        auto Queue(WriteRequest request) -> void {
+            // A file can be up to MAX_CACHE_SIZE, which would stall the frame if it were written on the calling thread
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!worker.joinable()) {
+                    stopWorker = false;
+                    worker = thread(WorkerLoop);
+                }
+                requests.push(std::move(request));
+            }
+            condition.notify_one();
+        }
+    }
+
+    auto NewBodyReset(const SimulationState &initialState, const double timeStepSize) -> void {
+        ZoneScoped;
+        ids.clear();
+        for (const auto &pair : initialState.GetOrbitPoints()) {
+            ids.push_back(pair.first);
+        }
+        std::sort(ids.begin(), ids.end());
+
+        indices.clear();
+        for (unsigned int i = 0; i < ids.size(); i++) {
+            indices[ids.at(i)] = i;
+        }
+
+        cachePath = CACHE_DIRECTORY + GenerateKey(initialState, timeStepSize) + CACHE_SUFFIX;
+        startTime = initialState.GetTime();
+        vertices.clear();
+        cachedStepCount = 0;
+        capturing = !ids.empty();
+    }
+
+    auto Load(SimulationState &futureState) -> unsigned int {
+        ZoneScoped;
+        if (!capturing) {
+            return 0;
+        }
+
+        const int file = open(cachePath.c_str(), O_RDONLY); // NOLINT(cppcoreguidelines-pro-type-vararg)
+        if (file == -1) {
+            return 0;
+        }
+
+        struct stat status {};
+        if ((fstat(file, &status) == -1) || (uint64_t(status.st_size) < sizeof(Header))) {
+            close(file);
+            return 0;
+        }
+
+        const uint64_t size = status.st_size;
+        void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        close(file);
+        if (data == MAP_FAILED) { // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+            Log(WARN, "Failed to map cached prediction at " + cachePath);
+            return 0;
+        }
+
+        madvise(data, size, MADV_SEQUENTIAL);
+        cachedStepCount = Restore((const char*)data, size, futureState); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+        munmap(data, size);
+
+        if (cachedStepCount == 0) {
+            Log(WARN, "Ignoring invalid cached prediction at " + cachePath);
+            vertices.clear();
+            return 0;
+        }
+
+        // Nothing left to add if the cached prediction already covers the whole horizon
+        if (cachedStepCount >= OrbitPaths::GetMaxFutureStates()) {
+            capturing = false;
+            vertices.clear();
+        }
+
+        return cachedStepCount;
+    }
+
+    auto AddVertices(const vector<PathVertex> &newVertices) -> void {
+        if (!capturing) {
+            return;
+        }
+
+        for (const PathVertex &vertex : newVertices) {
+            vertices.push_back(Vertex{indices.at(vertex.id), {vertex.position.x, vertex.position.y, vertex.position.z}, vertex.time});
+        }
+
+        if (vertices.size() * sizeof(Vertex) > MAX_CACHE_SIZE) {
+            capturing = false;
+            vertices = vector<Vertex>();
+        }
+    }
+
+    auto Finish(const SimulationState &futureState, const unsigned int stepCount) -> void {
+        ZoneScoped;
+        if (!capturing) {
+            return;
+        }
+        capturing = false;
+
+        if (stepCount > cachedStepCount) {
+            Queue(Capture(futureState, stepCount));
+        }
+        vertices = vector<Vertex>();
+    }
+
+    auto Abandon() -> void {
+        capturing = false;
+        vertices = vector<Vertex>();
+    }
+
+    auto IsCapturing() -> bool {
+        return capturing;
+    }
+
+    auto Shutdown() -> void {
+        // Any queued files are still written, so a prediction finished just before closing is not lost
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopWorker = true;
+        }
+        condition.notify_one();
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <simulation/PathSampler.h>
+#include <simulation/SimulationState.h>
+#include <util/Types.h>
+
+
+
+namespace PredictionCache {
+    // Caches the future path computed from a scenario's initial state, so reopening an unchanged scenario shows
+    // its full paths immediately instead of recomputing every future step
+    auto NewBodyReset(const SimulationState &initialState, const double timeStepSize) -> void;
+
+    // Restores any cached prediction for the current initial state into futureState and OrbitPaths
+    // Returns the number of steps that were restored, or 0 if nothing was cached
+    auto Load(SimulationState &futureState) -> unsigned int;
+
+    // Vertices passed here must be the same ones given to OrbitPaths::AddVertices
+    auto AddVertices(const vector<PathVertex> &vertices) -> void;
+
+    // Queues the prediction captured so far to be written on a background I/O thread, if it extends beyond what was
+    // already cached, and stops capturing
+    auto Finish(const SimulationState &futureState, const unsigned int stepCount) -> void;
+
+    // Stops capturing without writing anything, for when the prediction no longer follows from the initial state alone
+    auto Abandon() -> void;
+
+    auto IsCapturing() -> bool;
+
+    // Waits for any queued writes to finish
+    auto Shutdown() -> void;
+}
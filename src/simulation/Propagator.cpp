@@ -0,0 +1,311 @@
+#include "Propagator.h"
+
+#include <simulation/Collisions.h>
+#include <simulation/Kepler.h>
+#include <simulation/Regularization.h>
+#include <util/Constants.h>
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+
+
+namespace {
+    struct CloseCandidate {
+        double fallTime;
+        unsigned int first;
+        unsigned int second;
+    };
+
+    auto CompareFallTime(const CloseCandidate &a, const CloseCandidate &b) -> bool {
+        return a.fallTime < b.fallTime;
+    }
+}
+
+
+
+Propagator::Propagator(const ScenarioSnapshot &snapshot)
+    : ids(snapshot.ids), time(snapshot.time) {
+        const auto &arrays = snapshot.arrays;
+        for (unsigned int i = 0; i < ids.size(); i++) {
+            masses.push_back(arrays[SCENARIO_ARRAY_MASS].at(i));
+            radii.push_back(arrays[SCENARIO_ARRAY_RADIUS].at(i));
+            positions.emplace_back(arrays[SCENARIO_ARRAY_POSITION_X].at(i), arrays[SCENARIO_ARRAY_POSITION_Y].at(i), arrays[SCENARIO_ARRAY_POSITION_Z].at(i));
+            velocities.emplace_back(arrays[SCENARIO_ARRAY_VELOCITY_X].at(i), arrays[SCENARIO_ARRAY_VELOCITY_Y].at(i), arrays[SCENARIO_ARRAY_VELOCITY_Z].at(i));
+        }
+        absorbedInto.assign(ids.size(), -1);
+        strongest.assign(ids.size(), -1);
+        accelerations.resize(ids.size());
+        UpdateMassiveIndices();
+        CalculateAccelerations();
+    }
+
+auto Propagator::UpdateMassiveIndices() -> void {
+    massiveIndices.clear();
+    for (unsigned int i = 0; i < ids.size(); i++) {
+        if ((masses.at(i) > MASS_THRESHOLD) && (absorbedInto.at(i) < 0)) {
+            massiveIndices.push_back(i);
+        }
+    }
+}
+
+auto Propagator::CalculateIndividualAcceleration(const unsigned int of, const unsigned int withRespectTo) const -> dvec3 {
+    // The same as SimulationState, including Plummer softening
+    const dvec3 displacement = positions.at(withRespectTo) - positions.at(of);
+    const double distanceSquared = glm::dot(displacement, displacement);
+    const double softening = Regularization::GetSoftening();
+    const double softenedSquared = distanceSquared + (softening * softening);
+    return displacement * (GRAVITATIONAL_CONSTANT * masses.at(withRespectTo) / (softenedSquared * std::sqrt(softenedSquared)));
+}
+
+auto Propagator::CalculateAccelerations() -> void {
+    // The strongest pull is noted on the way, so finding close pairs doesn't need another pass over every pair
+    for (unsigned int i = 0; i < ids.size(); i++) {
+        if (absorbedInto.at(i) >= 0) {
+            continue;
+        }
+        dvec3 acceleration = dvec3(0, 0, 0);
+        int strongestIndex = -1;
+        double strongestPull = 0;
+        for (const unsigned int j : massiveIndices) {
+            if (i == j) {
+                continue;
+            }
+            const dvec3 individual = CalculateIndividualAcceleration(i, j);
+            acceleration += individual;
+            const double pull = glm::dot(individual, individual);
+            if (pull > strongestPull) {
+                strongestPull = pull;
+                strongestIndex = int(j);
+            }
+        }
+        accelerations.at(i) = acceleration;
+        strongest.at(i) = strongestIndex;
+    }
+
+    // Absorbed bodies sit on the body they merged into
+    for (unsigned int i = 0; i < ids.size(); i++) {
+        if (absorbedInto.at(i) >= 0) {
+            accelerations.at(i) = accelerations.at(absorbedInto.at(i));
+        }
+    }
+}
+
+auto Propagator::FindClosePairs(const double timeStep) const -> vector<ClosePair> {
+    // Each massive body is paired with whatever pulls on it hardest, if they would fall together within a few steps,
+    // closest pairs first; the same rule as SimulationState
+    vector<ClosePair> pairs;
+    if (!Regularization::IsEnabled() || (Regularization::GetSoftening() > 0)) {
+        return pairs;
+    }
+
+    vector<CloseCandidate> close;
+    const double maxFallTime = Regularization::GetCloseSteps() * timeStep;
+    for (const unsigned int i : massiveIndices) {
+        const int other = strongest.at(i);
+        if (other < 0) {
+            continue;
+        }
+        const double distance = glm::distance(positions.at(i), positions.at(other));
+        const double fallTime = std::sqrt(distance * distance * distance / (GRAVITATIONAL_CONSTANT * (masses.at(i) + masses.at(other))));
+        if (fallTime < maxFallTime) {
+            close.push_back(CloseCandidate{fallTime, i, unsigned(other)});
+        }
+    }
+    std::sort(close.begin(), close.end(), CompareFallTime);
+
+    vector<bool> paired(ids.size(), false);
+    for (const CloseCandidate &candidate : close) {
+        if (paired.at(candidate.first) || paired.at(candidate.second)) {
+            continue;
+        }
+        paired.at(candidate.first) = true;
+        paired.at(candidate.second) = true;
+        pairs.push_back(ClosePair{candidate.first, candidate.second});
+    }
+    return pairs;
+}
+
+auto Propagator::DriftClosePair(const ClosePair &pair, const double timeStep) -> void {
+    // Half the pull of everything except the other body, then the centre of mass in a straight line and the relative
+    // motion along its exact two-body orbit
+    velocities.at(pair.first) += 0.5 * (accelerations.at(pair.first) - CalculateIndividualAcceleration(pair.first, pair.second)) * timeStep;
+    velocities.at(pair.second) += 0.5 * (accelerations.at(pair.second) - CalculateIndividualAcceleration(pair.second, pair.first)) * timeStep;
+
+    const double totalMass = masses.at(pair.first) + masses.at(pair.second);
+    const double firstFraction = masses.at(pair.first) / totalMass;
+    const double secondFraction = masses.at(pair.second) / totalMass;
+    const dvec3 centre = (firstFraction * positions.at(pair.first)) + (secondFraction * positions.at(pair.second));
+    const dvec3 centreVelocity = (firstFraction * velocities.at(pair.first)) + (secondFraction * velocities.at(pair.second));
+    const OrbitPoint relative = Kepler::Propagate(
+        OrbitPoint{positions.at(pair.first) - positions.at(pair.second), velocities.at(pair.first) - velocities.at(pair.second)},
+        GRAVITATIONAL_CONSTANT * totalMass, timeStep);
+
+    const dvec3 newCentre = centre + (centreVelocity * timeStep);
+    positions.at(pair.first) = newCentre + (secondFraction * relative.position);
+    positions.at(pair.second) = newCentre - (firstFraction * relative.position);
+    velocities.at(pair.first) = centreVelocity + (secondFraction * relative.velocity);
+    velocities.at(pair.second) = centreVelocity - (firstFraction * relative.velocity);
+}
+
+auto Propagator::KickClosePair(const ClosePair &pair, const double timeStep) -> void {
+    // The other half of the external pull, at the new positions
+    velocities.at(pair.first) += 0.5 * (accelerations.at(pair.first) - CalculateIndividualAcceleration(pair.first, pair.second)) * timeStep;
+    velocities.at(pair.second) += 0.5 * (accelerations.at(pair.second) - CalculateIndividualAcceleration(pair.second, pair.first)) * timeStep;
+}
+
+auto Propagator::MergeCollisions(const vector<dvec3> &startPositions) -> void {
+    // The same swept-sphere test and merge rule as SimulationState
+    vector<SweptSphere> spheres;
+    vector<unsigned int> indices;
+    for (unsigned int i = 0; i < ids.size(); i++) {
+        if (absorbedInto.at(i) < 0) {
+            spheres.push_back(SweptSphere{startPositions.at(i), positions.at(i), radii.at(i)});
+            indices.push_back(i);
+        }
+    }
+
+    const vector<Contact> contacts = Collisions::Find(spheres);
+    if (contacts.empty()) {
+        return;
+    }
+
+    vector<bool> merged(spheres.size(), false);
+    for (const Contact &contact : contacts) {
+        if (merged.at(contact.first) || merged.at(contact.second)) {
+            continue;
+        }
+        merged.at(contact.first) = true;
+        merged.at(contact.second) = true;
+
+        const unsigned int first = indices.at(contact.first);
+        const unsigned int second = indices.at(contact.second);
+        const bool firstSurvives = (masses.at(first) > masses.at(second)) || ((masses.at(first) == masses.at(second)) && (ids.at(first) < ids.at(second)));
+        const unsigned int survivor = firstSurvives ? first : second;
+        const unsigned int absorbed = firstSurvives ? second : first;
+
+        const double totalMass = masses.at(survivor) + masses.at(absorbed);
+        if (totalMass > 0) {
+            positions.at(survivor) = ((masses.at(survivor) * positions.at(survivor)) + (masses.at(absorbed) * positions.at(absorbed))) / totalMass;
+            velocities.at(survivor) = ((masses.at(survivor) * velocities.at(survivor)) + (masses.at(absorbed) * velocities.at(absorbed))) / totalMass;
+        }
+        masses.at(survivor) = totalMass;
+        masses.at(absorbed) = 0;
+        radii.at(survivor) = std::cbrt(std::pow(radii.at(survivor), 3) + std::pow(radii.at(absorbed), 3));
+        radii.at(absorbed) = 0;
+
+        for (int &into : absorbedInto) {
+            if (into == int(absorbed)) {
+                into = int(survivor);
+            }
+        }
+        absorbedInto.at(absorbed) = int(survivor);
+    }
+
+    // The merged masses change every body's acceleration
+    UpdateMassiveIndices();
+    CalculateAccelerations();
+}
+
+auto Propagator::Step(const double timeStep) -> void {
+    // Velocity Verlet, with close pairs kicked and drifted separately, then merges at the end of the step
+    const vector<dvec3> startPositions = positions;
+    const vector<ClosePair> pairs = FindClosePairs(timeStep);
+    vector<bool> integrated(ids.size(), true);
+    for (unsigned int i = 0; i < ids.size(); i++) {
+        integrated.at(i) = absorbedInto.at(i) < 0;
+    }
+    for (const ClosePair &pair : pairs) {
+        integrated.at(pair.first) = false;
+        integrated.at(pair.second) = false;
+    }
+
+    for (unsigned int i = 0; i < ids.size(); i++) {
+        if (integrated.at(i)) {
+            velocities.at(i) += 0.5 * accelerations.at(i) * timeStep;
+            positions.at(i) += velocities.at(i) * timeStep;
+        }
+    }
+    for (const ClosePair &pair : pairs) {
+        DriftClosePair(pair, timeStep);
+    }
+
+    CalculateAccelerations();
+
+    for (unsigned int i = 0; i < ids.size(); i++) {
+        if (integrated.at(i)) {
+            velocities.at(i) += 0.5 * accelerations.at(i) * timeStep;
+        }
+    }
+    for (const ClosePair &pair : pairs) {
+        KickClosePair(pair, timeStep);
+    }
+
+    MergeCollisions(startPositions);
+    for (unsigned int i = 0; i < ids.size(); i++) {
+        if (absorbedInto.at(i) >= 0) {
+            positions.at(i) = positions.at(absorbedInto.at(i));
+            velocities.at(i) = velocities.at(absorbedInto.at(i));
+        }
+    }
+
+    time += timeStep;
+}
+
+auto Propagator::GetBodyCount() const -> unsigned int {
+    return ids.size();
+}
+
+auto Propagator::GetIndex(const string &id) const -> int {
+    for (unsigned int i = 0; i < ids.size(); i++) {
+        if (ids.at(i) == id) {
+            return int(i);
+        }
+    }
+    return -1;
+}
+
+auto Propagator::GetMass(const unsigned int index) const -> double {
+    return masses.at(index);
+}
+
+auto Propagator::GetPosition(const unsigned int index) const -> dvec3 {
+    return positions.at(index);
+}
+
+auto Propagator::GetVelocity(const unsigned int index) const -> dvec3 {
+    return velocities.at(index);
+}
+
+auto Propagator::GetTime() const -> double {
+    return time;
+}
+
+auto Propagator::GetTotalEnergy() const -> double {
+    // Potential energy is counted once per pair, and only for pairs where at least one body is massive, matching the
+    // force model; this makes the total conserved by the exact dynamics, so any change is integration error
+    // Absorbed bodies have no mass, and sit on top of the body they merged into
+    double energy = 0;
+    for (unsigned int i = 0; i < ids.size(); i++) {
+        energy += 0.5 * masses.at(i) * glm::dot(velocities.at(i), velocities.at(i));
+    }
+
+    for (const unsigned int i : massiveIndices) {
+        for (unsigned int j = 0; j < ids.size(); j++) {
+            // Massive-massive pairs would be visited twice, so they are only counted when j > i
+            const bool jMassive = masses.at(j) > MASS_THRESHOLD;
+            if ((j == i) || (jMassive && (j < i)) || (absorbedInto.at(j) >= 0)) {
+                continue;
+            }
+            energy -= GRAVITATIONAL_CONSTANT * masses.at(i) * masses.at(j) / glm::distance(positions.at(i), positions.at(j));
+        }
+    }
+
+    return energy;
+}
+
+auto Propagator::GetAbsorbedInto(const unsigned int index) const -> int {
+    return absorbedInto.at(index);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <scenarios/ScenarioSnapshot.h>
+#include <util/Types.h>
+
+
+
+// Propagates a scenario snapshot without going through Bodies, so it can run headless and on any thread
+// Uses the same force model as SimulationState: bodies above MASS_THRESHOLD attract every other body, with the current
+// softening or close-pair regularization, and bodies that touch merge
+// Unlike SimulationState, every body is integrated with velocity Verlet, all positions being updated before any
+// acceleration is recalculated; rails and Encke's method are GUI settings and are not used here
+class Propagator {
+private:
+    struct ClosePair {
+        unsigned int first;
+        unsigned int second;
+    };
+
+    vector<string> ids;
+    vector<double> masses;
+    vector<double> radii;
+    vector<unsigned int> massiveIndices;
+    vector<dvec3> positions;
+    vector<dvec3> velocities;
+    vector<dvec3> accelerations;
+
+    // The massive body pulling hardest on each body at the last acceleration update, or -1 for none
+    vector<int> strongest;
+
+    // The body each body merged into, or -1 if it hasn't merged
+    vector<int> absorbedInto;
+    double time;
+
+    auto UpdateMassiveIndices() -> void;
+    auto CalculateIndividualAcceleration(const unsigned int of, const unsigned int withRespectTo) const -> dvec3;
+    auto CalculateAccelerations() -> void;
+    auto FindClosePairs(const double timeStep) const -> vector<ClosePair>;
+    auto DriftClosePair(const ClosePair &pair, const double timeStep) -> void;
+    auto KickClosePair(const ClosePair &pair, const double timeStep) -> void;
+    auto MergeCollisions(const vector<dvec3> &startPositions) -> void;
+
+public:
+    Propagator(const ScenarioSnapshot &snapshot);
+
+    auto Step(const double timeStep) -> void;
+
+    auto GetBodyCount() const -> unsigned int;
+    auto GetIndex(const string &id) const -> int;
+    auto GetMass(const unsigned int index) const -> double;
+    auto GetPosition(const unsigned int index) const -> dvec3;
+    auto GetVelocity(const unsigned int index) const -> dvec3;
+    auto GetTime() const -> double;
+
+    // Merges lose kinetic energy, which shows up here like integration error
+    auto GetTotalEnergy() const -> double;
+
+    // Returns -1 unless the body has merged into another
+    auto GetAbsorbedInto(const unsigned int index) const -> int;
+};
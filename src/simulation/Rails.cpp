@@ -0,0 +1,57 @@
+#include "Rails.h"
+
+#include <main/Bodies.h>
+
+#include <unordered_set>
+
+
+
+namespace Rails {
+    namespace {
+        std::unordered_set<string> onRails;
+        vector<std::pair<string, bool>> pendingChanges;
+    }
+
+    auto PreReset() -> void {
+        onRails.clear();
+        pendingChanges.clear();
+    }
+
+    auto SetOnRails(const string &id, const bool _onRails) -> void {
+        pendingChanges.emplace_back(id, _onRails);
+    }
+
+    auto SetAllOnRails(const bool _onRails) -> void {
+        for (const string &id : Bodies::GetBodyIds()) {
+            pendingChanges.emplace_back(id, _onRails);
+        }
+    }
+
+    auto FrameUpdate() -> void {
+        bool changed = false;
+        for (const auto &pair : pendingChanges) {
+            if (pair.second) {
+                changed |= onRails.insert(pair.first).second;
+            } else {
+                changed |= (onRails.erase(pair.first) > 0);
+            }
+        }
+        pendingChanges.clear();
+
+        if (changed) {
+            Bodies::ResetPrediction();
+        }
+    }
+
+    auto IsOnRails(const string &id) -> bool {
+        return onRails.find(id) != onRails.end();
+    }
+
+    auto IsAnyOnRails() -> bool {
+        return !onRails.empty();
+    }
+
+    auto GetOnRailsCount() -> unsigned int {
+        return onRails.size();
+    }
+}
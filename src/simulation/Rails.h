@@ -0,0 +1,24 @@
+#pragma once
+
+#include <util/Types.h>
+
+
+
+// Bodies flagged as on rails follow closed-form Kepler orbits around their parent in the sphere-of-influence
+// hierarchy instead of being integrated, which turns their O(N) force sums into one O(1) evaluation each step
+// They still pull on everything else if they are massive, but nothing perturbs them except a change of parent
+namespace Rails {
+    auto PreReset() -> void;
+
+    // Changes are held back until FrameUpdate, since the simulation thread reads the flags while stepping
+    auto SetOnRails(const string &id, const bool onRails) -> void;
+    auto SetAllOnRails(const bool onRails) -> void;
+
+    // Applies any changes, and recomputes the prediction from the current time if there were any
+    // Must be called on the main thread while the simulation thread is not running
+    auto FrameUpdate() -> void;
+
+    auto IsOnRails(const string &id) -> bool;
+    auto IsAnyOnRails() -> bool;
+    auto GetOnRailsCount() -> unsigned int;
+}
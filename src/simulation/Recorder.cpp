@@ -0,0 +1,176 @@
+#include "Recorder.h"
+
+#include <simulation/Recording.h>
+#include <main/Bodies.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+
+
+
+namespace Recorder {
+    namespace {
+        // Chunks are the unit of random access during replay, so this trades compression ratio against seek cost
+        const unsigned int STATES_PER_CHUNK = 256;
+
+        std::ofstream file;
+        vector<string> ids;
+
+        vector<double> currentChunk;
+        unsigned int currentChunkStates = 0;
+        unsigned int stateCount = 0;
+
+        std::mutex queueMutex;
+        std::condition_variable queueCondition;
+        queue<vector<double>> chunkQueue;
+        bool stopWorker = false;
+
+        thread worker;
+        bool recording = false;
+        std::atomic<uint64_t> bytesWritten = 0;
+
+        auto WriteChunk(const vector<double> &states) -> void {
+            ZoneScoped;
+            const unsigned int valuesPerState = Recording::GetValuesPerState(ids.size());
+            const unsigned int chunkStates = states.size() / valuesPerState;
+
+            vector<char> compressed;
+            if (!Recording::EncodeChunk(states, ids.size(), compressed)) {
+                return;
+            }
+
+            Recording::ChunkHeader header {};
+            header.startTime = states.at(0);
+            header.endTime = states.at((chunkStates - 1) * valuesPerState);
+            header.stateCount = chunkStates;
+            header.compressedSize = compressed.size();
+
+            file.write((const char*)&header, sizeof(header)); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+            file.write(compressed.data(), std::streamsize(compressed.size()));
+            file.flush();
+            bytesWritten += sizeof(header) + compressed.size();
+        }
+
+        auto WorkerLoop() -> void {
+            while (true) {
+                vector<double> states;
+                {
+                    std::unique_lock<std::mutex> lock(queueMutex);
+                    queueCondition.wait(lock, []{ return stopWorker || !chunkQueue.empty(); });
+                    if (chunkQueue.empty()) {
+                        return;
+                    }
+                    states = std::move(chunkQueue.front());
+                    chunkQueue.pop();
+                }
+                WriteChunk(states);
+            }
+        }
+
+        auto QueueCurrentChunk() -> void {
+            if (currentChunkStates == 0) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                chunkQueue.push(std::move(currentChunk));
+            }
+            queueCondition.notify_one();
+            currentChunk = vector<double>();
+            currentChunk.reserve(STATES_PER_CHUNK * Recording::GetValuesPerState(ids.size()));
+            currentChunkStates = 0;
+        }
+    }
+
+    auto Start(const string &path) -> bool {
+        if (recording) {
+            Stop();
+        }
+
+        file.open(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            Log(ERROR, "Failed to open recording file at " + path);
+            return false;
+        }
+
+        // The set of bodies is fixed for the whole recording
+        ids = Bodies::GetBodyIds();
+        const string stringTable = Recording::GenerateStringTable(ids);
+
+        Recording::FileHeader header {};
+        header.magic = Recording::MAGIC;
+        header.version = Recording::VERSION;
+        header.bodyCount = ids.size();
+        header.stringTableSize = stringTable.size();
+
+        file.write((const char*)&header, sizeof(header)); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+        file.write(stringTable.data(), std::streamsize(stringTable.size()));
+        file.flush();
+
+        bytesWritten = sizeof(header) + stringTable.size();
+        stateCount = 0;
+        currentChunkStates = 0;
+        currentChunk.clear();
+        currentChunk.reserve(STATES_PER_CHUNK * Recording::GetValuesPerState(ids.size()));
+
+        stopWorker = false;
+        worker = thread(WorkerLoop);
+        recording = true;
+        return true;
+    }
+
+    auto Stop() -> void {
+        if (!recording) {
+            return;
+        }
+
+        QueueCurrentChunk();
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopWorker = true;
+        }
+        queueCondition.notify_one();
+        worker.join();
+
+        file.close();
+        recording = false;
+    }
+
+    auto RecordState(const SimulationState &state) -> void {
+        if (!recording) {
+            return;
+        }
+
+        const auto &points = state.GetOrbitPoints();
+        currentChunk.push_back(state.GetTime());
+        for (const string &id : ids) {
+            const OrbitPoint &point = points.at(id);
+            currentChunk.push_back(point.position.x);
+            currentChunk.push_back(point.position.y);
+            currentChunk.push_back(point.position.z);
+            currentChunk.push_back(point.velocity.x);
+            currentChunk.push_back(point.velocity.y);
+            currentChunk.push_back(point.velocity.z);
+        }
+
+        stateCount++;
+        currentChunkStates++;
+        if (currentChunkStates >= STATES_PER_CHUNK) {
+            QueueCurrentChunk();
+        }
+    }
+
+    auto IsRecording() -> bool {
+        return recording;
+    }
+
+    auto GetStateCount() -> unsigned int {
+        return stateCount;
+    }
+
+    auto GetBytesWritten() -> uint64_t {
+        return bytesWritten;
+    }
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <simulation/SimulationState.h>
+#include <util/Types.h>
+
+
+
+namespace Recorder {
+    // Records every simulation state to a compressed file; compression and disk writes happen on a background thread
+    auto Start(const string &path) -> bool;
+    auto Stop() -> void;
+    auto RecordState(const SimulationState &state) -> void;
+
+    auto IsRecording() -> bool;
+    auto GetStateCount() -> unsigned int;
+    auto GetBytesWritten() -> uint64_t;
+}
@@ -0,0 +1,120 @@
+#include "Recording.h"
+
+#include <depend/tracy-0.9/zstd/zstd.h>
+
+#include <cstring>
+
+
+
+namespace Recording {
+    namespace {
+        const int COMPRESSION_LEVEL = 3;
+        const uint64_t ALIGNMENT = sizeof(double);
+
+        auto ToBits(const double value) -> uint64_t {
+            uint64_t bits = 0;
+            memcpy(&bits, &value, sizeof(double));
+            return bits;
+        }
+
+        auto FromBits(const uint64_t bits) -> double {
+            double value = 0;
+            memcpy(&value, &bits, sizeof(double));
+            return value;
+        }
+
+        auto Shuffle(const vector<uint64_t> &words, vector<uint8_t> &bytes) -> void {
+            // Store the nth byte of every word together, so the mostly-zero high bytes form long runs
+            bytes.resize(words.size() * sizeof(uint64_t));
+            for (unsigned int byte = 0; byte < sizeof(uint64_t); byte++) {
+                for (unsigned int word = 0; word < words.size(); word++) {
+                    bytes.at((byte * words.size()) + word) = uint8_t(words.at(word) >> (byte * 8));
+                }
+            }
+        }
+
+        auto Unshuffle(const vector<uint8_t> &bytes, vector<uint64_t> &words) -> void {
+            words.assign(bytes.size() / sizeof(uint64_t), 0);
+            for (unsigned int byte = 0; byte < sizeof(uint64_t); byte++) {
+                for (unsigned int word = 0; word < words.size(); word++) {
+                    words.at(word) |= uint64_t(bytes.at((byte * words.size()) + word)) << (byte * 8);
+                }
+            }
+        }
+    }
+
+    auto GetValuesPerState(const unsigned int bodyCount) -> unsigned int {
+        return 1 + (bodyCount * VALUES_PER_BODY);
+    }
+
+    auto GenerateStringTable(const vector<string> &ids) -> string {
+        string table;
+        for (const string &id : ids) {
+            table += id;
+            table += '\0';
+        }
+        table.resize((table.size() + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT, '\0');
+        return table;
+    }
+
+    auto EncodeChunk(const vector<double> &states, const unsigned int bodyCount, vector<char> &compressed) -> bool {
+        ZoneScoped;
+        // Consecutive states are very similar, so each value is stored as the difference between its bit pattern and
+        // the bit pattern of the same value in the previous state; the first state of a chunk is stored as-is so that
+        // every chunk can be decoded independently
+        // Values are transposed so that each column (eg. the x position of one body) is contiguous, and the bytes are
+        // then shuffled so that the mostly-zero high bytes of the differences end up next to each other for zstd
+        const unsigned int valuesPerState = GetValuesPerState(bodyCount);
+        const unsigned int stateCount = states.size() / valuesPerState;
+
+        vector<uint64_t> deltas(states.size());
+        for (unsigned int value = 0; value < valuesPerState; value++) {
+            uint64_t previous = 0;
+            for (unsigned int state = 0; state < stateCount; state++) {
+                const uint64_t current = ToBits(states.at((state * valuesPerState) + value));
+                deltas.at((value * stateCount) + state) = current - previous;
+                previous = current;
+            }
+        }
+
+        vector<uint8_t> bytes;
+        Shuffle(deltas, bytes);
+
+        compressed.resize(ZSTD_compressBound(bytes.size()));
+        const size_t compressedSize = ZSTD_compress(compressed.data(), compressed.size(), bytes.data(), bytes.size(), COMPRESSION_LEVEL);
+        if (ZSTD_isError(compressedSize)) {
+            Log(ERROR, "Failed to compress recording chunk: " + string(ZSTD_getErrorName(compressedSize)));
+            return false;
+        }
+
+        compressed.resize(compressedSize);
+        return true;
+    }
+
+    auto DecodeChunk(const char* compressed, const uint64_t compressedSize, const unsigned int stateCount, const unsigned int bodyCount, vector<double> &states) -> bool {
+        ZoneScoped;
+        const unsigned int valuesPerState = GetValuesPerState(bodyCount);
+        vector<uint8_t> bytes(uint64_t(stateCount) * valuesPerState * sizeof(uint64_t));
+
+        const size_t decompressedSize = ZSTD_decompress(bytes.data(), bytes.size(), compressed, compressedSize);
+        if (ZSTD_isError(decompressedSize) || (decompressedSize != bytes.size())) {
+            Log(ERROR, "Failed to decompress recording chunk");
+            return false;
+        }
+
+        vector<uint64_t> deltas;
+        Unshuffle(bytes, deltas);
+
+        // Undo the transposition and differences from EncodeChunk
+        states.resize(deltas.size());
+        for (unsigned int value = 0; value < valuesPerState; value++) {
+            uint64_t previous = 0;
+            for (unsigned int state = 0; state < stateCount; state++) {
+                previous += deltas.at((value * stateCount) + state);
+                states.at((state * valuesPerState) + value) = FromBits(previous);
+            }
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <util/Types.h>
+
+#include <array>
+#include <cstdint>
+
+
+
+namespace Recording {
+
+    // File layout:
+    // - FileHeader
+    // - String table: the id of every recorded body, each null-terminated, padded to a multiple of 8 bytes
+    // - Any number of chunks, each a ChunkHeader followed by compressedSize bytes of zstd-compressed data
+    // Every chunk carries its own time range, so a recording that was never closed properly is still readable
+    struct FileHeader {
+        std::array<char, 8> magic;
+        uint32_t version;
+        uint32_t bodyCount;
+        uint64_t stringTableSize;
+    };
+
+    struct ChunkHeader {
+        double startTime;
+        double endTime;
+        uint32_t stateCount;
+        uint32_t padding;
+        uint64_t compressedSize;
+    };
+
+    const std::array<char, 8> MAGIC = {'O', 'S', 'T', 'R', 'R', 'E', 'C', '\0'};
+    const uint32_t VERSION = 1;
+
+    // Each recorded state is a time followed by the position and velocity of every body
+    const unsigned int VALUES_PER_BODY = 6;
+
+    auto GetValuesPerState(const unsigned int bodyCount) -> unsigned int;
+    auto GenerateStringTable(const vector<string> &ids) -> string;
+
+    // states holds stateCount rows of GetValuesPerState(bodyCount) values
+    auto EncodeChunk(const vector<double> &states, const unsigned int bodyCount, vector<char> &compressed) -> bool;
+    auto DecodeChunk(const char* compressed, const uint64_t compressedSize, const unsigned int stateCount, const unsigned int bodyCount, vector<double> &states) -> bool;
+}
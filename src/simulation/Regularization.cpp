@@ -0,0 +1,55 @@
+#include "Regularization.h"
+
+#include <main/Bodies.h>
+
+
+
+namespace Regularization {
+    namespace {
+        const bool DEFAULT_ENABLED = true;
+        const double DEFAULT_SOFTENING = 0;
+
+        // A circular orbit at this limit takes about 2 pi * 4 = 25 steps, which the integrator can still follow
+        const double CLOSE_STEPS = 4;
+
+        bool enabled = DEFAULT_ENABLED;
+        double softening = DEFAULT_SOFTENING;
+        bool pendingEnabled = DEFAULT_ENABLED;
+        double pendingSoftening = DEFAULT_SOFTENING;
+    }
+
+    auto PreReset() -> void {
+        // Settings are kept across scenarios; only unapplied changes are dropped
+        pendingEnabled = enabled;
+        pendingSoftening = softening;
+    }
+
+    auto SetEnabled(const bool _enabled) -> void {
+        pendingEnabled = _enabled;
+    }
+
+    auto SetSoftening(const double length) -> void {
+        pendingSoftening = length;
+    }
+
+    auto FrameUpdate() -> void {
+        if ((pendingEnabled == enabled) && (pendingSoftening == softening)) {
+            return;
+        }
+        enabled = pendingEnabled;
+        softening = pendingSoftening;
+        Bodies::ResetPrediction();
+    }
+
+    auto IsEnabled() -> bool {
+        return enabled;
+    }
+
+    auto GetSoftening() -> double {
+        return softening;
+    }
+
+    auto GetCloseSteps() -> double {
+        return CLOSE_STEPS;
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <util/Types.h>
+
+
+
+// Settings for close encounters between massive bodies, which the fixed step can't resolve
+// Close pairs are regularized by default: their relative motion is moved along the exact two-body orbit, which has no
+// singularity however close they pass, while their centre of mass and the pull of everything else are integrated
+// Plummer softening is an alternative for cluster scenarios, where close passes matter less than a stable result
+namespace Regularization {
+    auto PreReset() -> void;
+
+    // Changes are held back until FrameUpdate, since the simulation thread reads the settings while stepping
+    auto SetEnabled(const bool enabled) -> void;
+    auto SetSoftening(const double length) -> void;
+
+    // Applies any changes, and recomputes the prediction from the current time if there were any
+    // Must be called on the main thread while the simulation thread is not running
+    auto FrameUpdate() -> void;
+
+    auto IsEnabled() -> bool;
+
+    // Plummer softening length in m, or 0 for none
+    auto GetSoftening() -> double;
+
+    // A pair is close when the time it takes to fall together, sqrt(r^3 / mu), is under this many steps
+    auto GetCloseSteps() -> double;
+}
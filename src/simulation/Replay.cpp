@@ -0,0 +1,229 @@
+#include "Replay.h"
+
+#include <simulation/Recording.h>
+#include <simulation/OrbitPoint.h>
+#include <main/Bodies.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+
+namespace Replay {
+    namespace {
+        struct Chunk {
+            double startTime;
+            double endTime;
+            unsigned int stateCount;
+            const char* data;
+            uint64_t compressedSize;
+        };
+
+        void* data = nullptr;
+        uint64_t size = 0;
+
+        vector<string> ids;
+        vector<Chunk> chunks;
+
+        // Scrubbing usually stays within one chunk, so the most recently decoded chunk is kept around
+        int decodedChunkIndex = -1;
+        vector<double> decodedChunk;
+
+        double currentTime = 0;
+
+        auto At(const uint64_t offset) -> const char* {
+            return (const char*)data + offset; // NOLINT(cppcoreguidelines-pro-type-cstyle-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+
+        auto ParseStringTable(const Recording::FileHeader &header) -> bool {
+            const char* current = At(sizeof(Recording::FileHeader));
+            const char* end = current + header.stringTableSize; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+            for (unsigned int i = 0; i < header.bodyCount; i++) {
+                const void* terminator = memchr(current, '\0', end - current);
+                if (terminator == nullptr) {
+                    return false;
+                }
+                ids.emplace_back(current);
+                current = (const char*)terminator + 1; // NOLINT(cppcoreguidelines-pro-type-cstyle-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            }
+
+            return true;
+        }
+
+        auto BuildChunkIndex(uint64_t offset) -> void {
+            // There is no footer, so the index is rebuilt by walking the chunk headers
+            // A chunk that was only partially written (eg. the program crashed mid-recording) ends the walk
+            while (offset + sizeof(Recording::ChunkHeader) <= size) {
+                Recording::ChunkHeader header {};
+                memcpy(&header, At(offset), sizeof(header));
+                offset += sizeof(header);
+
+                if ((header.stateCount == 0) || (offset + header.compressedSize > size)) {
+                    break;
+                }
+
+                chunks.push_back(Chunk{header.startTime, header.endTime, header.stateCount, At(offset), header.compressedSize});
+                offset += header.compressedSize;
+            }
+        }
+
+        auto DecodeChunk(const int index) -> bool {
+            if (index == decodedChunkIndex) {
+                return true;
+            }
+
+            const Chunk &chunk = chunks.at(index);
+            if (!Recording::DecodeChunk(chunk.data, chunk.compressedSize, chunk.stateCount, ids.size(), decodedChunk)) {
+                decodedChunkIndex = -1;
+                return false;
+            }
+
+            decodedChunkIndex = index;
+            return true;
+        }
+
+        auto FindChunk(const double time) -> int {
+            // Binary search for the last chunk starting at or before the requested time
+            const auto chunk = std::upper_bound(chunks.begin(), chunks.end(), time,
+                [](const double time, const Chunk &chunk) { return time < chunk.startTime; });
+            return std::max(0, int(chunk - chunks.begin()) - 1);
+        }
+
+        auto FindState(const double time) -> unsigned int {
+            // Binary search for the last state in the decoded chunk at or before the requested time
+            const unsigned int valuesPerState = Recording::GetValuesPerState(ids.size());
+            const unsigned int stateCount = chunks.at(decodedChunkIndex).stateCount;
+
+            unsigned int low = 0;
+            unsigned int high = stateCount;
+            while (high - low > 1) {
+                const unsigned int middle = (low + high) / 2;
+                if (decodedChunk.at(middle * valuesPerState) <= time) {
+                    low = middle;
+                } else {
+                    high = middle;
+                }
+            }
+
+            return low;
+        }
+
+        auto ApplyState(const unsigned int state) -> void {
+            const unsigned int valuesPerState = Recording::GetValuesPerState(ids.size());
+            const unsigned int offset = state * valuesPerState;
+
+            currentTime = decodedChunk.at(offset);
+            for (unsigned int i = 0; i < ids.size(); i++) {
+                // Bodies that have since been removed (eg. by loading another scenario) are skipped
+                if (Bodies::GetBodies().count(ids.at(i)) == 0) {
+                    continue;
+                }
+
+                const unsigned int body = offset + 1 + (i * Recording::VALUES_PER_BODY);
+                const OrbitPoint point{
+                    dvec3(decodedChunk.at(body + 0), decodedChunk.at(body + 1), decodedChunk.at(body + 2)),
+                    dvec3(decodedChunk.at(body + 3), decodedChunk.at(body + 4), decodedChunk.at(body + 5))};
+                Bodies::UpdateBody(ids.at(i), point);
+            }
+        }
+    }
+
+    auto Open(const string &path) -> bool {
+        ZoneScoped;
+        Close();
+
+        const int file = open(path.c_str(), O_RDONLY); // NOLINT(cppcoreguidelines-pro-type-vararg)
+        if (file == -1) {
+            Log(ERROR, "Failed to open recording at " + path);
+            return false;
+        }
+
+        struct stat status {};
+        if ((fstat(file, &status) == -1) || (uint64_t(status.st_size) < sizeof(Recording::FileHeader))) {
+            Log(ERROR, "Recording at " + path + " is too small to contain a header");
+            close(file);
+            return false;
+        }
+
+        size = status.st_size;
+        data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        close(file); // The mapping stays valid after the file descriptor is closed
+
+        if (data == MAP_FAILED) { // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+            Log(ERROR, "Failed to map recording at " + path);
+            data = nullptr;
+            return false;
+        }
+
+        // Scrubbing jumps around the file, so readahead would mostly fetch pages we never touch
+        madvise(data, size, MADV_RANDOM);
+
+        Recording::FileHeader header {};
+        memcpy(&header, data, sizeof(header));
+        if ((header.magic != Recording::MAGIC) || (header.version != Recording::VERSION)
+                || (sizeof(header) + header.stringTableSize > size) || !ParseStringTable(header)) {
+            Log(ERROR, "Recording at " + path + " has an invalid header");
+            Close();
+            return false;
+        }
+
+        BuildChunkIndex(sizeof(header) + header.stringTableSize);
+        if (chunks.empty()) {
+            Log(ERROR, "Recording at " + path + " does not contain any states");
+            Close();
+            return false;
+        }
+
+        Seek(GetStartTime());
+        return true;
+    }
+
+    auto Close() -> void {
+        if (data != nullptr) {
+            munmap(data, size);
+        }
+
+        data = nullptr;
+        size = 0;
+        ids.clear();
+        chunks.clear();
+        decodedChunk.clear();
+        decodedChunkIndex = -1;
+        currentTime = 0;
+    }
+
+    auto Seek(const double time) -> void {
+        ZoneScoped;
+        if (!IsOpen()) {
+            return;
+        }
+
+        if (!DecodeChunk(FindChunk(time))) {
+            return;
+        }
+
+        ApplyState(FindState(time));
+    }
+
+    auto IsOpen() -> bool {
+        return data != nullptr;
+    }
+
+    auto GetStartTime() -> double {
+        return chunks.empty() ? 0 : chunks.front().startTime;
+    }
+
+    auto GetEndTime() -> double {
+        return chunks.empty() ? 0 : chunks.back().endTime;
+    }
+
+    auto GetTime() -> double {
+        return currentTime;
+    }
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <util/Types.h>
+
+
+
+namespace Replay {
+    // Maps a recording into memory and moves bodies to the recorded state closest to a requested time
+    auto Open(const string &path) -> bool;
+    auto Close() -> void;
+    auto Seek(const double time) -> void;
+
+    auto IsOpen() -> bool;
+    auto GetStartTime() -> double;
+    auto GetEndTime() -> double;
+    auto GetTime() -> double;
+}
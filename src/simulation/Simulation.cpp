@@ -2,14 +2,31 @@
 #include "simulation/SimulationState.h"
 
 #include <rendering/world/OrbitPaths.h>
+#include <simulation/Events.h>
+#include <simulation/Hermite.h>
+#include <simulation/Maneuvers.h>
+#include <simulation/OrbitalElements.h>
+#include <simulation/OsculatingElements.h>
+#include <simulation/PathSampler.h>
+#include <simulation/PredictionCache.h>
+#include <simulation/Recorder.h>
+#include <simulation/Replay.h>
+#include <simulation/Trajectory.h>
 #include <bodies/Body.h>
 #include <glm/gtx/string_cast.hpp>
 #include <input/Keys.h>
 #include <main/Bodies.h>
 #include <mutex>
 #include <simulation/OrbitPoint.h>
+#include <util/Constants.h>
+#include <util/Log.h>
 
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
 #include <string>
 #include <tracy/Tracy.hpp>
 #include <unordered_map>
@@ -22,12 +39,10 @@ namespace Simulation {
 
     namespace {
         const unsigned int STATE_CACHE_RESERVE = 128;
-        const unsigned int POINT_RENDER_INTERVAL = 5;
 
         const unsigned int INITIAL_SPEED_VALUE = 1;
         const unsigned int INITIAL_SPEED_DEGREE = 1;
         const unsigned int INITIAL_TIME_STEP = 0;
-        const unsigned int INITIAL_TIME_SINCE_LAST_STATE_UPDATE = 0;
 
         const unsigned int SPEED_MULTIPLIER = 4;
         const unsigned int MAX_SPEED_DEGREE = 12;
@@ -36,6 +51,18 @@ namespace Simulation {
 
         const unsigned int TIME_STEP_SIZE = 10000;
 
+        // Only every few future states are kept for trajectory queries; Hermite interpolation between them is
+        // still accurate to a few hundred metres along the Moon's orbit
+        const unsigned int TRAJECTORY_STEP_INTERVAL = 4;
+
+        // The preview sketches the whole horizon with much larger steps before the refined prediction fills it in,
+        // so even expensive scenarios show where bodies are heading within a few frames
+        const unsigned int PREVIEW_STEP_MULTIPLIER = 10;
+
+        // Matches the fixed horizon of OrbitPaths::GetMaxFutureStates() steps used before horizons were configurable
+        const double DEFAULT_HORIZON_DURATION = 2.0e9;
+        const double DEFAULT_PREDICTION_BUDGET = 0.010;
+
         std::atomic_bool terminateUpdate = false;
 
 
@@ -45,7 +72,9 @@ namespace Simulation {
         std::mutex stateMutex;
         SimulationState staticState;
         SimulationState state;
+        SimulationState previousState;
         SimulationState futureState;
+        SimulationState previewState;
 
         vector<SimulationState> stateCache;
 
@@ -53,30 +82,33 @@ namespace Simulation {
         double speedDegree = INITIAL_SPEED_DEGREE;
 
         double timeStep = INITIAL_TIME_STEP;
-        double timeSinceLastStateUpdate = INITIAL_TIME_SINCE_LAST_STATE_UPDATE;
         
         unsigned int futureStep = 0;
 
-        auto ShouldNewStateBeAdded() -> bool {
-            // Returns true every 'POINT_RENDER_INTERVAL'th time it is called
-            static int x = 0;
-            x++;
-            if (x >= POINT_RENDER_INTERVAL) {
-                x = 0;
-                return true;
+        HorizonType horizonType = HORIZON_TYPE_DURATION;
+        double horizonValue = DEFAULT_HORIZON_DURATION;
+        double horizonDuration = DEFAULT_HORIZON_DURATION;
+        // Set from the interface while the update thread reads it
+        std::atomic<double> predictionBudget = DEFAULT_PREDICTION_BUDGET;
+
+        std::atomic<double> previewProgress = 0;
+        std::atomic<double> predictionProgress = 0;
+
+        // Number of future steps computed since the future state was last reset, including any restored from the prediction cache
+        unsigned int futureStepsSinceReset = 0;
+        bool predictionCacheChecked = false;
+
+        // Decides which future states become path vertices; the past path is made of the same vertices once
+        // the simulation reaches them, so only the future needs sampling
+        PathSampler futureSampler;
+        vector<PathVertex> newVertices;
+
+        auto AddNewVertices() -> void {
+            if (!newVertices.empty()) {
+                OrbitPaths::AddVertices(newVertices);
+                PredictionCache::AddVertices(newVertices);
+                newVertices.clear();
             }
-            return false;
-        }
-
-        auto ShouldNewStateBeRendered() -> bool {
-            // Returns true every 'POINT_RENDER_INTERVAL'th time it is called
-            static int x = 0;
-            x++;
-            if (x >= POINT_RENDER_INTERVAL) {
-                x = 0;
-                return true;
-            }
-            return false;
         }
 
         auto IncreaseSimulationSpeed() -> void {
@@ -103,29 +135,263 @@ namespace Simulation {
                 initialStateMap.insert(std::make_pair(pair.first, initialOrbitPoint));
             }
 
-            return initialStateMap;
+            SimulationState initialState(initialStateMap);
+            initialState.SetAbsorbed(Bodies::GetAbsorbed());
+            return initialState;
+        }
+
+        auto StepFutureState() -> void {
+            const double previousTime = futureState.GetTime();
+            const unsigned int absorbedCount = futureState.GetAbsorbed().size();
+            futureState.StepToNextState(TIME_STEP_SIZE);
+
+            // The cache only stores points, so it can't restore a prediction in which bodies merged
+            if (futureState.GetAbsorbed().size() != absorbedCount) {
+                PredictionCache::Abandon();
+            }
+            Maneuvers::Apply(futureState, previousTime);
+            futureSampler.Sample(futureState, newVertices);
+            futureStep++;
+            futureStepsSinceReset++;
+            Events::AddState(futureState);
+            if (futureStepsSinceReset % TRAJECTORY_STEP_INTERVAL == 0) {
+                Trajectory::AddState(futureState);
+            }
         }
 
         auto UpdateState() -> void {
-            while (timeSinceLastStateUpdate >= Simulation::GetTimeStepSize()) {
+            // state is kept one step ahead of the current time, so there is always a state either side of it to
+            // interpolate between when bodies are drawn
+            while (state.GetTime() <= timeStep) {
                 ZoneNamedN(STEP, "Step to next state", true);
-                timeSinceLastStateUpdate -= Simulation::GetTimeStepSize();
+
+                // The paths are built from the future state, so it must never fall behind
+                if (futureStep == 0) {
+                    StepFutureState();
+                }
+
+                previousState = state;
                 state.StepToNextState(TIME_STEP_SIZE);
+                Maneuvers::Apply(state, previousState.GetTime());
                 ZoneNamedN(BODY_STEP, "Step bodies to next state", true);
                 stateCache.push_back(state);
                 futureStep--;
             }
         }
 
+        auto UpdateBodies() -> void {
+            // Bodies are drawn at exactly the current time, interpolated between the states either side of it,
+            // so motion looks smooth however large the integration step is
+            const double interval = state.GetTime() - previousState.GetTime();
+            if (interval <= 0) {
+                for (const auto &pair : state.GetOrbitPoints()) {
+                    Bodies::UpdateBody(pair.first, pair.second);
+                }
+                return;
+            }
+
+            const double fraction = std::clamp((timeStep - previousState.GetTime()) / interval, 0.0, 1.0);
+            const unordered_map<string, OrbitPoint> &previousPoints = previousState.GetOrbitPoints();
+            for (const auto &pair : state.GetOrbitPoints()) {
+                const auto previous = previousPoints.find(pair.first);
+                if (previous == previousPoints.end()) {
+                    Bodies::UpdateBody(pair.first, pair.second);
+                    continue;
+                }
+                Bodies::UpdateBody(pair.first, Hermite::Interpolate(previous->second, pair.second, interval, fraction));
+            }
+        }
+
+        auto ApplyMerges() -> void {
+            // The prediction merges bodies well before the simulation reaches them, but the bodies themselves only
+            // change once it does
+            const unordered_map<string, string> &merged = Bodies::GetAbsorbed();
+            for (const auto &pair : state.GetAbsorbed()) {
+                const auto existing = merged.find(pair.first);
+                if ((existing == merged.end()) || (existing->second != pair.second)) {
+                    Bodies::MergeBody(pair.first, pair.second, state.GetMass(pair.second), state.GetRadius(pair.second));
+                }
+            }
+        }
+
+        auto CalculateOrbitalPeriod(const string &id) -> double {
+            // Returns 0 if the body is not in a closed orbit around anything
+            const string dominantId = Bodies::FindStrongestPull(id, {});
+            if (dominantId.empty()) {
+                return 0;
+            }
+
+            const Body &body = Bodies::GetBody(id);
+            const Body &dominant = Bodies::GetBody(dominantId);
+            const double mu = GRAVITATIONAL_CONSTANT * (body.GetMass() + dominant.GetMass());
+            const OrbitalElements elements = OrbitalElementsUtil::Calculate(
+                body.GetPosition() - dominant.GetPosition(), body.GetVelocity() - dominant.GetVelocity(), mu);
+            return OrbitalElementsUtil::GetPeriod(elements, mu);
+        }
+
+        auto ResolveHorizon() -> void {
+            // Falls back to the default duration if the horizon is measured in periods but there is no suitable orbit
+            horizonDuration = DEFAULT_HORIZON_DURATION;
+            if (horizonType == HORIZON_TYPE_DURATION) {
+                horizonDuration = horizonValue;
+            } else if (Bodies::IsBodySelected()) {
+                const double period = CalculateOrbitalPeriod(Bodies::GetSelectedBodyId());
+                if (period > 0) {
+                    horizonDuration = horizonValue * period;
+                }
+            }
+        }
+
+        auto GetHorizonSteps() -> unsigned int {
+            // Capped so the future path cannot grow without bound
+            const double steps = std::ceil(horizonDuration / TIME_STEP_SIZE);
+            return unsigned(std::min(steps, double(OrbitPaths::GetMaxFutureStates())));
+        }
+
+        auto LoadPredictionCache() -> void {
+            // Done here rather than in NewBodyReset, since OrbitPaths is only reset after the simulation
+            predictionCacheChecked = true;
+            const unsigned int cachedSteps = PredictionCache::Load(futureState);
+            futureStep += cachedSteps;
+            futureStepsSinceReset = cachedSteps;
+
+            if (cachedSteps == 0) {
+                futureSampler.Start(futureState, newVertices);
+                AddNewVertices();
+                Trajectory::AddState(futureState);
+                Events::AddState(futureState);
+            } else {
+                // Events are not cached, but the restored trajectory is dense enough to find them again
+                futureSampler.Resume(futureState);
+                vector<double> times;
+                vector<OrbitPoint> points;
+                Trajectory::GetStates(Trajectory::GetStartTime(), times, points);
+                Events::AddStates(times, points);
+            }
+        }
+
+        auto UpdatePreview(const double horizonEndTime, const std::chrono::steady_clock::time_point deadline) -> void {
+            ZoneScoped;
+            // Not worth it once the refined prediction is within one preview step of the horizon, which is
+            // the usual case after the first few frames, as the refined prediction only needs to keep pace
+            const double previewStepSize = double(TIME_STEP_SIZE) * PREVIEW_STEP_MULTIPLIER;
+            if (horizonEndTime - futureState.GetTime() <= previewStepSize) {
+                return;
+            }
+
+            // Anything the preview had computed behind the refined prediction is useless, so it restarts from there
+            if (previewState.GetTime() < futureState.GetTime()) {
+                previewState = futureState;
+            }
+
+            while ((previewState.GetTime() < horizonEndTime) && (!terminateUpdate) && (std::chrono::steady_clock::now() < deadline)) {
+                const double previousTime = previewState.GetTime();
+                previewState.StepToNextState(previewStepSize);
+                Maneuvers::Apply(previewState, previousTime);
+                OrbitPaths::AddPreviewState(previewState);
+            }
+        }
+
+        auto UpdateProgress(const double horizonEndTime) -> void {
+            const double startTime = state.GetTime();
+            const double horizon = horizonEndTime - startTime;
+            if (horizon <= 0) {
+                previewProgress = 1;
+                predictionProgress = 1;
+                return;
+            }
+            predictionProgress = std::clamp((futureState.GetTime() - startTime) / horizon, 0.0, 1.0);
+            previewProgress = std::max(predictionProgress.load(), std::clamp((previewState.GetTime() - startTime) / horizon, 0.0, 1.0));
+        }
+
+        auto ReplanBody(const string &id, const double fromTime) -> void {
+            ZoneScoped;
+            // Nothing has been predicted past the node yet, so the future state will apply it when it gets there
+            if (fromTime > futureState.GetTime() + (TIME_STEP_SIZE / 2.0)) {
+                return;
+            }
+
+            // Start from the last stored state before the node; states at the node's own time already include
+            // the node as it was before the edit
+            vector<double> times;
+            vector<OrbitPoint> points;
+            Trajectory::GetStates(fromTime - double((TRAJECTORY_STEP_INTERVAL + 1) * TIME_STEP_SIZE), times, points);
+            const vector<string> ids = Trajectory::GetIds();
+            unsigned int firstState = 0;
+            while ((firstState + 1 < times.size()) && (times.at(firstState + 1) < fromTime - (TIME_STEP_SIZE / 2.0))) {
+                firstState++;
+            }
+            if (times.empty() || (times.at(firstState) >= fromTime - (TIME_STEP_SIZE / 2.0))) {
+                Log(WARN, "Can't recompute the path after a maneuver node outside the stored trajectory");
+                return;
+            }
+            times.erase(times.begin(), times.begin() + firstState);
+            points.erase(points.begin(), points.begin() + long(firstState * ids.size()));
+
+            // The future state is usually a few steps ahead of the last stored state
+            if (futureState.GetTime() > times.back() + (TIME_STEP_SIZE / 2.0)) {
+                times.push_back(futureState.GetTime());
+                for (const string &otherId : ids) {
+                    points.push_back(futureState.GetOrbitPoints().at(otherId));
+                }
+            }
+
+            vector<PathVertex> vertices;
+            const dvec3 acceleration = Maneuvers::Repropagate(id, ids, times, points, futureState.GetAbsorbed(), vertices);
+            const unsigned int body = std::lower_bound(ids.begin(), ids.end(), id) - ids.begin();
+            vector<OrbitPoint> bodyPoints;
+            for (unsigned int state = 0; state < times.size(); state++) {
+                bodyPoints.push_back(points.at((state * ids.size()) + body));
+            }
+
+            Trajectory::SetBodyStates(id, times, bodyPoints);
+            Events::RedetectBody(id, times, points);
+            OrbitPaths::ReplaceFuture(id, times.front(), vertices);
+            futureState.SetOrbitPoint(id, bodyPoints.back(), acceleration);
+            futureSampler.ResumeBody(id, bodyPoints.back());
+        }
+
+        auto ReplanManeuvers() -> void {
+            // Only the edited bodies are recomputed, from their earliest edited node onwards, since massless bodies
+            // have no effect on anything else
+            const unordered_map<string, double> edits = Maneuvers::TakeEdits();
+            if (edits.empty()) {
+                return;
+            }
+
+            // The prediction no longer follows from the initial state alone
+            PredictionCache::Abandon();
+            for (const auto &pair : edits) {
+                ReplanBody(pair.first, pair.second);
+            }
+
+            // The preview was computed from the old future state
+            previewState = futureState;
+            OrbitPaths::DiscardPreviewBefore(std::numeric_limits<double>::max());
+        }
+
         auto UpdateFutureState() -> void {
             ZoneScoped;
             terminateUpdate = false;
-            while ((futureStep < OrbitPaths::GetMaxFutureStates()) && (!terminateUpdate)) {
-                futureState.StepToNextState(TIME_STEP_SIZE);
-                if (ShouldNewStateBeAdded()) {
-                    OrbitPaths::AddNewState(futureState);
-                }
-                futureStep++;
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(predictionBudget.load()));
+
+            // Once the horizon is reached nothing more is computed until the simulation moves forward, so cheap
+            // scenarios no longer use the whole frame, while expensive ones stop when their CPU budget is used up
+            const unsigned int horizonSteps = GetHorizonSteps();
+            const double horizonEndTime = state.GetTime() + (double(horizonSteps) * TIME_STEP_SIZE);
+            UpdatePreview(horizonEndTime, deadline);
+
+            while ((futureStep < horizonSteps) && (!terminateUpdate) && (std::chrono::steady_clock::now() < deadline)) {
+                StepFutureState();
+            }
+            AddNewVertices();
+
+            OrbitPaths::DiscardPreviewBefore(futureState.GetTime());
+            UpdateProgress(horizonEndTime);
+
+            // The first complete horizon after a reset is what gets cached; anything beyond it depends on how far the simulation has run
+            if (futureStep >= horizonSteps) {
+                PredictionCache::Finish(futureState, futureStepsSinceReset);
             }
         }
     }
@@ -140,35 +406,57 @@ namespace Simulation {
         speedValue = INITIAL_SPEED_VALUE;
         speedDegree = INITIAL_SPEED_DEGREE;
         timeStep = INITIAL_TIME_STEP;
-        timeSinceLastStateUpdate = INITIAL_TIME_SINCE_LAST_STATE_UPDATE;
         futureStep = 0;
+
+        // Keep whatever part of the prediction was computed before the scenario is replaced
+        PredictionCache::Finish(futureState, futureStepsSinceReset);
     }
 
     auto NewBodyReset() -> void {
         // To be called when a new body is added to the system
         std::lock_guard<std::mutex> lock(stateMutex);
-        staticState = futureState = state = AcquireInitialState();
+        PredictionCache::Finish(futureState, futureStepsSinceReset);
+        staticState = previewState = futureState = previousState = state = AcquireInitialState();
+        staticState.SetTime(timeStep);
+        futureState.SetTime(timeStep);
+        previewState.SetTime(timeStep);
+        previousState.SetTime(timeStep);
+        state.SetTime(timeStep);
+
+        // The future is recomputed from the new initial state, unless it is found in the prediction cache
+        futureStep = 0;
+        futureStepsSinceReset = 0;
+        predictionCacheChecked = false;
+        Trajectory::NewBodyReset(futureState);
+        Events::NewBodyReset(futureState);
+        OsculatingElements::NewBodyReset();
+        Maneuvers::NewBodyReset(timeStep, TIME_STEP_SIZE);
+        PredictionCache::NewBodyReset(futureState, TIME_STEP_SIZE);
     }
 
     auto FrameUpdate() -> void {
         std::lock_guard<std::mutex> lock(stateMutex);
         staticState = state;
+        ResolveHorizon();
+        ReplanManeuvers();
 
         // Update all the paths
         // If we did this in the main update function, the paths would be indepedently updated from the other update functions
         // So depending on where the update function was called in the frame, we might end up with an inconsistent state
         // where the orbit paths indicate the body is somewhere else
-        for (SimulationState state : stateCache) {
-            if (ShouldNewStateBeRendered()) {
-                OrbitPaths::StepToNextState(state);
-            }
+        for (const SimulationState &state : stateCache) {
+            Recorder::RecordState(state);
         }
-
-        // Now update the body to correspond to the latest state
-        if (!stateCache.empty()) {
-            SimulationState latestState = stateCache.at(stateCache.size()-1);
-            for (const auto &pair : latestState.GetOrbitPoints())
-            Bodies::UpdateBody(pair.first, pair.second);
+        OrbitPaths::StepToTime(timeStep);
+        Trajectory::StepToTime(timeStep);
+        Events::StepToTime(timeStep);
+        OsculatingElements::Publish();
+
+        // Now update the bodies to correspond to the current time
+        // While a recording is being replayed, the replay decides where bodies are drawn instead
+        if (!Replay::IsOpen()) {
+            ApplyMerges();
+            UpdateBodies();
         }
 
         stateCache.clear();
@@ -178,9 +466,20 @@ namespace Simulation {
         // This function is run async to basically everything else
         ZoneScoped;
         timeStep += deltaTime * speedValue;
-        timeSinceLastStateUpdate += deltaTime * speedValue;
+
+        // Restoring a cached prediction replaces the future state, so it has to happen before anything steps it
+        if (!predictionCacheChecked) {
+            LoadPredictionCache();
+        }
+
         UpdateState();
-        UpdateFutureState();        
+        UpdateFutureState();
+        OsculatingElements::Calculate(state);
+    }
+
+    auto Shutdown() -> void {
+        PredictionCache::Finish(futureState, futureStepsSinceReset);
+        PredictionCache::Shutdown();
     }
 
     auto TerminateUpdate() -> void {
@@ -208,11 +507,50 @@ namespace Simulation {
         return staticState.CalculateTotalAcceleration(id);
     }
 
+    auto SetHorizon(const HorizonType type, const double value) -> void {
+        horizonType = type;
+        horizonValue = value;
+    }
+
+    auto GetHorizonType() -> HorizonType {
+        return horizonType;
+    }
+
+    auto GetHorizonValue() -> double {
+        return horizonValue;
+    }
+
+    auto GetHorizonDuration() -> double {
+        return horizonDuration;
+    }
+
+    auto SetPredictionBudget(const double budget) -> void {
+        predictionBudget = budget;
+    }
+
+    auto GetPredictionBudget() -> double {
+        return predictionBudget;
+    }
+
+    auto GetPreviewProgress() -> double {
+        return previewProgress;
+    }
+
+    auto GetPredictionProgress() -> double {
+        return predictionProgress;
+    }
+
     auto GetTimeStep() -> double {
         return timeStep;
     }
 
     auto SetTimeStep(const double _timeStep) -> void {
+        std::lock_guard<std::mutex> lock(stateMutex);
         timeStep = _timeStep;
+        staticState.SetTime(timeStep);
+        futureState.SetTime(timeStep);
+        previewState.SetTime(timeStep);
+        previousState.SetTime(timeStep);
+        state.SetTime(timeStep);
     }
 }
\ No newline at end of file
@@ -5,6 +5,11 @@
 
 
 
+enum HorizonType {
+    HORIZON_TYPE_DURATION,
+    HORIZON_TYPE_ORBITAL_PERIODS
+};
+
 namespace Simulation {
 
     auto Init() -> void;
@@ -13,6 +18,7 @@ namespace Simulation {
     auto FrameUpdate() -> void;
     auto Update(const double deltaTime) -> void;
     auto TerminateUpdate() -> void;
+    auto Shutdown() -> void;
     
     auto GetSpeedValue() -> double;
     auto GetSpeedDegree() -> double;
@@ -21,6 +27,21 @@ namespace Simulation {
 
     auto GetAcceleration(const string &id) -> dvec3;
 
+    // The future is predicted up to a horizon in simulation time; either a fixed duration in seconds,
+    // or a number of orbital periods of the selected body around whichever body attracts it most strongly
+    auto SetHorizon(const HorizonType type, const double value) -> void;
+    auto GetHorizonType() -> HorizonType;
+    auto GetHorizonValue() -> double;
+    auto GetHorizonDuration() -> double;
+
+    // Maximum CPU time, in seconds, spent extending the prediction each frame
+    auto SetPredictionBudget(const double budget) -> void;
+    auto GetPredictionBudget() -> double;
+
+    // Fraction of the horizon covered by the coarse preview and by the refined prediction
+    auto GetPreviewProgress() -> double;
+    auto GetPredictionProgress() -> double;
+
     auto GetTimeStep() -> double;
     auto SetTimeStep(const double _timeStep) -> void;
 }
\ No newline at end of file
@@ -22,9 +22,13 @@ namespace SimulationEnergy {
 
     auto GetPotentialEnergy(const Body &body) -> double {
         ZoneScoped;
+        // Absorbed bodies have no mass, and sit exactly on the body they merged into
         double energy = 0;
+        if (Bodies::IsAbsorbed(body.GetId())) {
+            return energy;
+        }
         for (const auto &pair : Bodies::GetMassiveBodies()) {
-            if (pair.first == body.GetId()) {
+            if ((pair.first == body.GetId()) || Bodies::IsAbsorbed(pair.first)) {
                 continue;
             }
             energy -= PotentialEnergy(body, pair.second);
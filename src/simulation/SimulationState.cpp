@@ -1,16 +1,58 @@
 #include "SimulationState.h"
 #include <glm/gtx/string_cast.hpp>
+#include <simulation/Collisions.h>
 #include <simulation/OrbitPoint.h>
+#include <simulation/Kepler.h>
+#include <simulation/Rails.h>
+#include <simulation/Regularization.h>
+#include <simulation/SoiHierarchy.h>
 #include "rendering/geometry/Rays.h"
 
 #include <main/Bodies.h>
 
+#include <algorithm>
+#include <cmath>
 
 
-SimulationState::SimulationState() {}
+
+namespace {
+    struct EnckeBody {
+        const string* id;
+        OrbitPoint* point;
+        double mu;
+    };
+
+    struct RailsBody {
+        const string* id;
+        OrbitPoint* point;
+        unsigned int parent;
+        unsigned int parentDepth;
+        OrbitPoint relative;
+        double mu;
+    };
+
+    struct CloseCandidate {
+        double fallTime;
+        unsigned int first;
+        unsigned int second;
+    };
+
+    auto CompareParentDepth(const RailsBody &a, const RailsBody &b) -> bool {
+        return a.parentDepth < b.parentDepth;
+    }
+
+    auto CompareFallTime(const CloseCandidate &a, const CloseCandidate &b) -> bool {
+        return a.fallTime < b.fallTime;
+    }
+}
+
+
+
+SimulationState::SimulationState()
+    : time(0) {}
 
 SimulationState::SimulationState(unordered_map<string, OrbitPoint> _points)
-    : points(std::move(_points)) {
+    : points(std::move(_points)), time(0) {
         for (const auto &pair : points) {
             oldAcceleration.insert(std::make_pair(pair.first, 0));
         }
@@ -28,21 +70,57 @@ auto SimulationState::CalculateIndividualAcceleration(const string &acceleration
     const dvec3 direction = glm::normalize(displacement);
 
     ZoneNamedN(CalculateIndividualAcceleration3, "CalculateIndividualAcceleration3", true);
-    const double withRespectTo_mass = Bodies::GetBody(withRespectTo).GetMass();
+    const double withRespectTo_mass = GetMass(withRespectTo);
     const double distance = glm::length(displacement);
+
+    // Plummer softening spreads each mass out over the softening length, so the force falls back to zero at zero distance
+    const double softening = Regularization::GetSoftening();
+    if (softening > 0) {
+        const double softenedSquared = (distance * distance) + (softening * softening);
+        return displacement * (GRAVITATIONAL_CONSTANT * withRespectTo_mass / (softenedSquared * std::sqrt(softenedSquared)));
+    }
+
     const double accelerationScalar = GRAVITATIONAL_CONSTANT * withRespectTo_mass / (distance * distance);
     
     return direction * accelerationScalar;
 }
 
 auto SimulationState::CalculateTotalAcceleration(const string &id) -> dvec3 {
+    // An absorbed body is wherever the body it merged into is, so it is accelerated the same way
+    if (!absorbed.empty()) {
+        const auto survivor = absorbed.find(id);
+        if (survivor != absorbed.end()) {
+            return CalculateTotalAcceleration(survivor->second);
+        }
+    }
+
+    const bool findStrongest = Regularization::IsEnabled() && (Regularization::GetSoftening() == 0);
+    bool massive = false;
+    const string* strongest = nullptr;
+    double strongestPull = 0;
     dvec3 acceleration = dvec3(0, 0, 0);
     for (const auto &pair : Bodies::GetMassiveBodies()) {
         if (pair.first == id) {
+            massive = true;
+            continue;
+        }
+        if (!absorbed.empty() && (absorbed.find(pair.first) != absorbed.end())) {
             continue;
         }
 
-        acceleration -= CalculateIndividualAcceleration(id, pair.first);
+        const dvec3 individual = CalculateIndividualAcceleration(id, pair.first);
+        acceleration -= individual;
+        if (findStrongest) {
+            const double pull = glm::dot(individual, individual);
+            if (pull > strongestPull) {
+                strongestPull = pull;
+                strongest = &pair.first;
+            }
+        }
+    }
+
+    if (findStrongest && massive && (strongest != nullptr)) {
+        strongestPulls[id] = *strongest;
     }
 
     return acceleration;
@@ -61,10 +139,323 @@ auto SimulationState::StepOrbitPoint(const string &id, OrbitPoint &point, const
 
 }
 
+auto SimulationState::CalculatePerturbation(const string &id, const string &primaryId, const double mu, const dvec3 &acceleration, const dvec3 &primaryAcceleration) -> dvec3 {
+    // Everything accelerating the body relative to its primary, apart from the primary's two-body pull
+    const dvec3 displacement = points.at(id).position - points.at(primaryId).position;
+    const double distance = glm::length(displacement);
+    return acceleration - primaryAcceleration + (displacement * (mu / (distance * distance * distance)));
+}
+
+auto SimulationState::StepEncke(const string &id, OrbitPoint &point, const double mu, const dvec3 &primaryAcceleration, const double timeStep) -> void {
+    // The reference orbit is moved exactly, and the deviation from it with the same velocity Verlet scheme as
+    // StepOrbitPoint; the primary must already have been stepped
+    EnckeOrbit &orbit = enckeOrbits.at(id);
+    const OrbitPoint &primary = points.at(orbit.primaryId);
+    point.position = primary.position + Encke::Drift(orbit, mu, timeStep);
+
+    const dvec3 acceleration = CalculateTotalAcceleration(id);
+    const dvec3 perturbation = CalculatePerturbation(id, orbit.primaryId, mu, acceleration, primaryAcceleration);
+    point.velocity = primary.velocity + Encke::Kick(orbit, mu, perturbation, timeStep);
+    oldAcceleration.at(id) = acceleration;
+}
+
+auto SimulationState::FindClosePairs(const double timeStep, vector<bool> &integrated) -> vector<ClosePair> {
+    // Each massive body is paired with whatever pulls on it hardest, if they would fall together within a few steps
+    // The closest pairs are taken first, and a body can only be in one pair
+    // The strongest pull was noted when the acceleration at these positions was calculated at the end of the last
+    // step; the candidates are only searched when there is no note, or it names a body that can't be paired
+    struct Candidate {
+        const string* id;
+        OrbitPoint* point;
+        unsigned int index;
+        double mass;
+    };
+    vector<Candidate> candidates;
+    unordered_map<string, unsigned int> candidateIndices;
+    const unordered_map<string, Massive> &massiveBodies = Bodies::GetMassiveBodies();
+    unsigned int index = 0;
+    for (auto &pair : points) {
+        if ((massiveBodies.find(pair.first) != massiveBodies.end()) && !Rails::IsOnRails(pair.first) && !IsAbsorbed(pair.first)) {
+            candidateIndices.insert(std::make_pair(pair.first, candidates.size()));
+            candidates.push_back(Candidate{&pair.first, &pair.second, index, GetMass(pair.first)});
+        }
+        index++;
+    }
+
+    vector<CloseCandidate> close;
+    const double maxFallTime = Regularization::GetCloseSteps() * timeStep;
+    for (unsigned int i = 0; i < candidates.size(); i++) {
+        int strongest = -1;
+        const auto note = strongestPulls.find(*candidates.at(i).id);
+        if (note != strongestPulls.end()) {
+            const auto candidateIndex = candidateIndices.find(note->second);
+            if (candidateIndex != candidateIndices.end()) {
+                strongest = int(candidateIndex->second);
+            }
+        }
+        if (strongest < 0) {
+            double strongestPull = 0;
+            for (unsigned int j = 0; j < candidates.size(); j++) {
+                const dvec3 displacement = candidates.at(j).point->position - candidates.at(i).point->position;
+                const double distanceSquared = glm::dot(displacement, displacement);
+                if ((i != j) && (candidates.at(j).mass > strongestPull * distanceSquared)) {
+                    strongestPull = candidates.at(j).mass / distanceSquared;
+                    strongest = int(j);
+                }
+            }
+        }
+        if (strongest < 0) {
+            continue;
+        }
+        const Candidate &other = candidates.at(strongest);
+        const double distance = glm::length(other.point->position - candidates.at(i).point->position);
+        const double fallTime = std::sqrt(distance * distance * distance / (GRAVITATIONAL_CONSTANT * (candidates.at(i).mass + other.mass)));
+        if (fallTime < maxFallTime) {
+            close.push_back(CloseCandidate{fallTime, i, unsigned(strongest)});
+        }
+    }
+    std::sort(close.begin(), close.end(), CompareFallTime);
+
+    vector<ClosePair> pairs;
+    vector<bool> paired(candidates.size(), false);
+    for (const CloseCandidate &candidate : close) {
+        if (paired.at(candidate.first) || paired.at(candidate.second)) {
+            continue;
+        }
+        paired.at(candidate.first) = true;
+        paired.at(candidate.second) = true;
+        const Candidate &first = candidates.at(candidate.first);
+        const Candidate &second = candidates.at(candidate.second);
+        integrated.at(first.index) = false;
+        integrated.at(second.index) = false;
+
+        // The pull of everything except the other body of the pair, at the start of the step
+        pairs.push_back(ClosePair{first.id, second.id, first.point, second.point, first.mass, second.mass,
+            CalculateTotalAcceleration(*first.id) + CalculateIndividualAcceleration(*first.id, *second.id),
+            CalculateTotalAcceleration(*second.id) + CalculateIndividualAcceleration(*second.id, *first.id)});
+    }
+    return pairs;
+}
+
+auto SimulationState::StepClosePair(const ClosePair &pair, const double timeStep) -> void {
+    // Kick, drift, kick: half the external pull, then the centre of mass in a straight line and the relative motion
+    // along its exact two-body orbit, then the other half of the external pull at the new positions
+    OrbitPoint &first = *pair.firstPoint;
+    OrbitPoint &second = *pair.secondPoint;
+    first.velocity += 0.5 * pair.firstExternalAcceleration * timeStep;
+    second.velocity += 0.5 * pair.secondExternalAcceleration * timeStep;
+
+    const double totalMass = pair.firstMass + pair.secondMass;
+    const double firstFraction = pair.firstMass / totalMass;
+    const double secondFraction = pair.secondMass / totalMass;
+    const dvec3 centre = (firstFraction * first.position) + (secondFraction * second.position);
+    const dvec3 centreVelocity = (firstFraction * first.velocity) + (secondFraction * second.velocity);
+    const OrbitPoint relative = Kepler::Propagate(OrbitPoint{first.position - second.position, first.velocity - second.velocity},
+        GRAVITATIONAL_CONSTANT * totalMass, timeStep);
+
+    const dvec3 newCentre = centre + (centreVelocity * timeStep);
+    first.position = newCentre + (secondFraction * relative.position);
+    second.position = newCentre - (firstFraction * relative.position);
+    first.velocity = centreVelocity + (secondFraction * relative.velocity);
+    second.velocity = centreVelocity - (firstFraction * relative.velocity);
+
+    const dvec3 firstAcceleration = CalculateTotalAcceleration(*pair.first);
+    const dvec3 secondAcceleration = CalculateTotalAcceleration(*pair.second);
+    first.velocity += 0.5 * (firstAcceleration + CalculateIndividualAcceleration(*pair.first, *pair.second)) * timeStep;
+    second.velocity += 0.5 * (secondAcceleration + CalculateIndividualAcceleration(*pair.second, *pair.first)) * timeStep;
+
+    // The full acceleration, so the pair can go back to being integrated normally once it separates
+    oldAcceleration.at(*pair.first) = firstAcceleration;
+    oldAcceleration.at(*pair.second) = secondAcceleration;
+}
+
+auto SimulationState::MergeCollisions(const vector<dvec3> &startPositions) -> void {
+    // Bodies are taken to move in straight lines over the step, which is close enough to find the ones that touched
+    vector<SweptSphere> spheres;
+    vector<const string*> ids;
+    unsigned int index = 0;
+    for (const auto &pair : points) {
+        if (!IsAbsorbed(pair.first)) {
+            spheres.push_back(SweptSphere{startPositions.at(index), pair.second.position, GetRadius(pair.first)});
+            ids.push_back(&pair.first);
+        }
+        index++;
+    }
+
+    // A body only merges once per step; anything else it touched will still be touching the merged body next step
+    vector<bool> merged(spheres.size(), false);
+    for (const Contact &contact : Collisions::Find(spheres)) {
+        if (merged.at(contact.first) || merged.at(contact.second)) {
+            continue;
+        }
+        merged.at(contact.first) = true;
+        merged.at(contact.second) = true;
+
+        // The heavier body survives; ties go by id, so every copy of the state makes the same choice
+        const string &first = *ids.at(contact.first);
+        const string &second = *ids.at(contact.second);
+        const double firstMass = GetMass(first);
+        const double secondMass = GetMass(second);
+        if ((firstMass > secondMass) || ((firstMass == secondMass) && (first < second))) {
+            MergeBodies(first, second);
+        } else {
+            MergeBodies(second, first);
+        }
+    }
+}
+
+auto SimulationState::MergeBodies(const string &survivorId, const string &absorbedId) -> void {
+    // Momentum and volume are conserved, and the merged body carries on from the centre of mass
+    OrbitPoint &survivor = points.at(survivorId);
+    const OrbitPoint &other = points.at(absorbedId);
+    const double survivorMass = GetMass(survivorId);
+    const double absorbedMass = GetMass(absorbedId);
+    const double totalMass = survivorMass + absorbedMass;
+    if (totalMass > 0) {
+        survivor.position = ((survivorMass * survivor.position) + (absorbedMass * other.position)) / totalMass;
+        survivor.velocity = ((survivorMass * survivor.velocity) + (absorbedMass * other.velocity)) / totalMass;
+    }
+
+    const double survivorRadius = GetRadius(survivorId);
+    const double absorbedRadius = GetRadius(absorbedId);
+    masses[survivorId] = totalMass;
+    masses[absorbedId] = 0;
+    radii[survivorId] = std::cbrt((survivorRadius * survivorRadius * survivorRadius) + (absorbedRadius * absorbedRadius * absorbedRadius));
+    radii[absorbedId] = 0;
+
+    // Anything the absorbed body had already absorbed now follows the survivor
+    for (auto &pair : absorbed) {
+        if (pair.second == absorbedId) {
+            pair.second = survivorId;
+        }
+    }
+    absorbed[absorbedId] = survivorId;
+
+    // Neither body is on its old orbit any more
+    enckeOrbits.erase(survivorId);
+    enckeOrbits.erase(absorbedId);
+    oldAcceleration.at(survivorId) = CalculateTotalAcceleration(survivorId);
+}
+
 auto SimulationState::StepToNextState(const double timeStep) -> void {
+    // Massive bodies are integrated directly, and massless bodies with Encke's method around their parent in the
+    // sphere-of-influence hierarchy, after the massive bodies since they need their new positions
+    // Bodies on rails are moved along Kepler orbits around their parent instead of being integrated
+    // Each step starts from the parent a body has now, so a body that crosses into another sphere of influence is
+    // re-seeded around its new parent without anything else having to notice
+    // Close pairs of massive bodies are regularized, unless softening already removes the singularity
+    // Bodies that touched at any point during the step are merged at the end of it
+    vector<RailsBody> rails;
+    vector<EnckeBody> encke;
+    vector<bool> integrated(points.size(), true);
+    vector<dvec3> startPositions;
+    startPositions.reserve(points.size());
+    unsigned int index = 0;
+    for (const auto &pair : points) {
+        startPositions.push_back(pair.second.position);
+        if (IsAbsorbed(pair.first)) {
+            integrated.at(index) = false;
+        }
+        index++;
+    }
+
+    SoiHierarchy hierarchy;
+    if (Rails::IsAnyOnRails() || !Bodies::GetMasslessBodies().empty()) {
+        ZoneNamedN(FIND_PARENTS, "Find parents", true);
+        hierarchy.Build(points, masses, absorbed);
+        const unordered_map<string, Massive> &massiveBodies = Bodies::GetMassiveBodies();
+        index = 0;
+        for (auto &pair : points) {
+            if (!integrated.at(index)) {
+                index++;
+                continue;
+            }
+            const bool onRails = Rails::IsOnRails(pair.first);
+            const bool massless = massiveBodies.find(pair.first) == massiveBodies.end();
+            const int parent = (onRails || massless) ? hierarchy.FindParent(pair.first, pair.second.position) : -1;
+            if (parent < 0) {
+                enckeOrbits.erase(pair.first);
+                index++;
+                continue;
+            }
+
+            const string &parentId = hierarchy.GetId(parent);
+            const OrbitPoint &parentPoint = hierarchy.GetPoint(parent);
+            const OrbitPoint relative{pair.second.position - parentPoint.position, pair.second.velocity - parentPoint.velocity};
+            const double mu = GRAVITATIONAL_CONSTANT * (hierarchy.GetMass(parent) + GetMass(pair.first));
+            if (onRails) {
+                rails.push_back(RailsBody{&pair.first, &pair.second, unsigned(parent), hierarchy.GetDepth(parent), relative, mu});
+                enckeOrbits.erase(pair.first);
+                strongestPulls.erase(pair.first);
+            } else {
+                // A new reference orbit is needed after a change of parent, or when the point was set from outside
+                const auto orbit = enckeOrbits.find(pair.first);
+                if ((orbit == enckeOrbits.end()) || (orbit->second.primaryId != parentId)) {
+                    const dvec3 perturbation = CalculatePerturbation(pair.first, parentId, mu, CalculateTotalAcceleration(pair.first), CalculateTotalAcceleration(parentId));
+                    enckeOrbits[pair.first] = Encke::Seed(parentId, relative, perturbation);
+                }
+                encke.push_back(EnckeBody{&pair.first, &pair.second, mu});
+            }
+            integrated.at(index) = false;
+            index++;
+        }
+    }
+
+    vector<ClosePair> closePairs;
+    if (Regularization::IsEnabled() && (Regularization::GetSoftening() == 0)) {
+        ZoneNamedN(FIND_CLOSE_PAIRS, "Find close pairs", true);
+        closePairs = FindClosePairs(timeStep, integrated);
+    } else {
+        // Nothing is noted while close pairs aren't regularized, so old notes would be out of date
+        strongestPulls.clear();
+    }
+
+    index = 0;
     for (auto &pair : points) {
-        StepOrbitPoint(pair.first, pair.second, timeStep);
+        if (integrated.at(index)) {
+            StepOrbitPoint(pair.first, pair.second, timeStep);
+        }
+        index++;
+    }
+
+    for (const ClosePair &pair : closePairs) {
+        StepClosePair(pair, timeStep);
+    }
+
+    // Parents are moved before their children, since a body on rails can be the parent of another
+    std::stable_sort(rails.begin(), rails.end(), CompareParentDepth);
+    for (RailsBody &body : rails) {
+        const OrbitPoint relative = Kepler::Propagate(body.relative, body.mu, timeStep);
+        const OrbitPoint &parentPoint = points.at(hierarchy.GetId(body.parent));
+        body.point->position = parentPoint.position + relative.position;
+        body.point->velocity = parentPoint.velocity + relative.velocity;
+
+        // Stored like an integrated body's, since the prediction cache saves it to resume stepping from
+        const double distance = glm::length(relative.position);
+        oldAcceleration.at(*body.id) = -relative.position * (body.mu / (distance * distance * distance));
+    }
+
+    // Many massless bodies usually share a primary, so each primary's acceleration is only calculated once
+    unordered_map<string, dvec3> primaryAccelerations;
+    for (const EnckeBody &body : encke) {
+        const string &primaryId = enckeOrbits.at(*body.id).primaryId;
+        auto primaryAcceleration = primaryAccelerations.find(primaryId);
+        if (primaryAcceleration == primaryAccelerations.end()) {
+            primaryAcceleration = primaryAccelerations.insert(std::make_pair(primaryId, CalculateTotalAcceleration(primaryId))).first;
+        }
+        StepEncke(*body.id, *body.point, body.mu, primaryAcceleration->second, timeStep);
+    }
+
+    {
+        ZoneNamedN(MERGE_COLLISIONS, "Merge collisions", true);
+        MergeCollisions(startPositions);
     }
+    for (const auto &pair : absorbed) {
+        points.at(pair.first) = points.at(pair.second);
+        oldAcceleration.at(pair.first) = oldAcceleration.at(pair.second);
+    }
+
+    time += timeStep;
 }
 
 auto SimulationState::Scale() -> void {
@@ -72,6 +463,60 @@ auto SimulationState::Scale() -> void {
         pair.second.position = Rays::Scale(pair.second.position);
     }
 }
-auto SimulationState::GetOrbitPoints() const -> unordered_map<string, OrbitPoint> {
+auto SimulationState::GetOrbitPoints() const -> const unordered_map<string, OrbitPoint>& {
     return points;
 }
+
+auto SimulationState::GetOldAcceleration(const string &id) const -> dvec3 {
+    return oldAcceleration.at(id);
+}
+
+auto SimulationState::SetOrbitPoint(const string &id, const OrbitPoint &point, const dvec3 &acceleration) -> void {
+    // Overwrites the existing entry rather than inserting, so the order bodies are stepped in stays the same
+    points.at(id) = point;
+    oldAcceleration.at(id) = acceleration;
+
+    // The point no longer follows from the Encke reference orbit, so a new one is started from it
+    enckeOrbits.erase(id);
+    strongestPulls.erase(id);
+}
+
+auto SimulationState::GetTime() const -> double {
+    return time;
+}
+
+auto SimulationState::SetTime(const double _time) -> void {
+    time = _time;
+}
+
+auto SimulationState::GetMass(const string &id) const -> double {
+    if (!masses.empty()) {
+        const auto mass = masses.find(id);
+        if (mass != masses.end()) {
+            return mass->second;
+        }
+    }
+    return Bodies::GetBody(id).GetMass();
+}
+
+auto SimulationState::GetRadius(const string &id) const -> double {
+    if (!radii.empty()) {
+        const auto radius = radii.find(id);
+        if (radius != radii.end()) {
+            return radius->second;
+        }
+    }
+    return Bodies::GetBody(id).GetRadius();
+}
+
+auto SimulationState::IsAbsorbed(const string &id) const -> bool {
+    return !absorbed.empty() && (absorbed.find(id) != absorbed.end());
+}
+
+auto SimulationState::GetAbsorbed() const -> const unordered_map<string, string>& {
+    return absorbed;
+}
+
+auto SimulationState::SetAbsorbed(const unordered_map<string, string> &_absorbed) -> void {
+    absorbed = _absorbed;
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <simulation/Encke.h>
 #include <simulation/OrbitPoint.h>
 #include <util/Types.h>
 
@@ -7,13 +8,43 @@
 
 class SimulationState {
 private:
+    struct ClosePair {
+        const string* first;
+        const string* second;
+        OrbitPoint* firstPoint;
+        OrbitPoint* secondPoint;
+        double firstMass;
+        double secondMass;
+        dvec3 firstExternalAcceleration;
+        dvec3 secondExternalAcceleration;
+    };
+
     unordered_map<string, OrbitPoint> points;
     unordered_map<string, dvec3> oldAcceleration;
+    unordered_map<string, EnckeOrbit> enckeOrbits;
+
+    // A body that collided with a larger one keeps following it, so every state has the same bodies, but only the
+    // body it merged into takes part in the physics; masses and radii changed by merges are kept here rather than in
+    // Bodies, since the future is predicted before the bodies get there
+    unordered_map<string, string> absorbed;
+    unordered_map<string, double> masses;
+    unordered_map<string, double> radii;
+
+    // The massive body pulling hardest on each massive body, noted while its acceleration is calculated so close pairs
+    // can be found without another pass over every pair; only kept while close pairs are regularized
+    unordered_map<string, string> strongestPulls;
 
     double accelerationLastTimeStep;
+    double time;
 
     auto CalculateIndividualAcceleration(const string &accelerationOf, const string &withRespectTo) -> dvec3;
     auto StepOrbitPoint(const string &id, OrbitPoint &point, const double timeStep) -> void;
+    auto CalculatePerturbation(const string &id, const string &primaryId, const double mu, const dvec3 &acceleration, const dvec3 &primaryAcceleration) -> dvec3;
+    auto StepEncke(const string &id, OrbitPoint &point, const double mu, const dvec3 &primaryAcceleration, const double timeStep) -> void;
+    auto FindClosePairs(const double timeStep, vector<bool> &integrated) -> vector<ClosePair>;
+    auto StepClosePair(const ClosePair &pair, const double timeStep) -> void;
+    auto MergeCollisions(const vector<dvec3> &startPositions) -> void;
+    auto MergeBodies(const string &survivorId, const string &absorbedId) -> void;
 
 public:
     SimulationState();
@@ -22,5 +53,17 @@ public:
     auto CalculateTotalAcceleration(const string &id) -> dvec3;
     auto StepToNextState(const double timeStep) -> void;
     auto Scale() -> void;
-    auto GetOrbitPoints() const -> unordered_map<string, OrbitPoint>;
+    auto GetOrbitPoints() const -> const unordered_map<string, OrbitPoint>&;
+    auto GetOldAcceleration(const string &id) const -> dvec3;
+    auto SetOrbitPoint(const string &id, const OrbitPoint &point, const dvec3 &acceleration) -> void;
+    auto GetTime() const -> double;
+    auto SetTime(const double _time) -> void;
+
+    auto GetMass(const string &id) const -> double;
+    auto GetRadius(const string &id) const -> double;
+    auto IsAbsorbed(const string &id) const -> bool;
+
+    // Maps each absorbed body to the body it merged into
+    auto GetAbsorbed() const -> const unordered_map<string, string>&;
+    auto SetAbsorbed(const unordered_map<string, string> &_absorbed) -> void;
 };
\ No newline at end of file
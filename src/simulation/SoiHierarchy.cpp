@@ -0,0 +1,173 @@
+#include "SoiHierarchy.h"
+
+#include <main/Bodies.h>
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+
+namespace {
+    const double SOI_EXPONENT = 2.0 / 5.0;
+
+    auto CompareMass(const std::pair<double, string> &a, const std::pair<double, string> &b) -> bool {
+        // Ties are broken by id so the hierarchy doesn't depend on the order the points were stored in
+        return (a.first > b.first) || ((a.first == b.first) && (a.second < b.second));
+    }
+
+    // The same order as CompareMass, for indices into parallel arrays
+    struct CompareIndexMass {
+        const vector<string>* ids;
+        const vector<double>* masses;
+
+        auto operator()(const unsigned int a, const unsigned int b) const -> bool {
+            return (masses->at(a) > masses->at(b)) || ((masses->at(a) == masses->at(b)) && (ids->at(a) < ids->at(b)));
+        }
+    };
+}
+
+auto SoiHierarchy::Descend(const dvec3 &position, const unsigned int limit) const -> int {
+    // Only nodes before limit are considered, which lets Build place each body among the ones more massive than it
+    if (nodes.empty() || (limit == 0)) {
+        return -1;
+    }
+    unsigned int current = 0;
+    bool descended = true;
+    while (descended) {
+        descended = false;
+        for (const unsigned int child : nodes.at(current).children) {
+            if (child >= limit) {
+                continue;
+            }
+            const dvec3 displacement = position - nodes.at(child).point.position;
+            if (glm::dot(displacement, displacement) < nodes.at(child).radius * nodes.at(child).radius) {
+                current = child;
+                descended = true;
+                break;
+            }
+        }
+    }
+    return int(current);
+}
+
+auto SoiHierarchy::Place(const unsigned int index) -> void {
+    // Places a body among the ones more massive than it
+    const int parent = Descend(nodes.at(index).point.position, index);
+    if (parent < 0) {
+        return;
+    }
+    Node &node = nodes.at(index);
+    const Node &parentNode = nodes.at(parent);
+    node.parent = parent;
+    node.depth = parentNode.depth + 1;
+    node.radiusRatio = std::pow(node.mass / parentNode.mass, SOI_EXPONENT);
+    node.radius = glm::length(node.point.position - parentNode.point.position) * node.radiusRatio;
+    nodes.at(parent).children.push_back(index);
+}
+
+auto SoiHierarchy::Build(const unordered_map<string, OrbitPoint> &points) -> void {
+    Build(points, {}, {});
+}
+
+auto SoiHierarchy::Build(const unordered_map<string, OrbitPoint> &points, const unordered_map<string, double> &masses, const unordered_map<string, string> &absorbed) -> void {
+    vector<std::pair<double, string>> massive;
+    for (const auto &pair : Bodies::GetMassiveBodies()) {
+        if ((points.find(pair.first) == points.end()) || (absorbed.find(pair.first) != absorbed.end())) {
+            continue;
+        }
+        const auto mass = masses.find(pair.first);
+        massive.emplace_back((mass != masses.end()) ? mass->second : pair.second.GetMass(), pair.first);
+    }
+    std::sort(massive.begin(), massive.end(), CompareMass);
+
+    nodes.clear();
+    indices.clear();
+    for (unsigned int i = 0; i < massive.size(); i++) {
+        const string &id = massive.at(i).second;
+        nodes.push_back(Node{id, points.at(id), massive.at(i).first, -1, 0, std::numeric_limits<double>::infinity(), 0, {}});
+        indices[id] = i;
+        Place(i);
+    }
+}
+
+auto SoiHierarchy::Build(const vector<string> &ids, const vector<OrbitPoint> &points, const vector<double> &masses) -> void {
+    // The order only changes when the masses do, in which case the ids and their index are redone too
+    if ((order.size() != ids.size()) || (masses != orderMasses)) {
+        order.resize(ids.size());
+        for (unsigned int i = 0; i < order.size(); i++) {
+            order.at(i) = i;
+        }
+        std::sort(order.begin(), order.end(), CompareIndexMass{&ids, &masses});
+        orderMasses = masses;
+    }
+
+    bool sameOrder = nodes.size() == ids.size();
+    for (unsigned int i = 0; sameOrder && (i < nodes.size()); i++) {
+        sameOrder = nodes.at(i).id == ids.at(order.at(i));
+    }
+
+    nodes.resize(ids.size());
+    for (unsigned int i = 0; i < nodes.size(); i++) {
+        Node &node = nodes.at(i);
+        if (!sameOrder) {
+            node.id = ids.at(order.at(i));
+        }
+        node.point = points.at(order.at(i));
+        node.mass = masses.at(order.at(i));
+        node.parent = -1;
+        node.depth = 0;
+        node.radius = std::numeric_limits<double>::infinity();
+        node.radiusRatio = 0;
+        node.children.clear();
+        Place(i);
+    }
+
+    if (!sameOrder) {
+        indices.clear();
+        for (unsigned int i = 0; i < nodes.size(); i++) {
+            indices[nodes.at(i).id] = i;
+        }
+    }
+}
+
+auto SoiHierarchy::Move(const vector<OrbitPoint> &points) -> void {
+    for (unsigned int i = 0; i < nodes.size(); i++) {
+        nodes.at(i).point = points.at(order.at(i));
+    }
+    for (Node &node : nodes) {
+        if (node.parent >= 0) {
+            node.radius = glm::length(node.point.position - nodes.at(node.parent).point.position) * node.radiusRatio;
+        }
+    }
+}
+
+auto SoiHierarchy::FindParent(const string &id, const dvec3 &position) const -> int {
+    const auto index = indices.find(id);
+    if (index != indices.end()) {
+        return nodes.at(index->second).parent;
+    }
+    return Descend(position, nodes.size());
+}
+
+auto SoiHierarchy::GetId(const unsigned int index) const -> const string& {
+    return nodes.at(index).id;
+}
+
+auto SoiHierarchy::GetPoint(const unsigned int index) const -> const OrbitPoint& {
+    return nodes.at(index).point;
+}
+
+auto SoiHierarchy::GetMass(const unsigned int index) const -> double {
+    return nodes.at(index).mass;
+}
+
+auto SoiHierarchy::GetDepth(const unsigned int index) const -> unsigned int {
+    return nodes.at(index).depth;
+}
+
+auto SoiHierarchy::GetRadius(const unsigned int index) const -> double {
+    return nodes.at(index).radius;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <simulation/OrbitPoint.h>
+#include <util/Types.h>
+
+
+
+// Nests the massive bodies by their Laplace spheres of influence, radius a * (m / M)^(2/5) where a is the distance
+// to the parent, so every body has a parent: the body with the smallest sphere of influence that contains it
+// The most massive body is the root, and its sphere of influence is unbounded
+class SoiHierarchy {
+private:
+    struct Node {
+        string id;
+        OrbitPoint point;
+        double mass;
+        int parent;
+        unsigned int depth;
+        double radius;
+        double radiusRatio; // (m / M)^(2/5), so the radius can be updated without the power
+        vector<unsigned int> children;
+    };
+
+    // Sorted by mass, most massive first, so every parent comes before its children
+    vector<Node> nodes;
+    unordered_map<string, unsigned int> indices;
+    vector<unsigned int> order;
+    vector<double> orderMasses;
+
+    auto Descend(const dvec3 &position, const unsigned int limit) const -> int;
+    auto Place(const unsigned int index) -> void;
+
+public:
+    // Only the massive bodies in points are used
+    auto Build(const unordered_map<string, OrbitPoint> &points) -> void;
+
+    // For a state whose bodies have merged: masses replace those of the same bodies, and absorbed bodies are left out
+    auto Build(const unordered_map<string, OrbitPoint> &points, const unordered_map<string, double> &masses, const unordered_map<string, string> &absorbed) -> void;
+
+    // Ids, points and masses are parallel arrays of massive bodies; the storage from the last build is reused, so a
+    // caller rebuilding every step with the same bodies doesn't allocate
+    auto Build(const vector<string> &ids, const vector<OrbitPoint> &points, const vector<double> &masses) -> void;
+
+    // Moves the bodies of the last Build from parallel arrays, keeping every body's parent, so only the radii change
+    // Parents only change when one massive body moves into another's sphere of influence, so a caller stepping
+    // through many short steps can Build now and then and Move in between
+    auto Move(const vector<OrbitPoint> &points) -> void;
+
+    // Returns the index of the body's parent, or -1 for the root and for any body when there are no massive bodies
+    auto FindParent(const string &id, const dvec3 &position) const -> int;
+
+    auto GetId(const unsigned int index) const -> const string&;
+    auto GetPoint(const unsigned int index) const -> const OrbitPoint&;
+    auto GetMass(const unsigned int index) const -> double;
+    auto GetDepth(const unsigned int index) const -> unsigned int;
+    auto GetRadius(const unsigned int index) const -> double;
+};
@@ -0,0 +1,229 @@
+#include "Trajectory.h"
+
+#include <simulation/Hermite.h>
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+
+
+
+namespace Trajectory {
+    namespace {
+        // Each block starts with a copy of the last state of the previous block, so any time inside the window
+        // is bracketed by two states in the same block
+        struct Block {
+            vector<double> times;
+            vector<OrbitPoint> points; // [state * bodyCount + body]
+        };
+
+        const unsigned int STATES_PER_BLOCK = 256;
+        const uint64_t MAX_SIZE = uint64_t(256) * 1024 * 1024;
+
+        std::mutex mutex;
+
+        vector<string> ids;
+        unordered_map<string, unsigned int> indices;
+        std::deque<Block> blocks;
+        double currentTime = 0;
+
+        // Set once a state had to be refused, since accepting any later ones would leave a gap in the window
+        bool full = false;
+
+        auto GetBlockSize() -> uint64_t {
+            return STATES_PER_BLOCK * (sizeof(double) + (ids.size() * sizeof(OrbitPoint)));
+        }
+
+        auto MakeRoom() -> bool {
+            // Only states that are already in the past can be given up
+            while ((blocks.size() + 1) * GetBlockSize() > MAX_SIZE) {
+                if ((blocks.size() < 2) || (blocks.at(1).times.front() > currentTime)) {
+                    return false;
+                }
+                blocks.pop_front();
+            }
+            return true;
+        }
+
+        auto Add(const double time, const OrbitPoint* points) -> bool {
+            if (full || ids.empty()) {
+                return false;
+            }
+
+            if (blocks.empty() || (blocks.back().times.size() == STATES_PER_BLOCK)) {
+                if (!MakeRoom()) {
+                    full = true;
+                    return false;
+                }
+
+                Block block;
+                block.times.reserve(STATES_PER_BLOCK);
+                block.points.reserve(STATES_PER_BLOCK * ids.size());
+                if (!blocks.empty()) {
+                    const Block &previous = blocks.back();
+                    block.times.push_back(previous.times.back());
+                    block.points.insert(block.points.end(), previous.points.end() - long(ids.size()), previous.points.end());
+                }
+                blocks.push_back(std::move(block));
+            }
+
+            Block &block = blocks.back();
+            block.times.push_back(time);
+            block.points.insert(block.points.end(), points, points + ids.size()); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            return true;
+        }
+
+        auto FindBlock(const double time) -> const Block* {
+            // Binary search for the last block starting at or before time
+            if (blocks.empty() || (time < blocks.front().times.front()) || (time > blocks.back().times.back())) {
+                return nullptr;
+            }
+            const auto block = std::upper_bound(blocks.begin(), blocks.end(), time,
+                [](const double time, const Block &block) { return time < block.times.front(); });
+            return &*std::prev(block);
+        }
+
+        auto FindState(const Block &block, const double time) -> unsigned int {
+            // Index of the state at the start of the interval containing time
+            const auto state = std::upper_bound(block.times.begin(), block.times.end(), time);
+            const unsigned int index = std::max(1, int(state - block.times.begin())) - 1;
+            return std::min(index, unsigned(block.times.size()) - 2);
+        }
+
+        auto Interpolate(const Block &block, const unsigned int state, const unsigned int body, const double time) -> OrbitPoint {
+            const OrbitPoint &start = block.points.at((state * ids.size()) + body);
+            if (block.times.size() == 1) {
+                return start;
+            }
+            const OrbitPoint &end = block.points.at(((state + 1) * ids.size()) + body);
+            const double interval = block.times.at(state + 1) - block.times.at(state);
+            return Hermite::Interpolate(start, end, interval, (time - block.times.at(state)) / interval);
+        }
+    }
+
+    auto NewBodyReset(const SimulationState &initialState) -> void {
+        std::lock_guard<std::mutex> lock(mutex);
+        ids.clear();
+        for (const auto &pair : initialState.GetOrbitPoints()) {
+            ids.push_back(pair.first);
+        }
+        std::sort(ids.begin(), ids.end());
+
+        indices.clear();
+        for (unsigned int i = 0; i < ids.size(); i++) {
+            indices[ids.at(i)] = i;
+        }
+
+        blocks.clear();
+        currentTime = initialState.GetTime();
+        full = false;
+    }
+
+    auto AddState(const SimulationState &state) -> bool {
+        ZoneScoped;
+        const unordered_map<string, OrbitPoint> &statePoints = state.GetOrbitPoints();
+        vector<OrbitPoint> points;
+        points.reserve(ids.size());
+        for (const string &id : ids) {
+            points.push_back(statePoints.at(id));
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        return Add(state.GetTime(), points.data());
+    }
+
+    auto AddState(const double time, const vector<OrbitPoint> &points) -> bool {
+        std::lock_guard<std::mutex> lock(mutex);
+        return Add(time, points.data());
+    }
+
+    auto StepToTime(const double time) -> void {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentTime = time;
+    }
+
+    auto GetIds() -> vector<string> {
+        std::lock_guard<std::mutex> lock(mutex);
+        return ids;
+    }
+
+    auto GetStartTime() -> double {
+        std::lock_guard<std::mutex> lock(mutex);
+        return blocks.empty() ? 0 : blocks.front().times.front();
+    }
+
+    auto GetEndTime() -> double {
+        std::lock_guard<std::mutex> lock(mutex);
+        return blocks.empty() ? 0 : blocks.back().times.back();
+    }
+
+    auto GetStates(const double startTime, vector<double> &times, vector<OrbitPoint> &points) -> void {
+        std::lock_guard<std::mutex> lock(mutex);
+        times.clear();
+        points.clear();
+        for (const Block &block : blocks) {
+            // The first state of every block but the first duplicates the previous block's last state
+            const unsigned int first = (&block == &blocks.front()) ? 0 : 1;
+            for (unsigned int state = first; state < block.times.size(); state++) {
+                if (block.times.at(state) >= startTime) {
+                    times.push_back(block.times.at(state));
+                    points.insert(points.end(), block.points.begin() + long(state * ids.size()), block.points.begin() + long((state + 1) * ids.size()));
+                }
+            }
+        }
+    }
+
+    auto SetBodyStates(const string &id, const vector<double> &times, const vector<OrbitPoint> &points) -> void {
+        ZoneScoped;
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto index = indices.find(id);
+        if ((index == indices.end()) || times.empty()) {
+            return;
+        }
+
+        // Block boundaries are duplicated, so both copies of a boundary state are overwritten
+        for (Block &block : blocks) {
+            if ((block.times.back() < times.front()) || (block.times.front() > times.back())) {
+                continue;
+            }
+            for (unsigned int state = 0; state < block.times.size(); state++) {
+                const auto match = std::lower_bound(times.begin(), times.end(), block.times.at(state));
+                if ((match != times.end()) && (*match == block.times.at(state))) {
+                    block.points.at((state * ids.size()) + index->second) = points.at(match - times.begin());
+                }
+            }
+        }
+    }
+
+    auto Query(const string &id, const double time, OrbitPoint &point) -> bool {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto index = indices.find(id);
+        const Block* block = FindBlock(time);
+        if ((index == indices.end()) || (block == nullptr)) {
+            return false;
+        }
+        point = Interpolate(*block, FindState(*block, time), index->second, time);
+        return true;
+    }
+
+    auto Query(const vector<string> &queryIds, const double time, vector<OrbitPoint> &points) -> bool {
+        // The bracketing states are found once and shared by every body
+        ZoneScoped;
+        std::lock_guard<std::mutex> lock(mutex);
+        const Block* block = FindBlock(time);
+        if (block == nullptr) {
+            return false;
+        }
+
+        const unsigned int state = FindState(*block, time);
+        points.clear();
+        for (const string &id : queryIds) {
+            const auto index = indices.find(id);
+            if (index == indices.end()) {
+                return false;
+            }
+            points.push_back(Interpolate(*block, state, index->second, time));
+        }
+        return true;
+    }
+}
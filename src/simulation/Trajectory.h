@@ -0,0 +1,36 @@
+#pragma once
+
+#include <simulation/OrbitPoint.h>
+#include <simulation/SimulationState.h>
+#include <util/Types.h>
+
+
+
+// Stores the predicted (and recently passed) states of every body, so the position and velocity of any body can be
+// looked up at any time inside the stored window instead of re-integrating
+// Queries are safe to make from any thread
+namespace Trajectory {
+    auto NewBodyReset(const SimulationState &initialState) -> void;
+
+    // States must be added in time order; returns false once the memory budget is used up
+    auto AddState(const SimulationState &state) -> bool;
+    auto AddState(const double time, const vector<OrbitPoint> &points) -> bool;
+
+    // States before time may be discarded to make room for new ones
+    auto StepToTime(const double time) -> void;
+
+    // Bodies are ordered by id
+    auto GetIds() -> vector<string>;
+    auto GetStartTime() -> double;
+    auto GetEndTime() -> double;
+
+    // Stored states from startTime onwards, in the same layout as AddState
+    auto GetStates(const double startTime, vector<double> &times, vector<OrbitPoint> &points) -> void;
+
+    // Overwrites one body's point in every stored state whose time is in times; points has one entry per time
+    auto SetBodyStates(const string &id, const vector<double> &times, const vector<OrbitPoint> &points) -> void;
+
+    // Return false if the time is outside the stored window, or (for single queries) the body is unknown
+    auto Query(const string &id, const double time, OrbitPoint &point) -> bool;
+    auto Query(const vector<string> &ids, const double time, vector<OrbitPoint> &points) -> bool;
+}
@@ -0,0 +1,411 @@
+#include "Sweep.h"
+
+#include <scenarios/Scenarios.h>
+#include <scenarios/ScenarioFileUtil.h>
+#include <scenarios/YMLUtil.h>
+#include <simulation/OrbitalElements.h>
+#include <simulation/Propagator.h>
+#include <simulation/Regularization.h>
+#include <util/Constants.h>
+#include <util/Hash.h>
+#include <util/Parallel.h>
+
+#include <yaml-cpp/yaml.h>
+#include <glm/geometric.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
+
+
+
+namespace Sweep {
+    namespace {
+        // Bump this whenever the propagation or the metrics change, so results cached by older versions are not reused
+        const uint64_t CACHE_VERSION = 2;
+        const string CACHE_DIRECTORY = "../sweeps/cache/";
+        const string CACHE_SUFFIX = ".yml";
+
+        const string TIME_STEP_PROPERTY = "time_step";
+        const double DEFAULT_TIME_STEP = 10000;
+        const double RADIANS_TO_DEGREES = 180.0 / M_PI;
+
+        const unordered_map<string, ScenarioArray> BODY_PROPERTIES = {
+            {"mass", SCENARIO_ARRAY_MASS},
+            {"radius", SCENARIO_ARRAY_RADIUS},
+            {"position_x", SCENARIO_ARRAY_POSITION_X},
+            {"position_y", SCENARIO_ARRAY_POSITION_Y},
+            {"position_z", SCENARIO_ARRAY_POSITION_Z},
+            {"velocity_x", SCENARIO_ARRAY_VELOCITY_X},
+            {"velocity_y", SCENARIO_ARRAY_VELOCITY_Y},
+            {"velocity_z", SCENARIO_ARRAY_VELOCITY_Z}
+        };
+
+        const vector<string> METRIC_NAMES = {
+            "closest_approach", "closest_approach_time", "semi_major_axis", "eccentricity", "inclination", "energy_drift"
+        };
+
+        struct Parameter {
+            string body;     // empty for the time step
+            string property;
+            vector<double> values;
+        };
+
+        struct Definition {
+            string scenarioPath;
+            double duration;
+            double timeStep;
+            string target;
+            string reference;
+            string output;
+            vector<Parameter> parameters;
+        };
+
+        struct Metrics {
+            double closestApproach;     // m, between target and reference
+            double closestApproachTime; // s, simulation time
+            double semiMajorAxis;       // m, final osculating elements of target around reference
+            double eccentricity;
+            double inclination;         // degrees
+            double energyDrift;         // |E_end - E_start| / |E_start|
+        };
+
+        std::mutex logMutex;
+
+        auto SafeLog(const Level level, const string &message) -> void {
+            std::lock_guard<std::mutex> lock(logMutex);
+            Log(level, message);
+        }
+
+        auto ReadValues(const YAML::Node &node, YMLUtil::ErrorCode &error) -> vector<double> {
+            // Either an explicit list (values: [...]) or an evenly spaced range (from, to, count)
+            if (node["values"]) {
+                return node["values"].as<vector<double>>();
+            }
+
+            const double from = YMLUtil::GetDouble(node, "from", error);
+            const double to = YMLUtil::GetDouble(node, "to", error);
+            const int count = YMLUtil::GetInt(node, "count", error);
+            vector<double> values;
+            for (int i = 0; i < count; i++) {
+                values.push_back((count == 1) ? from : from + ((to - from) * i / (count - 1)));
+            }
+            return values;
+        }
+
+        auto ValidateDefinition(const Definition &definition) -> bool {
+            // A step that doesn't move time forwards would never reach the end of the run
+            // The comparisons are negated so NaN is rejected too
+            if (!(definition.duration >= 0)) {
+                Log(ERROR, "Sweep duration must not be negative");
+                return false;
+            }
+            if (!(definition.timeStep > 0)) {
+                Log(ERROR, "Sweep time step must be positive");
+                return false;
+            }
+
+            for (const Parameter &parameter : definition.parameters) {
+                const string name = (parameter.body.empty() ? "" : parameter.body + ".") + parameter.property;
+                if (parameter.values.empty()) {
+                    Log(ERROR, "Sweep parameter " + name + " has no values; give a non-empty values list or a positive count");
+                    return false;
+                }
+                if (parameter.property != TIME_STEP_PROPERTY) {
+                    continue;
+                }
+                for (const double value : parameter.values) {
+                    if (!(value > 0)) {
+                        Log(ERROR, "Sweep parameter " + name + " has a time step that is not positive");
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        auto ReadDefinition(const string &path, Definition &definition) -> bool {
+            YAML::Node node;
+            try {
+                node = YAML::LoadFile(path);
+            } catch (const YAML::Exception &exception) {
+                Log(ERROR, "Failed to read sweep file " + path + ": " + exception.what());
+                return false;
+            }
+
+            YMLUtil::ErrorCode error = YMLUtil::NONE;
+            definition.scenarioPath = ScenarioFileUtil::GetScenarioDirectory() + YMLUtil::GetString(node, "scenario", error);
+            definition.duration = YMLUtil::GetDouble(node, "duration", error);
+            definition.timeStep = node["time_step"] ? node["time_step"].as<double>() : DEFAULT_TIME_STEP;
+            definition.target = YMLUtil::GetString(node, "target", error);
+            definition.reference = YMLUtil::GetString(node, "reference", error);
+            definition.output = YMLUtil::GetString(node, "output", error);
+
+            for (const YAML::Node &parameterNode : node["parameters"]) {
+                Parameter parameter;
+                parameter.property = YMLUtil::GetString(parameterNode, "property", error);
+                if (parameter.property != TIME_STEP_PROPERTY) {
+                    parameter.body = YMLUtil::GetString(parameterNode, "body", error);
+                    if (BODY_PROPERTIES.count(parameter.property) == 0) {
+                        Log(ERROR, "Unknown sweep property " + parameter.property);
+                        return false;
+                    }
+                }
+                parameter.values = ReadValues(parameterNode, error);
+                definition.parameters.push_back(parameter);
+            }
+
+            if (error != YMLUtil::NONE) {
+                Log(ERROR, "Sweep file " + path + " is missing required keys");
+                return false;
+            }
+            return ValidateDefinition(definition);
+        }
+
+        auto FindBody(const ScenarioSnapshot &snapshot, const string &id) -> int {
+            for (unsigned int i = 0; i < snapshot.ids.size(); i++) {
+                if (snapshot.ids.at(i) == id) {
+                    return int(i);
+                }
+            }
+            return -1;
+        }
+
+        auto ValidateBodies(const Definition &definition, const ScenarioSnapshot &snapshot) -> bool {
+            vector<string> ids = {definition.target, definition.reference};
+            for (const Parameter &parameter : definition.parameters) {
+                if (!parameter.body.empty()) {
+                    ids.push_back(parameter.body);
+                }
+            }
+
+            for (const string &id : ids) {
+                if (FindBody(snapshot, id) == -1) {
+                    Log(ERROR, "Sweep refers to body " + id + ", which is not in the scenario");
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        auto GetPointValues(const Definition &definition, unsigned int point) -> vector<double> {
+            // Points enumerate the Cartesian product of every parameter's values, with the last parameter varying fastest
+            vector<double> values(definition.parameters.size());
+            for (int i = int(definition.parameters.size()) - 1; i >= 0; i--) {
+                const vector<double> &parameterValues = definition.parameters.at(i).values;
+                values.at(i) = parameterValues.at(point % parameterValues.size());
+                point /= parameterValues.size();
+            }
+            return values;
+        }
+
+        auto ApplyPoint(const Definition &definition, const vector<double> &values, ScenarioSnapshot &snapshot, double &timeStep) -> void {
+            timeStep = definition.timeStep;
+            for (unsigned int i = 0; i < definition.parameters.size(); i++) {
+                const Parameter &parameter = definition.parameters.at(i);
+                if (parameter.property == TIME_STEP_PROPERTY) {
+                    timeStep = values.at(i);
+                } else {
+                    snapshot.arrays.at(BODY_PROPERTIES.at(parameter.property)).at(FindBody(snapshot, parameter.body)) = values.at(i);
+                }
+            }
+        }
+
+        auto GetCacheKey(const Definition &definition, const ScenarioSnapshot &snapshot, const double timeStep) -> string {
+            // The key covers everything the result depends on, so editing the scenario invalidates it automatically
+            Hash hash;
+            hash.Add(CACHE_VERSION);
+            hash.Add(snapshot.time);
+            for (const string &id : snapshot.ids) {
+                hash.Add(id);
+            }
+            for (const vector<double> &array : snapshot.arrays) {
+                hash.Add(array);
+            }
+            hash.Add(definition.duration);
+            hash.Add(timeStep);
+            hash.Add(definition.target);
+            hash.Add(definition.reference);
+            hash.Add(uint64_t(Regularization::IsEnabled()));
+            hash.Add(Regularization::GetSoftening());
+            return hash.GetHex();
+        }
+
+        auto ReadCachedMetrics(const string &path, Metrics &metrics) -> bool {
+            if (!std::filesystem::exists(path)) {
+                return false;
+            }
+
+            try {
+                const YAML::Node node = YAML::LoadFile(path);
+                metrics.closestApproach = node["closest_approach"].as<double>();
+                metrics.closestApproachTime = node["closest_approach_time"].as<double>();
+                metrics.semiMajorAxis = node["semi_major_axis"].as<double>();
+                metrics.eccentricity = node["eccentricity"].as<double>();
+                metrics.inclination = node["inclination"].as<double>();
+                metrics.energyDrift = node["energy_drift"].as<double>();
+            } catch (const YAML::Exception &) {
+                // A damaged cache entry is simply recomputed
+                return false;
+            }
+            return true;
+        }
+
+        auto WriteCachedMetrics(const string &path, const Metrics &metrics) -> void {
+            YAML::Emitter emitter;
+            emitter.SetDoublePrecision(std::numeric_limits<double>::max_digits10);
+            emitter << YAML::BeginMap;
+            YMLUtil::SetDouble(emitter, "closest_approach", metrics.closestApproach);
+            YMLUtil::SetDouble(emitter, "closest_approach_time", metrics.closestApproachTime);
+            YMLUtil::SetDouble(emitter, "semi_major_axis", metrics.semiMajorAxis);
+            YMLUtil::SetDouble(emitter, "eccentricity", metrics.eccentricity);
+            YMLUtil::SetDouble(emitter, "inclination", metrics.inclination);
+            YMLUtil::SetDouble(emitter, "energy_drift", metrics.energyDrift);
+            emitter << YAML::EndMap;
+
+            // Written under a temporary name first, so an interrupted sweep never leaves a truncated entry behind
+            const string temporaryPath = ScenarioFileUtil::GetTemporaryPath(path);
+            if (ScenarioFileUtil::SaveFile(emitter, temporaryPath)) {
+                std::filesystem::rename(temporaryPath, path);
+            }
+        }
+
+        auto GetSurvivor(const Propagator &propagator, const unsigned int index) -> unsigned int {
+            const int absorbedInto = propagator.GetAbsorbedInto(index);
+            return (absorbedInto < 0) ? index : unsigned(absorbedInto);
+        }
+
+        auto Propagate(const Definition &definition, const ScenarioSnapshot &snapshot, const double timeStep) -> Metrics {
+            ZoneScoped;
+            Propagator propagator(snapshot);
+            const unsigned int target = propagator.GetIndex(definition.target);
+            const unsigned int reference = propagator.GetIndex(definition.reference);
+            const double initialEnergy = propagator.GetTotalEnergy();
+            const double endTime = snapshot.time + definition.duration;
+
+            Metrics metrics {};
+            metrics.closestApproach = glm::distance(propagator.GetPosition(target), propagator.GetPosition(reference));
+            metrics.closestApproachTime = propagator.GetTime();
+
+            while (propagator.GetTime() < endTime) {
+                // The last step is shortened so every point ends at exactly the same time, whatever its step size
+                propagator.Step(std::min(timeStep, endTime - propagator.GetTime()));
+
+                const double distance = glm::distance(propagator.GetPosition(target), propagator.GetPosition(reference));
+                if (distance < metrics.closestApproach) {
+                    metrics.closestApproach = distance;
+                    metrics.closestApproachTime = propagator.GetTime();
+                }
+            }
+
+            // Once the target and reference have merged there is no orbit left to describe
+            if (GetSurvivor(propagator, target) == GetSurvivor(propagator, reference)) {
+                metrics.semiMajorAxis = std::numeric_limits<double>::quiet_NaN();
+                metrics.eccentricity = std::numeric_limits<double>::quiet_NaN();
+                metrics.inclination = std::numeric_limits<double>::quiet_NaN();
+                metrics.energyDrift = std::abs(propagator.GetTotalEnergy() - initialEnergy) / std::abs(initialEnergy);
+                return metrics;
+            }
+
+            const double mu = GRAVITATIONAL_CONSTANT * (propagator.GetMass(target) + propagator.GetMass(reference));
+            const OrbitalElements elements = OrbitalElementsUtil::Calculate(
+                propagator.GetPosition(target) - propagator.GetPosition(reference),
+                propagator.GetVelocity(target) - propagator.GetVelocity(reference),
+                mu);
+            metrics.semiMajorAxis = elements.semiMajorAxis;
+            metrics.eccentricity = elements.eccentricity;
+            metrics.inclination = elements.inclination * RADIANS_TO_DEGREES;
+            metrics.energyDrift = std::abs(propagator.GetTotalEnergy() - initialEnergy) / std::abs(initialEnergy);
+            return metrics;
+        }
+
+        auto WriteResults(const Definition &definition, const vector<vector<double>> &points, const vector<Metrics> &results) -> bool {
+            std::ofstream file(definition.output);
+            file.precision(std::numeric_limits<double>::max_digits10);
+
+            for (const Parameter &parameter : definition.parameters) {
+                file << (parameter.body.empty() ? "" : parameter.body + ".") << parameter.property << ",";
+            }
+            for (unsigned int i = 0; i < METRIC_NAMES.size(); i++) {
+                file << METRIC_NAMES.at(i) << ((i + 1 < METRIC_NAMES.size()) ? "," : "\n");
+            }
+
+            for (unsigned int point = 0; point < points.size(); point++) {
+                for (const double value : points.at(point)) {
+                    file << value << ",";
+                }
+                const Metrics &metrics = results.at(point);
+                file << metrics.closestApproach << "," << metrics.closestApproachTime << "," << metrics.semiMajorAxis << ","
+                     << metrics.eccentricity << "," << metrics.inclination << "," << metrics.energyDrift << "\n";
+            }
+
+            file.close();
+            return bool(file);
+        }
+    }
+
+    auto Run(const string &path) -> int {
+        Definition definition;
+        if (!ReadDefinition(path, definition)) {
+            return 1;
+        }
+
+        ScenarioSnapshot scenario;
+        const YMLUtil::ErrorCode error = Scenarios::ReadScenario(definition.scenarioPath, ScenarioFileUtil::GetFormat(definition.scenarioPath), scenario);
+        if (error != YMLUtil::NONE) {
+            Log(ERROR, "Failed to read scenario " + definition.scenarioPath);
+            return 1;
+        }
+
+        if (!ValidateBodies(definition, scenario)) {
+            return 1;
+        }
+
+        unsigned int pointCount = 1;
+        for (const Parameter &parameter : definition.parameters) {
+            pointCount *= parameter.values.size();
+        }
+
+        vector<vector<double>> points;
+        for (unsigned int point = 0; point < pointCount; point++) {
+            points.push_back(GetPointValues(definition, point));
+        }
+
+        std::filesystem::create_directories(CACHE_DIRECTORY);
+        Log(INFO, "Running " + std::to_string(pointCount) + " sweep points on " + std::to_string(Parallel::GetThreadCount()) + " threads");
+
+        // Points can take very different amounts of time (cache hits, different step sizes), so rather than splitting
+        // them into fixed ranges, each thread keeps taking the next point until there are none left
+        vector<Metrics> results(pointCount);
+        std::atomic<unsigned int> nextPoint = 0;
+        std::atomic<unsigned int> cachedPoints = 0;
+        Parallel::For(Parallel::GetThreadCount(), [&](const unsigned int, const unsigned int) {
+            for (unsigned int point = nextPoint++; point < pointCount; point = nextPoint++) {
+                ScenarioSnapshot snapshot = scenario;
+                double timeStep = 0;
+                ApplyPoint(definition, points.at(point), snapshot, timeStep);
+
+                const string cachePath = CACHE_DIRECTORY + GetCacheKey(definition, snapshot, timeStep) + CACHE_SUFFIX;
+                if (ReadCachedMetrics(cachePath, results.at(point))) {
+                    cachedPoints++;
+                    continue;
+                }
+
+                results.at(point) = Propagate(definition, snapshot, timeStep);
+                WriteCachedMetrics(cachePath, results.at(point));
+                SafeLog(INFO, "Finished sweep point " + std::to_string(point + 1) + "/" + std::to_string(pointCount));
+            }
+        });
+
+        if (!WriteResults(definition, points, results)) {
+            Log(ERROR, "Failed to write sweep results to " + definition.output);
+            return 1;
+        }
+
+        Log(SUCCESS, "Sweep complete (" + std::to_string(cachedPoints) + " of " + std::to_string(pointCount) + " points were cached); results written to " + definition.output);
+        return 0;
+    }
+}
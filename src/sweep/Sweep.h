@@ -0,0 +1,11 @@
+#pragma once
+
+#include <util/Types.h>
+
+
+
+namespace Sweep {
+    // Runs every point of the parameter grid described by the sweep file at path, without opening a window
+    // Returns the process exit code
+    auto Run(const string &path) -> int;
+}
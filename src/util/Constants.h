@@ -6,7 +6,8 @@
 
 const float FLOATING_POINT_ADJUSTMENT = 0.00001;
 const float PI = 3.14159265359;
-const float GRAVITATIONAL_CONSTANT = 6.6743 * pow(10, -11);
+const double GRAVITATIONAL_CONSTANT = 6.6743e-11;
+const double MASS_THRESHOLD = 100000; // Bodies above this mass (in kg) are Massive; everything else is Massless
 const vec3 VERTICAL = vec3(0.0f, 1.0f, 0.0f);
 const double SCALE_FACTOR(10e11);
 const float SPHERE_STEP = PI / 24;
@@ -0,0 +1,51 @@
+#include "Hash.h"
+
+#include <iomanip>
+#include <sstream>
+
+
+
+namespace {
+    const uint64_t OFFSET_BASIS = 14695981039346656037ULL;
+    const uint64_t PRIME = 1099511628211ULL;
+}
+
+Hash::Hash()
+    : value(OFFSET_BASIS) {}
+
+auto Hash::Add(const void* data, const uint64_t size) -> void {
+    const auto* bytes = (const uint8_t*)data; // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+    for (uint64_t i = 0; i < size; i++) {
+        value ^= bytes[i]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        value *= PRIME;
+    }
+}
+
+auto Hash::Add(const string &data) -> void {
+    // Include the length so that eg. ("ab", "c") and ("a", "bc") hash differently
+    Add(uint64_t(data.size()));
+    Add(data.data(), data.size());
+}
+
+auto Hash::Add(const double data) -> void {
+    Add(&data, sizeof(double));
+}
+
+auto Hash::Add(const uint64_t data) -> void {
+    Add(&data, sizeof(uint64_t));
+}
+
+auto Hash::Add(const vector<double> &data) -> void {
+    Add(uint64_t(data.size()));
+    Add(data.data(), data.size() * sizeof(double));
+}
+
+auto Hash::GetValue() const -> uint64_t {
+    return value;
+}
+
+auto Hash::GetHex() const -> string {
+    std::stringstream stream;
+    stream << std::hex << std::setw(16) << std::setfill('0') << value;
+    return stream.str();
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <util/Types.h>
+
+#include <cstdint>
+
+
+
+// Incremental 64-bit FNV-1a hash, used to key on-disk caches by the content that produced them
+class Hash {
+private:
+    uint64_t value;
+
+public:
+    Hash();
+
+    auto Add(const void* data, const uint64_t size) -> void;
+    auto Add(const string &data) -> void;
+    auto Add(const double data) -> void;
+    auto Add(const uint64_t data) -> void;
+    auto Add(const vector<double> &data) -> void;
+
+    auto GetValue() const -> uint64_t;
+    auto GetHex() const -> string;
+};
@@ -0,0 +1,39 @@
+#include "Parallel.h"
+
+#include <algorithm>
+
+
+
+namespace Parallel {
+    namespace {
+        const unsigned int FALLBACK_THREAD_COUNT = 4;
+    }
+
+    auto GetThreadCount() -> unsigned int {
+        // hardware_concurrency is allowed to return 0 if it can't work out the number of cores
+        const unsigned int threadCount = std::thread::hardware_concurrency();
+        return (threadCount == 0) ? FALLBACK_THREAD_COUNT : threadCount;
+    }
+
+    auto For(const unsigned int count, const std::function<void(unsigned int begin, unsigned int end)> &function) -> void {
+        // Split [0, count) into one contiguous range per thread
+        // The calling thread takes the first range so we only spawn threadCount-1 new threads
+        const unsigned int threadCount = std::min(GetThreadCount(), count);
+        if (threadCount <= 1) {
+            function(0, count);
+            return;
+        }
+
+        const unsigned int rangeSize = (count + threadCount - 1) / threadCount;
+        vector<thread> threads;
+        for (unsigned int begin = rangeSize; begin < count; begin += rangeSize) {
+            threads.emplace_back(function, begin, std::min(begin + rangeSize, count));
+        }
+
+        function(0, std::min(rangeSize, count));
+
+        for (thread &worker : threads) {
+            worker.join();
+        }
+    }
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <util/Types.h>
+
+#include <functional>
+
+
+
+namespace Parallel {
+    auto GetThreadCount() -> unsigned int;
+    auto For(const unsigned int count, const std::function<void(unsigned int begin, unsigned int end)> &function) -> void;
+}